@@ -0,0 +1,32 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_BENCHMARKS_CSV_READER_COMPILE_TIME_H
+#define MDT_PLAIN_TEXT_BENCHMARKS_CSV_READER_COMPILE_TIME_H
+
+#include <string>
+#include <cstddef>
+
+/*
+ * Each function is implemented in its own translation unit,
+ * which is the one whose compile time is measured.
+ * They return the count of records read from the file at filePath.
+ */
+
+/*
+ * Uses the reader and the grammars instantiated in the library
+ */
+std::size_t readCsvFileInstantiatedQi(const std::string & filePath);
+std::size_t readCsvFileInstantiatedX3(const std::string & filePath);
+
+/*
+ * Uses a record type that is not instantiated in the library,
+ * so the reader and the grammars are compiled here
+ */
+std::size_t readCsvFileNotInstantiatedQi(const std::string & filePath);
+std::size_t readCsvFileNotInstantiatedX3(const std::string & filePath);
+
+#endif // #ifndef MDT_PLAIN_TEXT_BENCHMARKS_CSV_READER_COMPILE_TIME_H
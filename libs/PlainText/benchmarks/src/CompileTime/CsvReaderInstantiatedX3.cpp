@@ -0,0 +1,30 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "CsvReaderCompileTime.h"
+#include "Mdt/PlainText/CsvFileReaderTemplate.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvRecord.h"
+#include <string>
+#include <vector>
+
+using namespace Mdt::PlainText;
+
+std::size_t readCsvFileInstantiatedX3(const std::string & filePath)
+{
+  using Record = std::vector<std::string>;
+  using Table = std::vector<Record>;
+
+  CsvFileReaderTemplate reader;
+  reader.setFilePath(filePath);
+  reader.open();
+  if( reader.atEnd() ){
+    return 0;
+  }
+
+  const Grammar::Csv::X3::CsvRecord<Record> rule( reader.csvSettings() );
+
+  return reader.readAllRecords<Table>(rule).size();
+}
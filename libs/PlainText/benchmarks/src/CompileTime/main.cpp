@@ -0,0 +1,29 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "CsvReaderCompileTime.h"
+#include <iostream>
+
+/*
+ * What is measured is the build of this executable.
+ *
+ * Running it with the path to a CSV file
+ * checks that all variants read the same count of records.
+ */
+int main(int argc, char **argv)
+{
+  if(argc < 2){
+    return 0;
+  }
+  const std::string filePath = argv[1];
+
+  std::cout << "Qi, instantiated: " << readCsvFileInstantiatedQi(filePath) << " records\n";
+  std::cout << "X3, instantiated: " << readCsvFileInstantiatedX3(filePath) << " records\n";
+  std::cout << "Qi, not instantiated: " << readCsvFileNotInstantiatedQi(filePath) << " records\n";
+  std::cout << "X3, not instantiated: " << readCsvFileNotInstantiatedX3(filePath) << " records\n";
+
+  return 0;
+}
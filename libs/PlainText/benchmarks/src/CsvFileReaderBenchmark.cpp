@@ -0,0 +1,234 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/CsvFileReader.h"
+#include "Mdt/PlainText/CsvFileReaderTemplate.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvRecord.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/HybridCsvRecord.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Mdt::PlainText;
+
+using StringRecord = std::vector<std::string>;
+using StringTable = std::vector<StringRecord>;
+using X3CsvRecord = Grammar::Csv::X3::CsvRecord<StringRecord>;
+using X3HybridCsvRecord = Grammar::Csv::X3::HybridCsvRecord<StringRecord>;
+
+/*
+ * Write a CSV file of recordCount records,
+ * each record beeing made of columnCount fields.
+ * One field over protectedFieldRatio contains a separator,
+ * so it is protected.
+ * A protectedFieldRatio of 0 gives a file without any protected field.
+ */
+void writeCsvFile(const std::string & filePath, int recordCount, int columnCount, int protectedFieldRatio)
+{
+  std::ofstream file(filePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+  for(int row = 0; row < recordCount; ++row){
+    for(int col = 0; col < columnCount; ++col){
+      const int n = row * columnCount + col;
+      if(col > 0){
+        file << ',';
+      }
+      if( (protectedFieldRatio > 0) && ( (n % protectedFieldRatio) == 0 ) ){
+        file << "\"Field " << n << ", protected\"";
+      }else{
+        file << "Field " << n;
+      }
+    }
+    file << '\n';
+  }
+}
+
+/*
+ * Write a CSV file of recordCount records,
+ * each record beeing made of columnCount fields,
+ * of which the last one is protected
+ */
+void writeCsvFileWithLastColumnProtected(const std::string & filePath, int recordCount, int columnCount)
+{
+  std::ofstream file(filePath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+  for(int row = 0; row < recordCount; ++row){
+    for(int col = 0; col < columnCount - 1; ++col){
+      file << "Field " << (row * columnCount + col) << ',';
+    }
+    file << "\"Field " << (row * columnCount + columnCount - 1) << ", protected\"\n";
+  }
+}
+
+std::size_t readAll(const std::string & filePath, const CsvParserSettings & csvSettings = CsvParserSettings())
+{
+  CsvFileReader reader;
+
+  reader.setCsvSettings(csvSettings);
+  reader.setFilePath(filePath);
+  reader.open();
+  const auto table = reader.readAll();
+  reader.close();
+
+  return table.size();
+}
+
+/*
+ * Read all records through the multi pass source of CsvFileReaderTemplate,
+ * which is the one used by CsvFileReader, with a given record rule
+ */
+template<typename Rule>
+std::size_t readAllRecords(const std::string & filePath)
+{
+  CsvFileReaderTemplate reader;
+
+  reader.setFilePath(filePath);
+  reader.open();
+  const Rule rule( reader.csvSettings() );
+  const auto table = reader.readAllRecords<StringTable>(rule);
+  reader.close();
+
+  return table.size();
+}
+
+int64_t validate(const std::string & filePath)
+{
+  CsvFileReader reader;
+
+  reader.setFilePath(filePath);
+  reader.open();
+  const auto report = reader.validate();
+  reader.close();
+
+  return report.recordCount();
+}
+
+
+TEST_CASE("readAll")
+{
+  const std::string filePath = "CsvFileReaderBenchmark.csv";
+  writeCsvFile(filePath, 50000, 10, 10);
+
+  REQUIRE( readAll(filePath) == 50000 );
+
+  BENCHMARK("50000 records, 10 columns")
+  {
+    return readAll(filePath);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("readAll_validateUtf8")
+{
+  const std::string filePath = "CsvFileReaderBenchmark.csv";
+  writeCsvFile(filePath, 50000, 10, 10);
+
+  CsvParserSettings csvSettings;
+  csvSettings.setValidateUtf8(true);
+
+  REQUIRE( readAll(filePath, csvSettings) == 50000 );
+
+  BENCHMARK("Without validation, 50000 records, 10 columns")
+  {
+    return readAll(filePath);
+  };
+
+  BENCHMARK("With validation, 50000 records, 10 columns")
+  {
+    return readAll(filePath, csvSettings);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("readAllRecords_CsvRecord_vs_HybridCsvRecord")
+{
+  const std::string filePath = "CsvFileReaderBenchmark.csv";
+
+  SECTION("No protected field")
+  {
+    writeCsvFile(filePath, 50000, 10, 0);
+
+    REQUIRE( readAllRecords<X3CsvRecord>(filePath) == 50000 );
+    REQUIRE( readAllRecords<X3HybridCsvRecord>(filePath) == 50000 );
+
+    BENCHMARK("CsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3CsvRecord>(filePath);
+    };
+
+    BENCHMARK("HybridCsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3HybridCsvRecord>(filePath);
+    };
+  }
+
+  SECTION("1 record over 10 with a protected field")
+  {
+    writeCsvFile(filePath, 50000, 10, 100);
+
+    BENCHMARK("CsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3CsvRecord>(filePath);
+    };
+
+    BENCHMARK("HybridCsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3HybridCsvRecord>(filePath);
+    };
+  }
+
+  SECTION("Each record with a protected field in the first column")
+  {
+    writeCsvFile(filePath, 50000, 10, 10);
+
+    BENCHMARK("CsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3CsvRecord>(filePath);
+    };
+
+    BENCHMARK("HybridCsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3HybridCsvRecord>(filePath);
+    };
+  }
+
+  SECTION("Each record with a protected field in the last column")
+  {
+    writeCsvFileWithLastColumnProtected(filePath, 50000, 10);
+
+    BENCHMARK("CsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3CsvRecord>(filePath);
+    };
+
+    BENCHMARK("HybridCsvRecord, 50000 records, 10 columns")
+    {
+      return readAllRecords<X3HybridCsvRecord>(filePath);
+    };
+  }
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("validate")
+{
+  const std::string filePath = "CsvFileReaderBenchmark.csv";
+  writeCsvFile(filePath, 50000, 10, 10);
+
+  REQUIRE( validate(filePath) == 50000 );
+
+  BENCHMARK("50000 records, 10 columns")
+  {
+    return validate(filePath);
+  };
+
+  std::remove( filePath.c_str() );
+}
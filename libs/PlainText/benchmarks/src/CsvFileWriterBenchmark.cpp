@@ -0,0 +1,572 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/CsvFileWriter.h"
+#include "Mdt/PlainText/AsyncCsvFileWriter.h"
+#include "Mdt/PlainText/PartitionedCsvFileWriter.h"
+#include "Mdt/PlainText/RotatingCsvFileWriter.h"
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include "Mdt/PlainText/CsvValue.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Mdt::PlainText;
+
+using StringRecord = std::vector<std::string>;
+using StringTable = std::vector<StringRecord>;
+using ValueTable = std::vector<CsvValueRecord>;
+
+/*
+ * Build a table of recordCount records,
+ * each record beeing made of columnCount fields.
+ * One field over protectedFieldRatio contains a separator,
+ * so it must be protected.
+ */
+StringTable generateTable(int recordCount, int columnCount, int protectedFieldRatio)
+{
+  StringTable table;
+
+  for(int row = 0; row < recordCount; ++row){
+    StringRecord record;
+    for(int col = 0; col < columnCount; ++col){
+      const int n = row * columnCount + col;
+      if( (n % protectedFieldRatio) == 0 ){
+        record.push_back( "Field " + std::to_string(n) + ", protected" );
+      }else{
+        record.push_back( "Field " + std::to_string(n) );
+      }
+    }
+    table.push_back(record);
+  }
+
+  return table;
+}
+
+/*
+ * Write the table line by line,
+ * which is the typical usage of CsvFileWriter
+ */
+std::size_t writeLines(const StringTable & table, const std::string & filePath,
+                       const CsvGeneratorSettings & csvSettings = CsvGeneratorSettings())
+{
+  CsvFileWriter writer;
+
+  writer.setCsvSettings(csvSettings);
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.open();
+  for(const auto & record : table){
+    writer.writeLine(record);
+  }
+  writer.close();
+
+  return table.size();
+}
+/*
+ * Write the table by batches of batchSize records
+ */
+std::size_t writeBatches(const StringTable & table, const std::string & filePath, std::size_t batchSize)
+{
+  CsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.open();
+  for(std::size_t first = 0; first < table.size(); first += batchSize){
+    const std::size_t last = std::min(first + batchSize, table.size());
+    writer.writeLines( table.cbegin() + first, table.cbegin() + last );
+  }
+  writer.close();
+
+  return table.size();
+}
+
+/*
+ * Write the whole table at once,
+ * generated by threadCount threads
+ */
+std::size_t writeTable(const StringTable & table, const std::string & filePath, int threadCount)
+{
+  CsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.setThreadCount(threadCount);
+  writer.open();
+  writer.writeTable(table);
+  writer.close();
+
+  return table.size();
+}
+
+/*
+ * Each of the producerCount threads writes the whole table,
+ * serialized by a mutex around CsvFileWriter::writeLine()
+ */
+std::size_t writeFromProducersWithMutex(const StringTable & table, const std::string & filePath, int producerCount)
+{
+  CsvFileWriter writer;
+  std::mutex mutex;
+
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.open();
+
+  std::vector<std::thread> producers;
+  for(int i = 0; i < producerCount; ++i){
+    producers.emplace_back([&table, &writer, &mutex](){
+      for(const auto & record : table){
+        std::lock_guard<std::mutex> lock(mutex);
+        writer.writeLine(record);
+      }
+    });
+  }
+  for(auto & producer : producers){
+    producer.join();
+  }
+  writer.close();
+
+  return table.size() * static_cast<std::size_t>(producerCount);
+}
+
+/*
+ * Each of the producerCount threads writes the whole table
+ * to a AsyncCsvFileWriter
+ */
+std::size_t writeFromProducersAsync(const StringTable & table, const std::string & filePath, int producerCount)
+{
+  AsyncCsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.open();
+
+  std::vector<std::thread> producers;
+  for(int i = 0; i < producerCount; ++i){
+    producers.emplace_back([&table, &writer](){
+      for(const auto & record : table){
+        writer.writeLine(record);
+      }
+    });
+  }
+  for(auto & producer : producers){
+    producer.join();
+  }
+  writer.close();
+
+  return table.size() * static_cast<std::size_t>(producerCount);
+}
+
+/*
+ * Build a table of recordCount records,
+ * in runs of 10 records of the same partition,
+ * the first column beeing the key of one of the partitionCount partitions
+ */
+StringTable generatePartitionedTable(int recordCount, int columnCount, int partitionCount)
+{
+  StringTable table = generateTable(recordCount, columnCount, 10);
+
+  for(int row = 0; row < recordCount; ++row){
+    table[static_cast<std::size_t>(row)][0] = "Partition" + std::to_string( (row / 10) % partitionCount );
+  }
+
+  return table;
+}
+
+void removePartitionFiles(int partitionCount)
+{
+  for(int partition = 0; partition < partitionCount; ++partition){
+    const std::string filePath = "./Partition" + std::to_string(partition) + ".csv";
+    std::remove( filePath.c_str() );
+  }
+}
+
+/*
+ * Write each record by opening the file of its partition in append mode,
+ * which is what must be done without PartitionedCsvFileWriter
+ * to not exhaust file descriptors
+ */
+std::size_t writePartitionsByReopening(const StringTable & table)
+{
+  CsvFileWriter writer;
+
+  for(const auto & record : table){
+    writer.setFilePath("./" + record[0] + ".csv");
+    writer.open();
+    writer.writeLine(record);
+    writer.close();
+  }
+
+  return table.size();
+}
+
+std::size_t writePartitions(const StringTable & table, int maxOpenFileCount)
+{
+  PartitionedCsvFileWriter writer;
+
+  writer.setDirectoryPath(".");
+  writer.setKeyColumn(0);
+  writer.setMaxOpenFileCount(maxOpenFileCount);
+  writer.open();
+  writer.writeLines( table.cbegin(), table.cend() );
+  writer.close();
+
+  return table.size();
+}
+
+/*
+ * Write the table to files of at most maxFileSize bytes
+ *
+ * Returns the count of files
+ */
+int writeRotatingFiles(const StringTable & table, const std::string & filePath, int64_t maxFileSize)
+{
+  RotatingCsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  writer.setMaxFileSize(maxFileSize);
+  writer.setHeader(table.front());
+  writer.open();
+  writer.writeLines( table.cbegin(), table.cend() );
+  writer.close();
+
+  return writer.fileIndex();
+}
+
+std::size_t writeWithDurability(const StringTable & table, const std::string & filePath, const FileDurabilityPolicy & policy)
+{
+  CsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.setDurabilityPolicy(policy);
+  writer.open();
+  for(const auto & record : table){
+    writer.writeLine(record);
+  }
+  writer.close();
+
+  return table.size();
+}
+
+FileDurabilityPolicy groupCommitPolicy(int64_t recordCount)
+{
+  FileDurabilityPolicy policy;
+
+  policy.setDurability(FileDurability::GroupCommit);
+  policy.setGroupCommitRecordCount(recordCount);
+
+  return policy;
+}
+
+void removeRotatedFiles(const std::string & filePath, int fileCount)
+{
+  RotatingCsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  for(int index = 1; index <= fileCount; ++index){
+    std::remove( writer.rotatedFilePath(index).c_str() );
+  }
+}
+
+/*
+ * Build a table of recordCount records,
+ * each record beeing made of a integer and a real number
+ * for each of the columnPairCount column pairs
+ */
+ValueTable generateNumericTable(int recordCount, int columnPairCount)
+{
+  ValueTable table;
+
+  for(int row = 0; row < recordCount; ++row){
+    CsvValueRecord record;
+    for(int col = 0; col < columnPairCount; ++col){
+      const int n = row * columnPairCount + col;
+      record.emplace_back(n);
+      record.emplace_back(n / 7.0);
+    }
+    table.push_back(record);
+  }
+
+  return table;
+}
+
+/*
+ * Write the table line by line,
+ * converting each value to a string first,
+ * which is what a application has to do without writeTypedLine()
+ */
+std::size_t writeLinesConvertedToString(const ValueTable & table, const std::string & filePath)
+{
+  CsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.open();
+  for(const auto & record : table){
+    StringRecord stringRecord;
+    for(const auto & value : record){
+      if( value.type() == CsvValueType::Integer ){
+        stringRecord.push_back( std::to_string( value.toInteger() ) );
+      }else{
+        stringRecord.push_back( std::to_string( value.toReal() ) );
+      }
+    }
+    writer.writeLine(stringRecord);
+  }
+  writer.close();
+
+  return table.size();
+}
+
+std::size_t writeTypedLines(const ValueTable & table, const std::string & filePath)
+{
+  CsvFileWriter writer;
+
+  writer.setFilePath(filePath);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.open();
+  for(const auto & record : table){
+    writer.writeTypedLine(record);
+  }
+  writer.close();
+
+  return table.size();
+}
+
+
+TEST_CASE("writeLine")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(10000, 10, 10);
+
+  REQUIRE( writeLines(table, filePath) == 10000 );
+
+  BENCHMARK("10000 records, 10 columns")
+  {
+    return writeLines(table, filePath);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("writeLine_largeExport")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(200000, 10, 10);
+
+  REQUIRE( writeLines(table, filePath) == 200000 );
+
+  BENCHMARK("200000 records, 10 columns")
+  {
+    return writeLines(table, filePath);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("writeLine_vs_writeLines")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(200000, 10, 10);
+
+  REQUIRE( writeBatches(table, filePath, 1000) == 200000 );
+
+  BENCHMARK("writeLine, 200000 records, 10 columns")
+  {
+    return writeLines(table, filePath);
+  };
+
+  BENCHMARK("writeLines, batches of 1000, 200000 records, 10 columns")
+  {
+    return writeBatches(table, filePath, 1000);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("writeTable_parallel")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(200000, 10, 10);
+
+  REQUIRE( writeTable(table, filePath, 4) == 200000 );
+
+  BENCHMARK("1 thread, 200000 records, 10 columns")
+  {
+    return writeTable(table, filePath, 1);
+  };
+
+  BENCHMARK("2 threads, 200000 records, 10 columns")
+  {
+    return writeTable(table, filePath, 2);
+  };
+
+  BENCHMARK("4 threads, 200000 records, 10 columns")
+  {
+    return writeTable(table, filePath, 4);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("multipleProducers")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(50000, 10, 10);
+
+  REQUIRE( writeFromProducersAsync(table, filePath, 4) == 200000 );
+
+  BENCHMARK("CsvFileWriter and mutex, 4 producers, 50000 records, 10 columns")
+  {
+    return writeFromProducersWithMutex(table, filePath, 4);
+  };
+
+  BENCHMARK("AsyncCsvFileWriter, 4 producers, 50000 records, 10 columns")
+  {
+    return writeFromProducersAsync(table, filePath, 4);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("partitions")
+{
+  const int partitionCount = 200;
+  const StringTable table = generatePartitionedTable(20000, 10, partitionCount);
+
+  BENCHMARK("CsvFileWriter reopened for each record, 200 partitions, 20000 records, 10 columns")
+  {
+    return writePartitionsByReopening(table);
+  };
+  removePartitionFiles(partitionCount);
+
+  BENCHMARK("PartitionedCsvFileWriter, 64 open files, 200 partitions, 20000 records, 10 columns")
+  {
+    return writePartitions(table, 64);
+  };
+  removePartitionFiles(partitionCount);
+
+  BENCHMARK("PartitionedCsvFileWriter, 256 open files, 200 partitions, 20000 records, 10 columns")
+  {
+    return writePartitions(table, 256);
+  };
+  removePartitionFiles(partitionCount);
+}
+
+TEST_CASE("rotation")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(200000, 10, 10);
+
+  const int fileCount = writeRotatingFiles(table, filePath, 1024 * 1024);
+  REQUIRE( fileCount > 1 );
+
+  BENCHMARK("Single file, 200000 records, 10 columns")
+  {
+    return writeBatches(table, filePath, table.size());
+  };
+
+  BENCHMARK("Files of 1 MiB, 200000 records, 10 columns")
+  {
+    return writeRotatingFiles(table, filePath, 1024 * 1024);
+  };
+
+  std::remove( filePath.c_str() );
+  removeRotatedFiles(filePath, fileCount);
+}
+
+TEST_CASE("durability")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(200000, 10, 10);
+
+  FileDurabilityPolicy policy;
+
+  BENCHMARK("None, 200000 records, 10 columns")
+  {
+    policy.setDurability(FileDurability::None);
+    return writeWithDurability(table, filePath, policy);
+  };
+
+  BENCHMARK("SyncOnClose, 200000 records, 10 columns")
+  {
+    policy.setDurability(FileDurability::SyncOnClose);
+    return writeWithDurability(table, filePath, policy);
+  };
+
+  BENCHMARK("GroupCommit every 10000 records, 200000 records, 10 columns")
+  {
+    return writeWithDurability(table, filePath, groupCommitPolicy(10000));
+  };
+
+  BENCHMARK("GroupCommit every 100 records, 200000 records, 10 columns")
+  {
+    return writeWithDurability(table, filePath, groupCommitPolicy(100));
+  };
+
+  BENCHMARK("AtomicReplace, 200000 records, 10 columns")
+  {
+    policy.setDurability(FileDurability::AtomicReplace);
+    return writeWithDurability(table, filePath, policy);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("writeLine_QuotingPolicy")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const StringTable table = generateTable(200000, 10, 10);
+
+  CsvGeneratorSettings minimalSettings;
+  CsvGeneratorSettings alwaysSettings;
+  alwaysSettings.setQuotingPolicy(CsvQuotingPolicy::Always);
+  CsvGeneratorSettings neverSettings;
+  neverSettings.setQuotingPolicy(CsvQuotingPolicy::Never);
+
+  BENCHMARK("Minimal, 200000 records, 10 columns")
+  {
+    return writeLines(table, filePath, minimalSettings);
+  };
+
+  BENCHMARK("Always, 200000 records, 10 columns")
+  {
+    return writeLines(table, filePath, alwaysSettings);
+  };
+
+  BENCHMARK("Never, 200000 records, 10 columns")
+  {
+    return writeLines(table, filePath, neverSettings);
+  };
+
+  std::remove( filePath.c_str() );
+}
+
+TEST_CASE("writeTypedLine_vs_writeLine")
+{
+  const std::string filePath = "CsvFileWriterBenchmark.csv";
+  const ValueTable table = generateNumericTable(200000, 5);
+
+  REQUIRE( writeTypedLines(table, filePath) == 200000 );
+
+  BENCHMARK("std::to_string and writeLine, 200000 records, 10 columns")
+  {
+    return writeLinesConvertedToString(table, filePath);
+  };
+
+  BENCHMARK("writeTypedLine, 200000 records, 10 columns")
+  {
+    return writeTypedLines(table, filePath);
+  };
+
+  std::remove( filePath.c_str() );
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/Grammar/Csv/Karma/CsvRecord.h"
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include <boost/spirit/include/karma.hpp>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace Mdt::PlainText;
+
+using StringRecord = std::vector<std::string>;
+using StringTable = std::vector<StringRecord>;
+using CsvRecord = Grammar::Csv::Karma::CsvRecord<std::back_insert_iterator<std::string>, StringRecord>;
+
+/*
+ * Build a table of recordCount records,
+ * each record beeing made of columnCount fields.
+ * One field over protectedFieldRatio contains a separator,
+ * so it must be protected.
+ */
+StringTable generateTable(int recordCount, int columnCount, int protectedFieldRatio)
+{
+  StringTable table;
+
+  for(int row = 0; row < recordCount; ++row){
+    StringRecord record;
+    for(int col = 0; col < columnCount; ++col){
+      const int n = row * columnCount + col;
+      if( (n % protectedFieldRatio) == 0 ){
+        record.push_back( "Field " + std::to_string(n) + ", protected" );
+      }else{
+        record.push_back( "Field " + std::to_string(n) );
+      }
+    }
+    table.push_back(record);
+  }
+
+  return table;
+}
+
+/*
+ * Generate the table record by record,
+ * like CsvFileWriter::writeLine() does
+ */
+std::string generateCsv(const StringTable & table, const CsvRecord & rule)
+{
+  std::string csv;
+  std::back_insert_iterator<std::string> it(csv);
+
+  for(const auto & record : table){
+    if( !boost::spirit::karma::generate(it, rule, record) ){
+      throw std::runtime_error("generating CSV failed");
+    }
+  }
+
+  return csv;
+}
+
+
+TEST_CASE("CsvRecord")
+{
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+  const CsvRecord rule(csvSettings);
+
+  const StringTable table = generateTable(10000, 10, 10);
+
+  REQUIRE( !generateCsv(table, rule).empty() );
+
+  BENCHMARK("10000 records, 10 columns")
+  {
+    return generateCsv(table, rule);
+  };
+}
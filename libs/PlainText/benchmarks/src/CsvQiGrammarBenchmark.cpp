@@ -0,0 +1,82 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/Grammar/Csv/Qi/CsvFile.h"
+#include "Mdt/PlainText/CsvParserSettings"
+#include <boost/spirit/include/qi.hpp>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace Mdt::PlainText;
+
+using StringRecord = std::vector<std::string>;
+using StringTable = std::vector<StringRecord>;
+using CsvFile = Grammar::Csv::Qi::CsvFile<std::string::const_iterator, StringTable>;
+
+/*
+ * Build a CSV source of recordCount records,
+ * each record beeing made of columnCount numeric fields
+ */
+std::string generateCsvSource(int recordCount, int columnCount)
+{
+  std::string source;
+
+  for(int row = 0; row < recordCount; ++row){
+    for(int col = 0; col < columnCount; ++col){
+      if(col > 0){
+        source += ',';
+      }
+      source += std::to_string(100000 + row * columnCount + col);
+    }
+    source += '\n';
+  }
+
+  return source;
+}
+
+StringTable parseCsvSource(const std::string & source, const CsvFile & rule)
+{
+  StringTable table;
+
+  const bool ok = boost::spirit::qi::parse(source.cbegin(), source.cend(), rule, table);
+  if(!ok){
+    throw std::runtime_error("parsing CSV source failed");
+  }
+
+  return table;
+}
+
+
+TEST_CASE("CsvFile")
+{
+  CsvParserSettings csvSettings;
+  const CsvFile rule(csvSettings);
+
+  const std::string oneColumnSource = generateCsvSource(10000, 1);
+  const std::string threeColumnsSource = generateCsvSource(10000, 3);
+  const std::string tenColumnsSource = generateCsvSource(10000, 10);
+
+  REQUIRE( parseCsvSource(oneColumnSource, rule).size() == 10000 );
+  REQUIRE( parseCsvSource(threeColumnsSource, rule).size() == 10000 );
+  REQUIRE( parseCsvSource(tenColumnsSource, rule).size() == 10000 );
+
+  BENCHMARK("10000 records, 1 column")
+  {
+    return parseCsvSource(oneColumnSource, rule);
+  };
+
+  BENCHMARK("10000 records, 3 columns")
+  {
+    return parseCsvSource(threeColumnsSource, rule);
+  };
+
+  BENCHMARK("10000 records, 10 columns")
+  {
+    return parseCsvSource(tenColumnsSource, rule);
+  };
+}
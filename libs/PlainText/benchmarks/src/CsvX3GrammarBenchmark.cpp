@@ -0,0 +1,202 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvFile.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvRecord.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvRawRecord.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/HybridCsvRecord.h"
+#include "Mdt/PlainText/CsvRawField"
+#include "Mdt/PlainText/CsvParserSettings"
+#include "Mdt/PlainText/CsvDialect"
+#include <boost/spirit/home/x3.hpp>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using namespace Mdt::PlainText;
+
+using StringRecord = std::vector<std::string>;
+using StringTable = std::vector<StringRecord>;
+using CsvFile = Grammar::Csv::X3::CsvFile<StringTable>;
+using CommaCsvFile = Grammar::Csv::X3::CsvFile< StringTable, CommaCsvDialect<true> >;
+using CsvRecord = Grammar::Csv::X3::CsvRecord<StringRecord>;
+using HybridCsvRecord = Grammar::Csv::X3::HybridCsvRecord<StringRecord>;
+using RawRecord = std::vector< CsvRawField<std::string::const_iterator> >;
+using CsvRawRecord = Grammar::Csv::X3::CsvRawRecord<RawRecord>;
+
+/*
+ * Build a CSV source of recordCount records,
+ * each record beeing made of columnCount numeric fields
+ */
+std::string generateCsvSource(int recordCount, int columnCount)
+{
+  std::string source;
+
+  for(int row = 0; row < recordCount; ++row){
+    for(int col = 0; col < columnCount; ++col){
+      if(col > 0){
+        source += ',';
+      }
+      source += std::to_string(100000 + row * columnCount + col);
+    }
+    source += '\n';
+  }
+
+  return source;
+}
+
+template<typename Rule>
+StringTable parseCsvSource(const std::string & source, const Rule & rule)
+{
+  StringTable table;
+
+  auto first = source.cbegin();
+
+  const bool ok = boost::spirit::x3::parse(first, source.cend(), rule, table);
+  if(!ok){
+    throw std::runtime_error("parsing CSV source failed");
+  }
+
+  return table;
+}
+
+std::string fieldValue(const std::string & field)
+{
+  return field;
+}
+
+std::string fieldValue(const CsvRawField<std::string::const_iterator> & field)
+{
+  return field.toString();
+}
+
+/*
+ * Parse the source record by record,
+ * and only get the value of the first column
+ */
+template<typename Rule>
+std::vector<std::string> parseFirstColumn(const std::string & source, const Rule & rule)
+{
+  using Record = typename Rule::attribute_type;
+
+  std::vector<std::string> column;
+
+  auto first = source.cbegin();
+  const auto last = source.cend();
+
+  while(first != last){
+    Record record;
+    if( !boost::spirit::x3::parse(first, last, rule, record) ){
+      throw std::runtime_error("parsing CSV source failed");
+    }
+    boost::spirit::x3::parse(first, last, boost::spirit::x3::eol);
+    column.push_back( fieldValue(record[0]) );
+  }
+
+  return column;
+}
+
+
+TEST_CASE("CsvFile")
+{
+  CsvParserSettings csvSettings;
+  const CsvFile rule(csvSettings);
+
+  const std::string oneColumnSource = generateCsvSource(10000, 1);
+  const std::string threeColumnsSource = generateCsvSource(10000, 3);
+  const std::string tenColumnsSource = generateCsvSource(10000, 10);
+
+  REQUIRE( parseCsvSource(oneColumnSource, rule).size() == 10000 );
+  REQUIRE( parseCsvSource(threeColumnsSource, rule).size() == 10000 );
+  REQUIRE( parseCsvSource(tenColumnsSource, rule).size() == 10000 );
+
+  BENCHMARK("10000 records, 1 column")
+  {
+    return parseCsvSource(oneColumnSource, rule);
+  };
+
+  BENCHMARK("10000 records, 3 columns")
+  {
+    return parseCsvSource(threeColumnsSource, rule);
+  };
+
+  BENCHMARK("10000 records, 10 columns")
+  {
+    return parseCsvSource(tenColumnsSource, rule);
+  };
+}
+
+TEST_CASE("CsvFile_CommaCsvDialect")
+{
+  CsvParserSettings csvSettings;
+  const CommaCsvFile rule(csvSettings);
+
+  const std::string oneColumnSource = generateCsvSource(10000, 1);
+  const std::string threeColumnsSource = generateCsvSource(10000, 3);
+  const std::string tenColumnsSource = generateCsvSource(10000, 10);
+
+  REQUIRE( parseCsvSource(oneColumnSource, rule).size() == 10000 );
+  REQUIRE( parseCsvSource(threeColumnsSource, rule).size() == 10000 );
+  REQUIRE( parseCsvSource(tenColumnsSource, rule).size() == 10000 );
+
+  BENCHMARK("10000 records, 1 column")
+  {
+    return parseCsvSource(oneColumnSource, rule);
+  };
+
+  BENCHMARK("10000 records, 3 columns")
+  {
+    return parseCsvSource(threeColumnsSource, rule);
+  };
+
+  BENCHMARK("10000 records, 10 columns")
+  {
+    return parseCsvSource(tenColumnsSource, rule);
+  };
+}
+
+TEST_CASE("FirstColumn_CsvRecord_vs_CsvRawRecord")
+{
+  CsvParserSettings csvSettings;
+  const CsvRecord rule(csvSettings);
+  const CsvRawRecord rawRule(csvSettings);
+
+  const std::string tenColumnsSource = generateCsvSource(10000, 10);
+
+  REQUIRE( parseFirstColumn(tenColumnsSource, rule) == parseFirstColumn(tenColumnsSource, rawRule) );
+
+  BENCHMARK("CsvRecord, 10000 records, 10 columns")
+  {
+    return parseFirstColumn(tenColumnsSource, rule);
+  };
+
+  BENCHMARK("CsvRawRecord, 10000 records, 10 columns")
+  {
+    return parseFirstColumn(tenColumnsSource, rawRule);
+  };
+}
+
+TEST_CASE("FirstColumn_CsvRecord_vs_HybridCsvRecord")
+{
+  CsvParserSettings csvSettings;
+  const CsvRecord rule(csvSettings);
+  const HybridCsvRecord hybridRule(csvSettings);
+
+  const std::string tenColumnsSource = generateCsvSource(10000, 10);
+
+  REQUIRE( parseFirstColumn(tenColumnsSource, rule) == parseFirstColumn(tenColumnsSource, hybridRule) );
+
+  BENCHMARK("CsvRecord, 10000 records, 10 columns")
+  {
+    return parseFirstColumn(tenColumnsSource, rule);
+  };
+
+  BENCHMARK("HybridCsvRecord, 10000 records, 10 columns")
+  {
+    return parseFirstColumn(tenColumnsSource, hybridRule);
+  };
+}
@@ -0,0 +1,260 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "AsyncCsvFileWriter.h"
+#include "BufferedFileSink.h"
+#include "Mdt/PlainText/Impl/AsyncWriteQueue.h"
+#include "Mdt/PlainText/Impl/CsvSinkRecordWriter.h"
+#include "Mdt/PlainText/Impl/StringSink.h"
+#include <thread>
+#include <utility>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+/*
+ * The record writer has no mutable state,
+ * so it is shared by all producers.
+ * The file sink is only used by the writer thread,
+ * except to be opened and closed while this thread is not running.
+ */
+struct AsyncCsvFileWriter::Worker
+{
+  Worker(const CsvGeneratorSettings & settings, std::size_t queueCapacity) noexcept
+   : recordWriter(settings),
+     queue(queueCapacity)
+  {
+  }
+
+  /*
+   * Runs in the writer thread.
+   * Each batch of blocks is written through the sink buffer,
+   * which is only flushed on request,
+   * or when it is full.
+   */
+  void run()
+  {
+    std::vector<std::string> blocks;
+    bool flushRequested = false;
+
+    while( queue.take(blocks, flushRequested) ){
+      std::size_t size = 0;
+      try{
+        for(const auto & block : blocks){
+          sink.write( block.data(), block.size() );
+          size += block.size();
+        }
+        if(flushRequested){
+          sink.flush();
+        }
+        queue.setWritten(size, flushRequested);
+      }catch(const FileWriteError & error){
+        queue.setError( error.what() );
+      }
+      blocks.clear();
+    }
+  }
+
+  Impl::CsvSinkRecordWriter recordWriter;
+  Impl::AsyncWriteQueue queue;
+  BufferedFileSink sink;
+  std::thread thread;
+};
+
+namespace{
+
+  /*
+   * Size of a line if no field has to be protected,
+   * so that formatting it needs a single allocation
+   */
+  std::size_t estimatedLineSize(const std::vector<std::string> & record) noexcept
+  {
+    std::size_t size = record.size() + 2;
+
+    for(const auto & field : record){
+      size += field.size();
+    }
+
+    return size;
+  }
+
+  std::size_t estimatedLineSize(const std::vector<CsvValue> & record) noexcept
+  {
+    constexpr std::size_t numberSize = 24;
+    std::size_t size = record.size() + 2;
+
+    for(const auto & value : record){
+      if( value.type() == CsvValueType::String ){
+        size += value.toString().size();
+      }else{
+        size += numberSize;
+      }
+    }
+
+    return size;
+  }
+
+} // namespace{
+
+constexpr std::size_t AsyncCsvFileWriter::defaultQueueCapacity;
+
+AsyncCsvFileWriter::AsyncCsvFileWriter() = default;
+
+AsyncCsvFileWriter::~AsyncCsvFileWriter() noexcept
+{
+  try{
+    close();
+  }catch(...){
+  }
+}
+
+void AsyncCsvFileWriter::setFilePath(const std::string & filePath)
+{
+  assert( !filePath.empty() );
+  assert( !isOpen() );
+
+  mFilePath = filePath;
+}
+
+void AsyncCsvFileWriter::setCsvSettings(const CsvGeneratorSettings & settings) noexcept
+{
+  assert( settings.isValid() );
+  assert( !isOpen() );
+
+  mCsvSettings = settings;
+}
+
+void AsyncCsvFileWriter::setOpenMode(FileWriteOpenMode mode) noexcept
+{
+  assert( !isOpen() );
+
+  mOpenMode = mode;
+}
+
+void AsyncCsvFileWriter::setQueueCapacity(std::size_t size) noexcept
+{
+  assert( size > 0 );
+  assert( !isOpen() );
+
+  mQueueCapacity = size;
+}
+
+void AsyncCsvFileWriter::open()
+{
+  assert( !filePath().empty() );
+
+  close();
+
+  auto worker = std::make_unique<Worker>(mCsvSettings, mQueueCapacity);
+  worker->sink.open(mFilePath, mOpenMode);
+  worker->thread = std::thread(&Worker::run, worker.get());
+  mWorker = std::move(worker);
+}
+
+bool AsyncCsvFileWriter::isOpen() const noexcept
+{
+  return mWorker.get() != nullptr;
+}
+
+void AsyncCsvFileWriter::writeLine(const std::vector<std::string> & record)
+{
+  assert( isOpen() );
+
+  std::string data;
+  data.reserve( estimatedLineSize(record) );
+  Impl::StringSink sink(data);
+  if( !mWorker->recordWriter(record, sink) ){
+    throwLineError();
+  }
+  push( std::move(data) );
+}
+
+void AsyncCsvFileWriter::writeTypedLine(const std::vector<CsvValue> & record)
+{
+  assert( isOpen() );
+
+  std::string data;
+  data.reserve( estimatedLineSize(record) );
+  Impl::StringSink sink(data);
+  if( !mWorker->recordWriter(record, sink) ){
+    throwLineError();
+  }
+  push( std::move(data) );
+}
+
+void AsyncCsvFileWriter::writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                                    std::vector< std::vector<std::string> >::const_iterator last)
+{
+  assert( isOpen() );
+
+  if(first == last){
+    return;
+  }
+
+  std::string data;
+  Impl::StringSink sink(data);
+  bool ok = false;
+  for(; first != last; ++first){
+    if( mWorker->recordWriter(*first, sink) ){
+      ok = true;
+    }
+  }
+  if(!ok){
+    throwLineError();
+  }
+  push( std::move(data) );
+}
+
+void AsyncCsvFileWriter::flush()
+{
+  assert( isOpen() );
+
+  try{
+    mWorker->queue.waitFlushed();
+  }catch(const FileWriteError & error){
+    throw CsvFileWriteError( error.what() );
+  }
+}
+
+void AsyncCsvFileWriter::close()
+{
+  if( !isOpen() ){
+    return;
+  }
+
+  const auto worker = std::move(mWorker);
+  worker->queue.requestStop();
+  worker->thread.join();
+
+  std::string error = worker->queue.error();
+  try{
+    worker->sink.close();
+  }catch(const FileWriteError & closeError){
+    if( error.empty() ){
+      error = closeError.what();
+    }
+  }
+  if( !error.empty() ){
+    throw CsvFileWriteError(error);
+  }
+}
+
+void AsyncCsvFileWriter::push(std::string && data)
+{
+  try{
+    mWorker->queue.push( std::move(data) );
+  }catch(const FileWriteError & error){
+    throw CsvFileWriteError( error.what() );
+  }
+}
+
+void AsyncCsvFileWriter::throwLineError() const
+{
+  const std::string what = "writing a line in file '" + mFilePath + "' failed";
+  throw CsvFileWriteError(what);
+}
+
+}} // namespace Mdt{ namespace PlainText{
@@ -0,0 +1,252 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_ASYNC_CSV_FILE_WRITER_H
+#define MDT_PLAIN_TEXT_ASYNC_CSV_FILE_WRITER_H
+
+#include "FileOpenError.h"
+#include "CsvFileWriteError.h"
+#include "CsvGeneratorSettings.h"
+#include "FileWriteOpenMode.h"
+#include "CsvValue.h"
+#include "mdt_plaintext_export.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief CSV file writer that can be shared by many threads
+   *
+   * Each producer thread formats its records itself,
+   * then pushes them to a bounded queue.
+   * A writer thread, started by open(),
+   * takes the formatted records from the queue and writes them to the file.
+   * So, producers never wait for the file,
+   * and do not serialize on the formatting.
+   *
+   * Example of usage:
+   * \code
+   * Mdt::PlainText::AsyncCsvFileWriter csvWriter;
+   *
+   * csvWriter.setFilePath("/some/path/to/file.csv");
+   * csvWriter.open();
+   *
+   * // In each producer thread
+   * csvWriter.writeLine({"A","B","C"});
+   *
+   * // Once all producers are done
+   * csvWriter.close();
+   * \endcode
+   *
+   * The lines written by a producer are in the file in the order it wrote them,
+   * but the lines of different producers can be interleaved.
+   *
+   * When the queue is full, the producers are blocked
+   * until the writer thread catched up (backpressure).
+   *
+   * If writing to the file fails,
+   * the error is thrown to the producers by the next
+   * writeLine(), flush() or close().
+   *
+   * The setters, open() and close() must be called by a single thread,
+   * while no producer is writing.
+   */
+  class MDT_PLAINTEXT_EXPORT AsyncCsvFileWriter
+  {
+   public:
+
+    /*! \brief Default capacity of the queue, in bytes
+     */
+    static constexpr std::size_t defaultQueueCapacity = 4 * 1024 * 1024;
+
+    /*! \brief Construct a CSV file writer
+     */
+    AsyncCsvFileWriter();
+
+    /*! \brief Close this CSV file writer
+     *
+     * Pending records are written to the file,
+     * but errors are ignored.
+     * Call close() explicitly to get them reported.
+     */
+    ~AsyncCsvFileWriter() noexcept;
+
+    AsyncCsvFileWriter(const AsyncCsvFileWriter &) = delete;
+    AsyncCsvFileWriter & operator=(const AsyncCsvFileWriter &) = delete;
+    AsyncCsvFileWriter(AsyncCsvFileWriter &&) = delete;
+    AsyncCsvFileWriter & operator=(AsyncCsvFileWriter &&) = delete;
+
+    /*! \brief Set the path to the file
+     *
+     * \pre \a filePath must not be empty
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setFilePath(const std::string & filePath);
+
+    /*! \brief Get the path to the file
+     *
+     * \sa setFilePath()
+     */
+    const std::string & filePath() const noexcept
+    {
+      return mFilePath;
+    }
+
+    /*! \brief Set CSV settings
+     *
+     * \pre \a settings must be valid
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setCsvSettings(const CsvGeneratorSettings & settings) noexcept;
+
+    /*! \brief Get CSV settings
+     */
+    const CsvGeneratorSettings & csvSettings() const noexcept
+    {
+      return mCsvSettings;
+    }
+
+    /*! \brief Set the open mode for this writer
+     *
+     * The default open mode is FileWriteOpenMode::Append
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setOpenMode(FileWriteOpenMode mode) noexcept;
+
+    /*! \brief Get the open mode
+     */
+    FileWriteOpenMode openMode() const noexcept
+    {
+      return mOpenMode;
+    }
+
+    /*! \brief Set the capacity of the queue
+     *
+     * \a size is the size of the formatted records
+     * that can be pending in the queue.
+     * When it is reached, the producers are blocked.
+     *
+     * The default is defaultQueueCapacity
+     *
+     * \pre \a size must be > 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setQueueCapacity(std::size_t size) noexcept;
+
+    /*! \brief Get the capacity of the queue
+     */
+    std::size_t queueCapacity() const noexcept
+    {
+      return mQueueCapacity;
+    }
+
+    /*! \brief Open this CSV file writer
+     *
+     * If this file writer is allready open,
+     * it will be closed first.
+     *
+     * Open the file set with setFilePath(),
+     * then start the writer thread.
+     *
+     * \exception FileOpenError
+     * \exception CsvFileWriteError Thrown if closing the previous file failed
+     * \pre A path to a file must have been set
+     * \sa setFilePath()
+     * \sa close()
+     */
+    void open();
+
+    /*! \brief Check if this file writer is open
+     *
+     * \sa open()
+     */
+    bool isOpen() const noexcept;
+
+    /*! \brief Write a line to this CSV file
+     *
+     * \a record is formatted in the calling thread,
+     * then pushed to the queue.
+     * This function can be called by many threads at the same time.
+     *
+     * \exception CsvFileWriteError Thrown if \a record is empty,
+     *   or if writing to the file failed before
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLine(const std::vector<std::string> & record);
+
+    /*! \brief Write a line of typed values to this CSV file
+     *
+     * Values are formatted as described in CsvFileWriter::writeTypedLine(),
+     * otherwise this function works like writeLine().
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeTypedLine(const std::vector<CsvValue> & record);
+
+    /*! \brief Write the records in the range [\a first, \a last) to this CSV file
+     *
+     * The records are formatted in the calling thread
+     * and pushed to the queue at once,
+     * so they are not interleaved with the lines of other producers.
+     *
+     * Like CsvFileWriter::writeLines(), empty records are skipped,
+     * but at least one record must be written.
+     * If the range is empty, nothing is written.
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                    std::vector< std::vector<std::string> >::const_iterator last);
+
+    /*! \brief Wait until the lines written so far are in the file
+     *
+     * Returns once each line written before this call,
+     * by any producer, has been passed to the file system.
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void flush();
+
+    /*! \brief Close this file writer
+     *
+     * Waits until all pending lines have been written,
+     * stops the writer thread, then closes the file.
+     *
+     * \exception CsvFileWriteError
+     */
+    void close();
+
+   private:
+
+    struct Worker;
+
+    void push(std::string && data);
+    [[noreturn]] void throwLineError() const;
+
+    std::string mFilePath;
+    CsvGeneratorSettings mCsvSettings;
+    FileWriteOpenMode mOpenMode = FileWriteOpenMode::Append;
+    std::size_t mQueueCapacity = defaultQueueCapacity;
+    std::unique_ptr<Worker> mWorker;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_ASYNC_CSV_FILE_WRITER_H
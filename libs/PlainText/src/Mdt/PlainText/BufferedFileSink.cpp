@@ -0,0 +1,402 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "BufferedFileSink.h"
+#include "Mdt/PlainText/Impl/FileSync.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#if defined(MDT_PLAIN_TEXT_OS_UNIX)
+ #include <sys/types.h>
+ #include <sys/stat.h>
+ #include <sys/uio.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+#else
+ #include <fcntl.h>
+ #include <io.h>
+ #include <sys/stat.h>
+#endif // #if defined(MDT_PLAIN_TEXT_OS_UNIX)
+
+namespace Mdt{ namespace PlainText{
+
+namespace{
+
+#if defined(MDT_PLAIN_TEXT_OS_UNIX)
+
+  int openFile(const std::string & path, FileWriteOpenMode mode) noexcept
+  {
+    int flags = O_WRONLY | O_CREAT;
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+    switch(mode){
+      case FileWriteOpenMode::Append:
+        flags |= O_APPEND;
+        break;
+      case FileWriteOpenMode::Truncate:
+        flags |= O_TRUNC;
+        break;
+    }
+
+    int fd;
+    do{
+      fd = ::open(path.c_str(), flags, 0666);
+    }while( (fd < 0) && (errno == EINTR) );
+
+    return fd;
+  }
+
+  int createNewFile(const std::string & path) noexcept
+  {
+    int flags = O_WRONLY | O_CREAT | O_EXCL;
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+
+    int fd;
+    do{
+      fd = ::open(path.c_str(), flags, 0666);
+    }while( (fd < 0) && (errno == EINTR) );
+
+    return fd;
+  }
+
+  long writeFile(int fd, const char *data, std::size_t size) noexcept
+  {
+    return static_cast<long>( ::write(fd, data, size) );
+  }
+
+  long writeFile(int fd, const char *first, std::size_t firstSize, const char *second, std::size_t secondSize) noexcept
+  {
+    iovec vectors[2];
+
+    vectors[0].iov_base = const_cast<char*>(first);
+    vectors[0].iov_len = firstSize;
+    vectors[1].iov_base = const_cast<char*>(second);
+    vectors[1].iov_len = secondSize;
+
+    return static_cast<long>( ::writev(fd, vectors, 2) );
+  }
+
+  int closeFile(int fd) noexcept
+  {
+    return ::close(fd);
+  }
+
+  int64_t fileSize(int fd) noexcept
+  {
+    struct stat sb;
+    if( ::fstat(fd, &sb) != 0 ){
+      return 0;
+    }
+
+    return static_cast<int64_t>(sb.st_size);
+  }
+
+#else
+
+  int openFile(const std::string & path, FileWriteOpenMode mode) noexcept
+  {
+    int flags = _O_WRONLY | _O_CREAT | _O_BINARY;
+    switch(mode){
+      case FileWriteOpenMode::Append:
+        flags |= _O_APPEND;
+        break;
+      case FileWriteOpenMode::Truncate:
+        flags |= _O_TRUNC;
+        break;
+    }
+
+    return ::_open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+  }
+
+  int createNewFile(const std::string & path) noexcept
+  {
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+  }
+
+  long writeFile(int fd, const char *data, std::size_t size) noexcept
+  {
+    constexpr std::size_t maxSize = 0x40000000;
+
+    return ::_write( fd, data, static_cast<unsigned int>( std::min(size, maxSize) ) );
+  }
+
+  /*
+   * No gather write available,
+   * only the first block is written
+   */
+  long writeFile(int fd, const char *first, std::size_t firstSize, const char *, std::size_t) noexcept
+  {
+    return writeFile(fd, first, firstSize);
+  }
+
+  int closeFile(int fd) noexcept
+  {
+    return ::_close(fd);
+  }
+
+  int64_t fileSize(int fd) noexcept
+  {
+    struct _stat64 sb;
+    if( ::_fstat64(fd, &sb) != 0 ){
+      return 0;
+    }
+
+    return static_cast<int64_t>(sb.st_size);
+  }
+
+#endif // #if defined(MDT_PLAIN_TEXT_OS_UNIX)
+
+  std::string randomFileNameSuffix(std::minstd_rand & generator)
+  {
+    static const char characters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    std::uniform_int_distribution<std::size_t> distribution(0, sizeof(characters) - 2);
+
+    std::string suffix(6, ' ');
+    for(char & c : suffix){
+      c = characters[distribution(generator)];
+    }
+
+    return suffix;
+  }
+
+} // namespace{
+
+constexpr std::size_t BufferedFileSink::defaultBufferSize;
+
+BufferedFileSink::~BufferedFileSink() noexcept
+{
+  try{
+    close();
+  }catch(...){
+  }
+}
+
+void BufferedFileSink::open(const std::string & path, FileWriteOpenMode mode)
+{
+  assert( !path.empty() );
+
+  close();
+
+  const int fd = openFile(path, mode);
+  if(fd < 0){
+    const std::string what = "open file '" + path + "' failed: " + std::strerror(errno);
+    throw FileOpenError(what);
+  }
+
+  if(mode == FileWriteOpenMode::Append){
+    attachFile( fd, path, fileSize(fd) );
+  }else{
+    attachFile(fd, path, 0);
+  }
+}
+
+/*
+ * The file is created with O_EXCL,
+ * so a existing file is never reused,
+ * even if a other process creates it concurrently.
+ * mkstemp() is not used because it creates the file
+ * with 0600 permissions, that the final file would keep.
+ */
+void BufferedFileSink::openTemporaryFile(const std::string & filePath)
+{
+  assert( !filePath.empty() );
+
+  close();
+
+  constexpr int maxAttemptCount = 100;
+  std::minstd_rand generator( std::random_device{}() );
+
+  for(int attempt = 0; attempt < maxAttemptCount; ++attempt){
+    const std::string path = filePath + '.' + randomFileNameSuffix(generator);
+    const int fd = createNewFile(path);
+    if(fd >= 0){
+      attachFile(fd, path, 0);
+      return;
+    }
+    if(errno != EEXIST){
+      const std::string what = "create temporary file '" + path + "' failed: " + std::strerror(errno);
+      throw FileOpenError(what);
+    }
+  }
+
+  const std::string what = "create temporary file for '" + filePath + "' failed: no unique name found";
+  throw FileOpenError(what);
+}
+
+void BufferedFileSink::flush()
+{
+  assert( isOpen() );
+
+  flushBuffer();
+}
+
+void BufferedFileSink::sync()
+{
+  assert( isOpen() );
+
+  flushBuffer();
+  syncWrittenData();
+}
+
+void BufferedFileSink::syncWrittenData() const
+{
+  assert( isOpen() );
+
+  Impl::syncFileDescriptor(mFileDescriptor, mPath);
+}
+
+void BufferedFileSink::close()
+{
+  if( !isOpen() ){
+    return;
+  }
+
+  try{
+    flushBuffer();
+  }catch(...){
+    closeFile(mFileDescriptor);
+    releaseFile();
+    throw;
+  }
+  const int result = closeFile(mFileDescriptor);
+  const int error = errno;
+  releaseFile();
+
+  if( (result != 0) && (error != EINTR) ){
+    throwWriteError(error);
+  }
+}
+
+void BufferedFileSink::flushBuffer()
+{
+  assert( isOpen() );
+
+  const std::size_t size = pendingSize();
+
+  /*
+   * Reset the buffer first,
+   * so that a failed write does not leave it full
+   */
+  mBufferPosition = mBuffer.get();
+  writeToFile(mBuffer.get(), size);
+}
+
+/*
+ * The block does not fit in the buffer:
+ * both are written with a single system call,
+ * without copying the block
+ */
+void BufferedFileSink::writeBufferAndBlock(const char *data, std::size_t size)
+{
+  assert( isOpen() );
+
+  const std::size_t bufferedSize = pendingSize();
+
+  mBufferPosition = mBuffer.get();
+  writeToFile(mBuffer.get(), bufferedSize, data, size);
+}
+
+void BufferedFileSink::writeToFile(const char *data, std::size_t size)
+{
+  while(size > 0){
+    const long n = writeFile(mFileDescriptor, data, size);
+    if(n < 0){
+      if(errno == EINTR){
+        continue;
+      }
+      throwWriteError(errno);
+    }
+    data += n;
+    size -= static_cast<std::size_t>(n);
+  }
+}
+
+void BufferedFileSink::writeToFile(const char *first, std::size_t firstSize, const char *second, std::size_t secondSize)
+{
+  while( (firstSize > 0) && (secondSize > 0) ){
+    const long n = writeFile(mFileDescriptor, first, firstSize, second, secondSize);
+    if(n < 0){
+      if(errno == EINTR){
+        continue;
+      }
+      throwWriteError(errno);
+    }
+    auto written = static_cast<std::size_t>(n);
+    if(written < firstSize){
+      first += written;
+      firstSize -= written;
+    }else{
+      written -= firstSize;
+      firstSize = 0;
+      second += written;
+      secondSize -= written;
+    }
+  }
+  writeToFile(first, firstSize);
+  writeToFile(second, secondSize);
+}
+
+/*
+ * The buffer is only allocated if it does not exist yet,
+ * or if its size changed since the last open()
+ */
+void BufferedFileSink::allocateBuffer()
+{
+  if(mAllocatedBufferSize != mBufferSize){
+    mBuffer.reset( new char[mBufferSize] );
+    mAllocatedBufferSize = mBufferSize;
+  }
+  mBufferPosition = mBuffer.get();
+  mBufferEnd = mBufferPosition + mBufferSize;
+}
+
+/*
+ * Reserve the space after the current end of the file,
+ * without changing its size (FALLOC_FL_KEEP_SIZE),
+ * so that no trailing zeros remain if less data is written.
+ * posix_fallocate() is not used because it changes the size.
+ */
+void BufferedFileSink::preallocate() noexcept
+{
+  assert( isOpen() );
+
+  if(mPreallocatedSize <= 0){
+    return;
+  }
+
+#if defined(MDT_PLAIN_TEXT_OS_UNIX) && defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+  ::fallocate(mFileDescriptor, FALLOC_FL_KEEP_SIZE, fileSize(mFileDescriptor), mPreallocatedSize);
+#endif
+}
+
+void BufferedFileSink::attachFile(int fd, const std::string & path, int64_t fileSizeAtOpen)
+{
+  mFileDescriptor = fd;
+  mPath = path;
+  mFileSizeAtOpen = fileSizeAtOpen;
+  allocateBuffer();
+
+  preallocate();
+}
+
+void BufferedFileSink::releaseFile() noexcept
+{
+  mFileDescriptor = -1;
+  mBufferPosition = nullptr;
+  mBufferEnd = nullptr;
+}
+
+void BufferedFileSink::throwWriteError(int error) const
+{
+  const std::string what = "writing to file '" + mPath + "' failed: " + std::strerror(error);
+  throw FileWriteError(what);
+}
+
+}} // namespace Mdt{ namespace PlainText{
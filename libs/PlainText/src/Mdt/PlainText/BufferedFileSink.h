@@ -0,0 +1,351 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_BUFFERED_FILE_SINK_H
+#define MDT_PLAIN_TEXT_BUFFERED_FILE_SINK_H
+
+#include "FileOpenError.h"
+#include "FileWriteError.h"
+#include "FileWriteOpenMode.h"
+#include "mdt_plaintext_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief Output sink that writes to a file through a large user-space buffer
+   *
+   * Chars are copied to the buffer using a raw pointer,
+   * and the buffer is written to the file
+   * with as few system calls as possible.
+   * When a block that does not fit in the buffer is written,
+   * both are passed to a single writev() call, without copying the block.
+   *
+   * \code
+   * BufferedFileSink sink;
+   *
+   * sink.setBufferSize(1024*1024);
+   * sink.open("/some/path/to/file.csv", FileWriteOpenMode::Truncate);
+   * auto it = sink.outputIterator();
+   * boost::spirit::karma::generate(it, rule, record);
+   * sink.close();
+   * \endcode
+   *
+   * On Unix, the file is accessed with the POSIX API.
+   */
+  class MDT_PLAINTEXT_EXPORT BufferedFileSink
+  {
+   public:
+
+    /*! \brief Output iterator that puts chars to a sink
+     */
+    class iterator
+    {
+     public:
+
+      using iterator_category = std::output_iterator_tag;
+      using value_type = void;
+      using difference_type = void;
+      using pointer = void;
+      using reference = void;
+
+      /*! \brief Construct a iterator that puts chars to \a sink
+       */
+      explicit iterator(BufferedFileSink & sink) noexcept
+       : mSink(&sink)
+      {
+      }
+
+      /*! \brief Put \a c to the sink
+       *
+       * \exception FileWriteError
+       */
+      iterator & operator=(char c)
+      {
+        mSink->put(c);
+        return *this;
+      }
+
+      iterator & operator*() noexcept
+      {
+        return *this;
+      }
+
+      iterator & operator++() noexcept
+      {
+        return *this;
+      }
+
+      iterator & operator++(int) noexcept
+      {
+        return *this;
+      }
+
+     private:
+
+      BufferedFileSink *mSink;
+    };
+
+    /*! \brief Default size of the buffer, in bytes
+     */
+    static constexpr std::size_t defaultBufferSize = 256 * 1024;
+
+    /*! \brief Construct a sink
+     */
+    BufferedFileSink() noexcept = default;
+
+    /*! \brief Close this sink
+     *
+     * Pending data are written to the file,
+     * but errors are ignored.
+     * Call close() explicitly to get them reported.
+     */
+    ~BufferedFileSink() noexcept;
+
+    BufferedFileSink(const BufferedFileSink &) = delete;
+    BufferedFileSink & operator=(const BufferedFileSink &) = delete;
+    BufferedFileSink(BufferedFileSink &&) = delete;
+    BufferedFileSink & operator=(BufferedFileSink &&) = delete;
+
+    /*! \brief Set the size of the buffer
+     *
+     * The default is defaultBufferSize
+     *
+     * \pre \a size must be > 0
+     * \pre This sink must not be open
+     * \sa isOpen()
+     */
+    void setBufferSize(std::size_t size) noexcept
+    {
+      assert( size > 0 );
+      assert( !isOpen() );
+
+      mBufferSize = size;
+    }
+
+    /*! \brief Get the size of the buffer
+     */
+    std::size_t bufferSize() const noexcept
+    {
+      return mBufferSize;
+    }
+
+    /*! \brief Set the expected count of bytes that will be written
+     *
+     * If \a size is > 0, open() asks the file system
+     * to reserve this space after the end of the file,
+     * so that large exports do not fragment it.
+     * The size of the file is not changed by the reservation.
+     *
+     * This is only a hint:
+     * it is ignored if the platform or the file system does not support it.
+     *
+     * The default is 0, which means no reservation.
+     *
+     * \pre \a size must be >= 0
+     * \pre This sink must not be open
+     * \sa isOpen()
+     */
+    void setPreallocatedSize(int64_t size) noexcept
+    {
+      assert( size >= 0 );
+      assert( !isOpen() );
+
+      mPreallocatedSize = size;
+    }
+
+    /*! \brief Get the expected count of bytes that will be written
+     */
+    int64_t preallocatedSize() const noexcept
+    {
+      return mPreallocatedSize;
+    }
+
+    /*! \brief Open the file at \a path
+     *
+     * If this sink is allready open,
+     * it will be closed first.
+     *
+     * \pre \a path must not be empty
+     * \exception FileOpenError
+     * \exception FileWriteError Thrown if closing the previous file failed
+     */
+    void open(const std::string & path, FileWriteOpenMode mode);
+
+    /*! \brief Create and open a new temporary file for \a filePath
+     *
+     * The temporary file is created in the directory of \a filePath,
+     * and is named after it, with a random suffix,
+     * for example \c file.csv.a8Kz3Q .
+     * A existing file is never opened,
+     * so each call creates a distinct file.
+     * Its path is available with path().
+     *
+     * If this sink is allready open,
+     * it will be closed first.
+     *
+     * \pre \a filePath must not be empty
+     * \exception FileOpenError
+     * \exception FileWriteError Thrown if closing the previous file failed
+     */
+    void openTemporaryFile(const std::string & filePath);
+
+    /*! \brief Check if this sink is open
+     */
+    bool isOpen() const noexcept
+    {
+      return mFileDescriptor >= 0;
+    }
+
+    /*! \brief Get the path to the file
+     */
+    const std::string & path() const noexcept
+    {
+      return mPath;
+    }
+
+    /*! \brief Get the size of the file when it was opened
+     *
+     * Is 0 for a new file, or a file opened with FileWriteOpenMode::Truncate .
+     * With FileWriteOpenMode::Append ,
+     * this tells if the file allready has some content,
+     * for example a header.
+     *
+     * \pre This sink must be open
+     */
+    int64_t fileSizeAtOpen() const noexcept
+    {
+      assert( isOpen() );
+
+      return mFileSizeAtOpen;
+    }
+
+    /*! \brief Get a output iterator that puts chars to this sink
+     *
+     * \pre This sink must be open
+     */
+    iterator outputIterator() noexcept
+    {
+      assert( isOpen() );
+
+      return iterator(*this);
+    }
+
+    /*! \brief Put \a c to this sink
+     *
+     * \pre This sink must be open
+     * \exception FileWriteError
+     */
+    void put(char c)
+    {
+      assert( isOpen() );
+
+      if(mBufferPosition == mBufferEnd){
+        flushBuffer();
+      }
+      *mBufferPosition = c;
+      ++mBufferPosition;
+    }
+
+    /*! \brief Write \a size bytes from \a data to this sink
+     *
+     * \pre This sink must be open
+     * \exception FileWriteError
+     */
+    void write(const char *data, std::size_t size)
+    {
+      assert( isOpen() );
+      assert( (data != nullptr) || (size == 0) );
+
+      if( size <= availableSize() ){
+        std::memcpy(mBufferPosition, data, size);
+        mBufferPosition += size;
+        return;
+      }
+      writeBufferAndBlock(data, size);
+    }
+
+    /*! \brief Write the buffer to the file
+     *
+     * \pre This sink must be open
+     * \exception FileWriteError
+     */
+    void flush();
+
+    /*! \brief Write the buffer to the file, then sync the file to the storage
+     *
+     * Returns once all data written to this sink are on the storage.
+     *
+     * \pre This sink must be open
+     * \exception FileWriteError
+     */
+    void sync();
+
+    /*! \brief Sync the data allready written to the file to the storage
+     *
+     * Unlike sync(), the buffer is not written:
+     * only the data passed to the file by a previous flush are synced.
+     * This function can be called by a other thread,
+     * while data are written to this sink,
+     * but not while it is opened or closed.
+     *
+     * \pre This sink must be open
+     * \exception FileWriteError
+     */
+    void syncWrittenData() const;
+
+    /*! \brief Flush and close this sink
+     *
+     * The file is closed even if flushing failed.
+     *
+     * The buffer is kept, so that opening a other file
+     * with the same buffer size does not allocate it again.
+     *
+     * \exception FileWriteError
+     */
+    void close();
+
+   private:
+
+    std::size_t pendingSize() const noexcept
+    {
+      return static_cast<std::size_t>(mBufferPosition - mBuffer.get());
+    }
+
+    std::size_t availableSize() const noexcept
+    {
+      return static_cast<std::size_t>(mBufferEnd - mBufferPosition);
+    }
+
+    void flushBuffer();
+    void writeBufferAndBlock(const char *data, std::size_t size);
+    void writeToFile(const char *data, std::size_t size);
+    void writeToFile(const char *first, std::size_t firstSize, const char *second, std::size_t secondSize);
+    void allocateBuffer();
+    void preallocate() noexcept;
+    void attachFile(int fd, const std::string & path, int64_t fileSizeAtOpen);
+    void releaseFile() noexcept;
+    [[noreturn]] void throwWriteError(int error) const;
+
+    int mFileDescriptor = -1;
+    std::size_t mBufferSize = defaultBufferSize;
+    int64_t mPreallocatedSize = 0;
+    int64_t mFileSizeAtOpen = 0;
+    std::unique_ptr<char[]> mBuffer;
+    std::size_t mAllocatedBufferSize = 0;
+    char *mBufferPosition = nullptr;
+    char *mBufferEnd = nullptr;
+    std::string mPath;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_BUFFERED_FILE_SINK_H
@@ -61,6 +61,17 @@ namespace Mdt{ namespace PlainText{
     {
     }
 
+    /*! \brief Construct a view on the range [\a first, \a last) of a container
+     *
+     * This is useful to process a part of a container,
+     * for example a batch of records.
+     */
+    ContainerAliasView(typename SourceContainer::const_iterator first, typename SourceContainer::const_iterator last)
+     : mBegin(first),
+       mEnd(last)
+    {
+    }
+
     /*! \brief Copy construct a view from \a other
      */
     ContainerAliasView(const ContainerAliasView & other) = default;
@@ -0,0 +1,221 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_CSV_DIALECT_H
+#define MDT_PLAIN_TEXT_CSV_DIALECT_H
+
+#include "CsvParserSettings.h"
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief CSV dialect known at compile time
+   *
+   * A CSV dialect is the field separator, the field protection
+   * and the parsing of the Excel protection marker (EXP).
+   *
+   * The X3 grammars, like Grammar::Csv::X3::CsvRecord ,
+   * can be instantiated with a CsvDialect.
+   * Then each comparison to the field separator or the field protection
+   * is a comparison to a constant, which the compiler can optimize.
+   *
+   * The other settings, like the limits, are still taken from the CsvParserSettings .
+   *
+   * The common dialects are defined as CommaCsvDialect ,
+   * SemicolonCsvDialect and TabCsvDialect .
+   * Use visitCsvDialect() to select one at runtime.
+   *
+   * \sa RuntimeCsvDialect
+   */
+  template<char FieldSeparator, char FieldProtection, bool ParseExp>
+  class CsvDialect
+  {
+    static_assert( !CsvParserSettings::isEndOfLine(FieldSeparator), "field separator must not be a end-of-line" );
+    static_assert( !CsvParserSettings::isEndOfLine(FieldProtection), "field protection must not be a end-of-line" );
+    static_assert( FieldSeparator != FieldProtection, "field separator and field protection must not be the same" );
+    static_assert( !ParseExp || ( (FieldSeparator != '~') && (FieldProtection != '~') ), "EXP must not be a field separator or a field protection" );
+
+   public:
+
+    /*! \brief Construct a dialect
+     */
+    constexpr CsvDialect() noexcept = default;
+
+    /*! \brief Construct a dialect from \a settings
+     *
+     * \pre \a settings must be compatible with this dialect
+     * \sa isCompatibleWith()
+     */
+    explicit CsvDialect(const CsvParserSettings & settings) noexcept
+    {
+      assert( isCompatibleWith(settings) );
+      static_cast<void>(settings);
+    }
+
+    /*! \brief Get the field separator
+     */
+    static constexpr char fieldSeparator() noexcept
+    {
+      return FieldSeparator;
+    }
+
+    /*! \brief Get the field protection
+     */
+    static constexpr char fieldProtection() noexcept
+    {
+      return FieldProtection;
+    }
+
+    /*! \brief Check if the Excel protection marker is parsed
+     */
+    static constexpr bool parseExp() noexcept
+    {
+      return ParseExp;
+    }
+
+    /*! \brief Check if \a settings has the same dialect than this one
+     */
+    static constexpr bool isCompatibleWith(const CsvParserSettings & settings) noexcept
+    {
+      return (settings.fieldSeparator() == FieldSeparator)
+          && (settings.fieldProtection() == FieldProtection)
+          && (settings.parseExp() == ParseExp);
+    }
+
+    /*! \brief Get default parser settings with this dialect
+     */
+    static constexpr CsvParserSettings parserSettings() noexcept
+    {
+      CsvParserSettings settings;
+
+      settings.setFieldSeparator(FieldSeparator);
+      settings.setFieldProtection(FieldProtection);
+      settings.setParseExp(ParseExp);
+
+      return settings;
+    }
+  };
+
+  /*! \brief RFC 4180 CSV dialect: comma separated, double quote protected
+   */
+  template<bool ParseExp>
+  using CommaCsvDialect = CsvDialect<',', '"', ParseExp>;
+
+  /*! \brief Semicolon separated, double quote protected CSV dialect
+   *
+   * This is the common dialect in locales where the comma is the decimal separator.
+   */
+  template<bool ParseExp>
+  using SemicolonCsvDialect = CsvDialect<';', '"', ParseExp>;
+
+  /*! \brief Tab separated, double quote protected CSV dialect (TSV)
+   */
+  template<bool ParseExp>
+  using TabCsvDialect = CsvDialect<'\t', '"', ParseExp>;
+
+  /*! \brief CSV dialect known at runtime
+   *
+   * Has the same interface than CsvDialect ,
+   * but holds the dialect of a CsvParserSettings .
+   */
+  class RuntimeCsvDialect
+  {
+   public:
+
+    /*! \brief Construct a dialect from \a settings
+     */
+    explicit constexpr RuntimeCsvDialect(const CsvParserSettings & settings) noexcept
+     : mFieldSeparator( settings.fieldSeparator() ),
+       mFieldProtection( settings.fieldProtection() ),
+       mParseExp( settings.parseExp() )
+    {
+    }
+
+    /*! \brief Get the field separator
+     */
+    constexpr char fieldSeparator() const noexcept
+    {
+      return mFieldSeparator;
+    }
+
+    /*! \brief Get the field protection
+     */
+    constexpr char fieldProtection() const noexcept
+    {
+      return mFieldProtection;
+    }
+
+    /*! \brief Check if the Excel protection marker is parsed
+     */
+    constexpr bool parseExp() const noexcept
+    {
+      return mParseExp;
+    }
+
+    /*! \brief Returns always true
+     */
+    static constexpr bool isCompatibleWith(const CsvParserSettings &) noexcept
+    {
+      return true;
+    }
+
+   private:
+
+    char mFieldSeparator;
+    char mFieldProtection;
+    bool mParseExp;
+  };
+
+  /*! \brief Call \a visitor with the dialect of \a settings
+   *
+   * If \a settings matches a predefined dialect
+   * (CommaCsvDialect , SemicolonCsvDialect or TabCsvDialect),
+   * \a visitor is called with a instance of this dialect.
+   * Otherwise, it is called with a RuntimeCsvDialect .
+   *
+   * \a visitor is typically a generic lambda:
+   * \code
+   * const auto table = visitCsvDialect(settings, [&](auto dialect){
+   *   using Dialect = decltype(dialect);
+   *   const Grammar::Csv::X3::CsvFile<Table, Dialect> parser(settings);
+   *   return parseTable(parser);
+   * });
+   * \endcode
+   * Each dialect instantiates the visitor,
+   * so it must return the same type for all dialects.
+   *
+   * \pre \a settings must be valid
+   */
+  template<typename Visitor>
+  auto visitCsvDialect(const CsvParserSettings & settings, Visitor visitor)
+  {
+    assert( settings.isValid() );
+
+    if( CommaCsvDialect<true>::isCompatibleWith(settings) ){
+      return visitor( CommaCsvDialect<true>() );
+    }
+    if( CommaCsvDialect<false>::isCompatibleWith(settings) ){
+      return visitor( CommaCsvDialect<false>() );
+    }
+    if( SemicolonCsvDialect<true>::isCompatibleWith(settings) ){
+      return visitor( SemicolonCsvDialect<true>() );
+    }
+    if( SemicolonCsvDialect<false>::isCompatibleWith(settings) ){
+      return visitor( SemicolonCsvDialect<false>() );
+    }
+    if( TabCsvDialect<true>::isCompatibleWith(settings) ){
+      return visitor( TabCsvDialect<true>() );
+    }
+    if( TabCsvDialect<false>::isCompatibleWith(settings) ){
+      return visitor( TabCsvDialect<false>() );
+    }
+
+    return visitor( RuntimeCsvDialect(settings) );
+  }
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_CSV_DIALECT_H
@@ -7,6 +7,7 @@
 #ifndef MDT_PLAIN_TEXT_CSV_FILE_READ_ERROR_H
 #define MDT_PLAIN_TEXT_CSV_FILE_READ_ERROR_H
 
+#include "SourcePosition.h"
 #include "mdt_plaintext_export.h"
 #include <stdexcept>
 #include <string>
@@ -21,10 +22,25 @@ namespace Mdt{ namespace PlainText{
 
     /*! \brief Constructor
      */
-    explicit CsvFileReadError(const std::string & what)
-     : runtime_error(what)
+    explicit CsvFileReadError(const std::string & what, const SourcePosition & position = SourcePosition())
+     : runtime_error(what),
+       mPosition(position)
     {
     }
+
+    /*! \brief Get the position in the file at which the reading failed
+     *
+     * This is the position at which the parser stopped,
+     * which is at or after the beginning of the record that could not be parsed.
+     */
+    const SourcePosition & position() const noexcept
+    {
+      return mPosition;
+    }
+
+   private:
+
+    SourcePosition mPosition;
   };
 
 }} // namespace Mdt{ namespace PlainText{
@@ -6,8 +6,9 @@
  */
 #include "CsvFileReader.h"
 #include "CsvFileReaderTemplate.h"
-#include "Mdt/PlainText/Grammar/Csv/Qi/CsvFileLine.h"
-#include "Mdt/PlainText/Grammar/Csv/Qi/CsvFile.h"
+#include "CsvDialect.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/HybridCsvRecord.h"
+#include "Mdt/PlainText/Impl/CsvFieldCountRecord.h"
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{
@@ -66,17 +67,24 @@ bool CsvFileReader::atEnd() const noexcept
   return mImpl->atEnd();
 }
 
+SourcePosition CsvFileReader::position() const noexcept
+{
+  assert( isOpen() );
+
+  return mImpl->position();
+}
+
 std::vector<std::string> CsvFileReader::readLine()
 {
   assert( isOpen() );
   assert( !atEnd() );
 
-  using SourceIterator = CsvFileReaderTemplate::const_iterator;
   using Record = std::vector<std::string>;
 
-  Grammar::Csv::Qi::CsvFileLine<SourceIterator, Record> rule( csvSettings() );
-
-  return mImpl->readLine<Record>(rule);
+  return visitCsvDialect(csvSettings(), [this](auto dialect){
+    const Grammar::Csv::X3::HybridCsvRecord<Record, decltype(dialect)> rule( csvSettings() );
+    return mImpl->readRecord<Record>(rule);
+  });
 }
 
 std::vector< std::vector<std::string> > CsvFileReader::readAll()
@@ -84,12 +92,38 @@ std::vector< std::vector<std::string> > CsvFileReader::readAll()
   assert( isOpen() );
   assert( !atEnd() );
 
-  using SourceIterator = CsvFileReaderTemplate::const_iterator;
-  using Table = std::vector< std::vector<std::string> >;
+  using Record = std::vector<std::string>;
+  using Table = std::vector<Record>;
+
+  return visitCsvDialect(csvSettings(), [this](auto dialect){
+    const Grammar::Csv::X3::HybridCsvRecord<Record, decltype(dialect)> rule( csvSettings() );
+    return mImpl->readAllRecords<Table>(rule);
+  });
+}
+
+std::vector< std::vector<std::string> > CsvFileReader::readAll(std::vector<CsvMalformedRecord> & malformedRecords)
+{
+  assert( isOpen() );
+
+  using Record = std::vector<std::string>;
+  using Table = std::vector<Record>;
+
+  return visitCsvDialect(csvSettings(), [this, &malformedRecords](auto dialect){
+    const Grammar::Csv::X3::HybridCsvRecord<Record, decltype(dialect)> rule( csvSettings() );
+    return mImpl->readAllSkippingMalformedRecords<Table>(rule, malformedRecords);
+  });
+}
+
+CsvFileValidationReport CsvFileReader::validate()
+{
+  assert( isOpen() );
 
-  Grammar::Csv::Qi::CsvFile<SourceIterator, Table> rule( csvSettings() );
+  using Record = Impl::CsvFieldCountRecord;
 
-  return mImpl->readAll<Table>(rule);
+  return visitCsvDialect(csvSettings(), [this](auto dialect){
+    const Grammar::Csv::X3::HybridCsvRecord<Record, decltype(dialect)> rule( csvSettings() );
+    return mImpl->validate<Record>(rule);
+  });
 }
 
 void CsvFileReader::close()
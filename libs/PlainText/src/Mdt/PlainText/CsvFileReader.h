@@ -10,6 +10,9 @@
 #include "CsvParserSettings.h"
 #include "FileOpenError.h"
 #include "CsvFileReadError.h"
+#include "CsvFileValidationReport.h"
+#include "CsvMalformedRecord.h"
+#include "SourcePosition.h"
 #include "mdt_plaintext_export.h"
 #include <vector>
 #include <string>
@@ -88,6 +91,11 @@ namespace Mdt{ namespace PlainText{
      *
      * Open the file set with setFilePath().
      *
+     * If the CSV settings require a UTF-8 source,
+     * the file is validated while it is read,
+     * and the read methods throw a CsvFileReadError
+     * once they reach the line that contains the first invalid sequence.
+     *
      * \exception FileOpenError
      * \pre A path to a file must have been set
      * \sa setFilePath()
@@ -108,6 +116,18 @@ namespace Mdt{ namespace PlainText{
      */
     bool atEnd() const noexcept;
 
+    /*! \brief Get the current position in the file
+     *
+     * Called before readLine(),
+     * returns the position at which the record to read starts.
+     * The offset is in bytes.
+     *
+     * \pre This file reader must be open
+     * \sa isOpen()
+     * \sa CsvFileReadError::position()
+     */
+    SourcePosition position() const noexcept;
+
     /*! \brief Read a line from the CSV file
      *
      * \exception CsvFileReadError
@@ -128,6 +148,63 @@ namespace Mdt{ namespace PlainText{
      */
     std::vector< std::vector<std::string> > readAll();
 
+    /*! \brief Read all lines from the CSV file, skipping malformed records
+     *
+     * Unlike readAll(), a malformed record does not stop the reading.
+     * It is added to \a malformedRecords ,
+     * with its line number, its byte offset and its raw data,
+     * then the reading continues after the next end-of-line.
+     *
+     * Example:
+     * \code
+     * std::vector<CsvMalformedRecord> malformedRecords;
+     *
+     * csvReader.open();
+     * const auto table = csvReader.readAll(malformedRecords);
+     * csvReader.close();
+     *
+     * for(const auto & malformedRecord : malformedRecords){
+     *   std::cerr << "line " << malformedRecord.lineNumber() << ": " << malformedRecord.rawData() << std::endl;
+     * }
+     * \endcode
+     *
+     * \exception CsvFileReadError if the file is not valid UTF-8,
+     *   when required by CsvParserSettings::validateUtf8()
+     * \pre This file reader must be open
+     * \sa isOpen()
+     */
+    std::vector< std::vector<std::string> > readAll(std::vector<CsvMalformedRecord> & malformedRecords);
+
+    /*! \brief Validate the CSV file
+     *
+     * Parses the remaining records of the file,
+     * without storing them,
+     * and reports if they are well formed
+     * and if they all have the same count of columns.
+     *
+     * The memory used does not depend on the size of the file,
+     * so this can be used to check a file before loading it.
+     *
+     * The validation stops at the first malformed record.
+     *
+     * Example:
+     * \code
+     * csvReader.open();
+     * const auto report = csvReader.validate();
+     * csvReader.close();
+     * if( !report.isValid() ){
+     *   // Handle the error
+     * }
+     * \endcode
+     *
+     * \exception CsvFileReadError if the file is not valid UTF-8,
+     *   when required by CsvParserSettings::validateUtf8()
+     * \pre This file reader must be open
+     * \sa isOpen()
+     * \sa CsvFileValidationReport
+     */
+    CsvFileValidationReport validate();
+
     /*! \brief Close this file reader
      */
     void close();
@@ -5,3 +5,18 @@
  * https://www.boost.org/LICENSE_1_0.txt)
  */
 #include "CsvFileReaderTemplate.h"
+
+namespace Mdt{ namespace PlainText{
+
+  template Impl::CsvFileReaderRecord CsvFileReaderTemplate::readRecord<Impl::CsvFileReaderRecord>(const Impl::CsvFileReaderQiRecordRule &);
+  template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderQiRecordRule &);
+  template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAll<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderQiFileRule &);
+  template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllSkippingMalformedRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderQiRecordRule &, std::vector<CsvMalformedRecord> &);
+  template CsvFileValidationReport CsvFileReaderTemplate::validate<Impl::CsvFieldCountRecord>(const Impl::CsvFileReaderQiFieldCountRule &);
+  template Impl::CsvFileReaderRecord CsvFileReaderTemplate::readRecord<Impl::CsvFileReaderRecord>(const Impl::CsvFileReaderX3RecordRule &);
+  template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderX3RecordRule &);
+  template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAll<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderX3FileRule &);
+  template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllSkippingMalformedRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderX3RecordRule &, std::vector<CsvMalformedRecord> &);
+  template CsvFileValidationReport CsvFileReaderTemplate::validate<Impl::CsvFieldCountRecord>(const Impl::CsvFileReaderX3FieldCountRule &);
+
+}} // namespace Mdt{ namespace PlainText{
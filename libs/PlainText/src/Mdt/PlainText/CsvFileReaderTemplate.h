@@ -10,14 +10,29 @@
 #include "CsvParserSettings.h"
 #include "FileOpenError.h"
 #include "CsvFileReadError.h"
+#include "CsvFileValidationReport.h"
+#include "CsvMalformedRecord.h"
 #include "OpenFstream.h"
+#include "PositionTrackingIterator.h"
+#include "Impl/CsvFileSourceIterator.h"
+#include "Impl/CsvFieldCountRecord.h"
+#include "Impl/ParseRule.h"
+#include "Impl/Utf8ValidatingStreamBuffer.h"
+#include "Grammar/Csv/Qi/CsvRecord.h"
+#include "Grammar/Csv/Qi/CsvFile.h"
+#include "Grammar/Csv/X3/CsvRecord.h"
+#include "Grammar/Csv/X3/CsvFile.h"
+#include "SourcePosition.h"
 #include "mdt_plaintext_export.h"
 #include <boost/spirit/include/qi.hpp>
 #include <boost/spirit/include/support_multi_pass.hpp>
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <cassert>
 #include <fstream>
 #include <iterator>
+#include <utility>
 
 namespace Mdt{ namespace PlainText{
 
@@ -61,6 +76,19 @@ namespace Mdt{ namespace PlainText{
    * }
    * \endcode
    *
+   * The rules can be Boost.Spirit Qi grammars, like Grammar::Csv::Qi::CsvRecord ,
+   * or Boost.Spirit X3 parsers, like Grammar::Csv::X3::CsvRecord .
+   * Both implement the same CSV grammar.
+   * The X3 parsers are fully inlined, which is generally faster
+   * to parse as well as to compile.
+   *
+   * For records of type std::vector<std::string> ,
+   * the read methods are instantiated once in the library
+   * with Grammar::Csv::Qi::CsvRecord , Grammar::Csv::Qi::CsvFile ,
+   * Grammar::Csv::X3::CsvRecord and Grammar::Csv::X3::CsvFile
+   * (using RuntimeCsvDialect).
+   * Using them does not compile the grammars again.
+   *
    * \sa CsvFileReader
    */
   class MDT_PLAINTEXT_EXPORT CsvFileReaderTemplate
@@ -70,8 +98,12 @@ namespace Mdt{ namespace PlainText{
    public:
 
     /*! \brief STL const iterator
+     *
+     * Tracks its position in the file.
+     *
+     * \sa position()
      */
-    using const_iterator = boost::spirit::multi_pass<FileIterator>;
+    using const_iterator = Impl::CsvFileSourceIterator;
 
     /*! \brief Construct a CSV file reader
      */
@@ -140,6 +172,12 @@ namespace Mdt{ namespace PlainText{
      *
      * Open the file set with setFilePath().
      *
+     * If the CSV settings require a UTF-8 source,
+     * the file is validated block by block while it is read.
+     * The read methods then throw a CsvFileReadError
+     * when they reach the line that contains the first invalid sequence,
+     * with the position of this sequence.
+     *
      * \exception FileOpenError
      * \pre A path to a file must have been set
      * \sa setFilePath()
@@ -150,8 +188,13 @@ namespace Mdt{ namespace PlainText{
       assert( !filePath().empty() );
 
       openIfstream(mFileStream, mFilePath);
+      mUtf8Buffer.setSource( mFileStream.rdbuf() );
 
-      mSourceIterator = boost::spirit::make_default_multi_pass( FileIterator(mFileStream) );
+      if( mCsvSettings.validateUtf8() ){
+        mSourceIterator = const_iterator( boost::spirit::make_default_multi_pass( FileIterator(&mUtf8Buffer) ) );
+      }else{
+        mSourceIterator = const_iterator( boost::spirit::make_default_multi_pass( FileIterator(mFileStream) ) );
+      }
     }
 
     /*! \brief Check if this file reader is open
@@ -164,6 +207,11 @@ namespace Mdt{ namespace PlainText{
     }
 
     /*! \brief Check if this file reader is at end
+     *
+     * If the CSV settings require a UTF-8 source,
+     * this file reader is not at end
+     * when the reading stopped before a invalid sequence,
+     * so that the next read throws a CsvFileReadError.
      *
      * \pre This file reader must be open
      * \sa isOpen()
@@ -172,10 +220,30 @@ namespace Mdt{ namespace PlainText{
     {
       assert( isOpen() );
 
-      return mSourceIterator == sourceIteratorEnd();
+      return (mSourceIterator == sourceIteratorEnd()) && !mUtf8Buffer.invalidSequenceReached();
+    }
+
+    /*! \brief Get the current position in the file
+     *
+     * Once a record has been read,
+     * this is the position of the next record.
+     *
+     * \pre This file reader must be open
+     * \sa isOpen()
+     */
+    SourcePosition position() const noexcept
+    {
+      assert( isOpen() );
+
+      return mSourceIterator.position();
     }
 
     /*! \brief Read a line from the CSV file
+     *
+     * \a rule must be a CSV line rule, for example Grammar::Csv::Qi::CsvFileLine .
+     *
+     * \note The maximum record length of the CSV settings is not enforced here,
+     * consider using readRecord().
      *
      * \exception CsvFileReadError
      * \pre This file reader must be open
@@ -184,24 +252,55 @@ namespace Mdt{ namespace PlainText{
      * \sa atEnd()
      */
     template<typename Record, typename Rule>
-    Record readLine(const Rule & rule)
-    {
-      assert( isOpen() );
-      assert( !atEnd() );
+    Record readLine(const Rule & rule);
 
-      Record record;
-      const auto last = sourceIteratorEnd();
-
-      const bool ok = boost::spirit::qi::parse(mSourceIterator, last, rule, record);
-      if(!ok){
-        const std::string what = "reading file '" + mFilePath + "' failed";
-        throw CsvFileReadError(what);
-      }
+    /*! \brief Read a record from the CSV file
+     *
+     * Parses a record using \a rule ,
+     * which must be a CSV record rule (without the end-of-line),
+     * for example Grammar::Csv::Qi::CsvRecord ,
+     * then the end-of-line that terminates it.
+     *
+     * Unlike readLine(),
+     * the maximum record length of the CSV settings is enforced.
+     *
+     * \exception CsvFileReadError
+     * \pre This file reader must be open
+     * \pre This file reader must not be at end
+     * \sa isOpen()
+     * \sa atEnd()
+     * \sa CsvParserSettings::maximumRecordLength()
+     */
+    template<typename Record, typename Rule>
+    Record readRecord(const Rule & rule);
 
-      return record;
-    }
+    /*! \brief Read all records from the CSV file
+     *
+     * Parses the file record by record using \a rule ,
+     * which must be a CSV record rule (without the end-of-line),
+     * for example Grammar::Csv::Qi::CsvRecord .
+     *
+     * Unlike readAll(),
+     * the maximum record length of the CSV settings is enforced.
+     *
+     * \exception CsvFileReadError
+     * \pre This file reader must be open
+     * \sa isOpen()
+     * \sa CsvParserSettings::maximumRecordLength()
+     */
+    template<typename RecordList, typename Rule>
+    RecordList readAllRecords(const Rule & rule);
 
     /*! \brief Read all lines from the CSV file
+     *
+     * \a rule must be a CSV file rule, for example Grammar::Csv::Qi::CsvFile .
+     *
+     * If a part of the file can not be parsed,
+     * a CsvFileReadError is thrown,
+     * with the position at which the parsing stopped.
+     *
+     * \note The maximum record length of the CSV settings is not enforced here,
+     * consider using readAllRecords().
      *
      * \exception CsvFileReadError
      * \pre This file reader must be open
@@ -210,44 +309,363 @@ namespace Mdt{ namespace PlainText{
      * \sa atEnd()
      */
     template<typename RecordList, typename Rule>
-    RecordList readAll(const Rule & rule)
+    RecordList readAll(const Rule & rule);
+
+    /*! \brief Read all lines from the CSV file, skipping malformed records
+     *
+     * Parses the file record by record using \a rule ,
+     * which must be a CSV record rule (without the end-of-line),
+     * for example Grammar::Csv::Qi::CsvRecord .
+     *
+     * Each time a record can not be parsed,
+     * it is added to \a malformedRecords ,
+     * then the reading continues after the next end-of-line.
+     * Note that if a malformed record contains a protected field
+     * with a end-of-line, the reading continues inside this field.
+     *
+     * If the CSV settings define a maximum record length,
+     * it is enforced and the raw data of malformed records
+     * are truncated to this length.
+     *
+     * \exception CsvFileReadError if the file is not valid UTF-8,
+     *   when required by the CSV settings
+     * \pre This file reader must be open
+     * \sa isOpen()
+     */
+    template<typename RecordList, typename Rule>
+    RecordList readAllSkippingMalformedRecords(const Rule & rule, std::vector<CsvMalformedRecord> & malformedRecords);
+
+    /*! \brief Validate the CSV file
+     *
+     * Parses the file record by record using \a rule ,
+     * which must be a CSV record rule (without the end-of-line),
+     * for example Grammar::Csv::Qi::CsvRecord .
+     *
+     * \a Record is the record attribute,
+     * which must provide a size() method
+     * that returns the count of fields parsed.
+     * Using Impl::CsvFieldCountRecord as \a Record
+     * avoids storing any payload during the validation.
+     *
+     * The validation stops at the first malformed record.
+     * Once done, this reader is at end if the file is valid.
+     *
+     * \exception CsvFileReadError if the file is not valid UTF-8,
+     *   when required by the CSV settings
+     * \pre This file reader must be open
+     * \sa isOpen()
+     */
+    template<typename Record, typename Rule>
+    CsvFileValidationReport validate(const Rule & rule);
+
+    /*! \brief Close this file reader
+     */
+    void close()
     {
-      assert( isOpen() );
-      assert( !atEnd() );
+      mFileStream.close();
+    }
+
+   private:
+
+    /*
+     * Parse a record using rule,
+     * then the end-of-line that terminates it (or the end of the file).
+     * Returns false if one of both fails.
+     *
+     * Like Grammar::Csv::Qi::CsvFile ,
+     * a empty line at the end of the file is accepted.
+     *
+     * If a maximum record length is defined,
+     * rule can not consume more chars than this length.
+     * A longer record then fails because it is not followed by a end-of-line.
+     */
+    template<typename Rule, typename Record>
+    bool parseRecord(const Rule & rule, Record & record)
+    {
+      namespace qi = boost::spirit::qi;
+
+      if( atInvalidUtf8Line() ){
+        return false;
+      }
+      if( !Impl::parseRule(mSourceIterator, recordEnd(), rule, record) ){
+        return false;
+      }
+
+      return qi::parse(mSourceIterator, sourceIteratorEnd(), ( qi::eol >> -(qi::eol >> qi::eoi) ) | qi::eoi);
+    }
+
+    /*
+     * Same as parseRecord(),
+     * but goes back to the beginning of the record if it fails.
+     *
+     * The copy of the source iterator is released before returning,
+     * so that the multi pass iterator can free its buffer
+     * while skipping a malformed record.
+     */
+    template<typename Rule, typename Record>
+    bool parseRecordOrRewind(const Rule & rule, Record & record)
+    {
+      const const_iterator recordBegin = mSourceIterator;
 
-      RecordList table;
+      if( !parseRecord(rule, record) ){
+        mSourceIterator = recordBegin;
+        return false;
+      }
+
+      return true;
+    }
+
+    /*
+     * Skip all chars up to the next end-of-line (or the end of the file)
+     * and the end-of-line itself.
+     * Returns the skipped chars, without the end-of-line.
+     */
+    std::string skipLine()
+    {
+      std::string line;
       const auto last = sourceIteratorEnd();
+      const auto maxLength = static_cast<std::string::size_type>( mCsvSettings.maximumRecordLength() );
 
-      const bool ok = boost::spirit::qi::parse(mSourceIterator, last, rule, table);
-      if(!ok){
-        const std::string what = "reading file '" + mFilePath + "' failed";
-        throw CsvFileReadError(what);
+      while( (mSourceIterator != last) && (*mSourceIterator != '\n') && (*mSourceIterator != '\r') ){
+        if( (maxLength == 0) || (line.size() < maxLength) ){
+          line.push_back(*mSourceIterator);
+        }
+        ++mSourceIterator;
+      }
+      if( (mSourceIterator != last) && (*mSourceIterator == '\r') ){
+        ++mSourceIterator;
+      }
+      if( (mSourceIterator != last) && (*mSourceIterator == '\n') ){
+        ++mSourceIterator;
       }
 
-      return table;
+      return line;
     }
 
-    /*! \brief Close this file reader
+    /*
+     * Check if the input ended at the line
+     * that contains the first invalid UTF-8 sequence.
+     * A rule that accepts a empty record must not be used then.
      */
-    void close()
+    bool atInvalidUtf8Line() const
     {
-      mFileStream.close();
+      return (mSourceIterator == sourceIteratorEnd()) && mUtf8Buffer.invalidSequenceReached();
     }
 
-   private:
+    CsvFileReadError readError() const
+    {
+      if( mUtf8Buffer.invalidSequenceReached() ){
+        return invalidUtf8Error();
+      }
+
+      const SourcePosition pos = mSourceIterator.position();
+      const std::string what = "reading file '" + mFilePath + "' failed at line " + std::to_string( pos.lineNumber() )
+                             + ", column " + std::to_string( pos.columnNumber() )
+                             + " (offset " + std::to_string( pos.offset() ) + ")";
+
+      return CsvFileReadError(what, pos);
+    }
+
+    /*
+     * The input ends at the beginning of the line
+     * that contains the first invalid sequence,
+     * which gives the line number of this sequence.
+     */
+    CsvFileReadError invalidUtf8Error() const
+    {
+      const auto last = sourceIteratorEnd();
+      const_iterator it = mSourceIterator;
+      while(it != last){
+        ++it;
+      }
+
+      const int64_t offset = mUtf8Buffer.errorOffset();
+      const SourcePosition lineBegin = it.position();
+      const SourcePosition pos( offset, lineBegin.lineNumber(), offset - lineBegin.offset() + 1 );
+      const std::string what = "file '" + mFilePath + "' is not valid UTF-8 at line " + std::to_string( pos.lineNumber() )
+                             + ", column " + std::to_string( pos.columnNumber() )
+                             + " (offset " + std::to_string( pos.offset() ) + ")";
+
+      return CsvFileReadError(what, pos);
+    }
+
+    /*
+     * Get the end iterator for the record that begins at the current position
+     */
+    const_iterator recordEnd() const
+    {
+      const int64_t maxLength = mCsvSettings.maximumRecordLength();
+
+      if(maxLength > 0){
+        return const_iterator::boundedEnd( sourceIteratorEnd().base(), mSourceIterator.position().offset() + maxLength );
+      }
+
+      return sourceIteratorEnd();
+    }
 
     static
     const_iterator sourceIteratorEnd() noexcept
     {
-      return boost::spirit::make_default_multi_pass( FileIterator() );
+      return const_iterator( boost::spirit::make_default_multi_pass( FileIterator() ) );
     }
 
     const_iterator mSourceIterator;
     std::ifstream mFileStream;
+    Impl::Utf8ValidatingStreamBuffer mUtf8Buffer;
     std::string mFilePath;
     CsvParserSettings mCsvSettings;
   };
 
+  /*
+   * The read methods are not defined inline,
+   * so that the explicit instantiation declarations below
+   * also prevent optimizing compilers from instantiating them.
+   */
+
+  template<typename Record, typename Rule>
+  Record CsvFileReaderTemplate::readLine(const Rule & rule)
+  {
+    assert( isOpen() );
+    assert( !atEnd() );
+
+    Record record;
+    const auto last = sourceIteratorEnd();
+
+    const bool ok = !atInvalidUtf8Line() && Impl::parseRule(mSourceIterator, last, rule, record);
+    if(!ok){
+      throw readError();
+    }
+
+    return record;
+  }
+
+  template<typename Record, typename Rule>
+  Record CsvFileReaderTemplate::readRecord(const Rule & rule)
+  {
+    assert( isOpen() );
+    assert( !atEnd() );
+
+    Record record;
+    if( !parseRecord(rule, record) ){
+      throw readError();
+    }
+
+    return record;
+  }
+
+  template<typename RecordList, typename Rule>
+  RecordList CsvFileReaderTemplate::readAllRecords(const Rule & rule)
+  {
+    assert( isOpen() );
+
+    using Record = typename RecordList::value_type;
+
+    RecordList table;
+
+    while( !atEnd() ){
+      Record record;
+      if( !parseRecord(rule, record) ){
+        throw readError();
+      }
+      table.push_back( std::move(record) );
+    }
+
+    return table;
+  }
+
+  template<typename RecordList, typename Rule>
+  RecordList CsvFileReaderTemplate::readAll(const Rule & rule)
+  {
+    assert( isOpen() );
+    assert( !atEnd() );
+
+    RecordList table;
+    const auto last = sourceIteratorEnd();
+
+    const bool ok = Impl::parseRule(mSourceIterator, last, rule, table);
+    if( !ok || !atEnd() ){
+      throw readError();
+    }
+
+    return table;
+  }
+
+  template<typename RecordList, typename Rule>
+  RecordList CsvFileReaderTemplate::readAllSkippingMalformedRecords(const Rule & rule, std::vector<CsvMalformedRecord> & malformedRecords)
+  {
+    assert( isOpen() );
+
+    using Record = typename RecordList::value_type;
+
+    RecordList table;
+
+    while( !atEnd() ){
+      const SourcePosition recordPosition = mSourceIterator.position();
+      Record record;
+      if( parseRecordOrRewind(rule, record) ){
+        table.push_back( std::move(record) );
+      }else{
+        if( mUtf8Buffer.invalidSequenceReached() ){
+          throw readError();
+        }
+        malformedRecords.emplace_back( recordPosition, skipLine() );
+      }
+    }
+
+    return table;
+  }
+
+  template<typename Record, typename Rule>
+  CsvFileValidationReport CsvFileReaderTemplate::validate(const Rule & rule)
+  {
+    assert( isOpen() );
+
+    CsvFileValidationReport report;
+
+    while( !atEnd() ){
+      const SourcePosition recordPosition = mSourceIterator.position();
+      Record record;
+      if( !parseRecord(rule, record) ){
+        if( mUtf8Buffer.invalidSequenceReached() ){
+          throw readError();
+        }
+        report.addMalformedRecord(recordPosition);
+        return report;
+      }
+      report.addRecord( record.size() );
+    }
+
+    return report;
+  }
+
+  namespace Impl{
+
+    using CsvFileReaderRecord = std::vector<std::string>;
+    using CsvFileReaderTable = std::vector<CsvFileReaderRecord>;
+    using CsvFileReaderQiRecordRule = Grammar::Csv::Qi::CsvRecord<CsvFileSourceIterator, CsvFileReaderRecord>;
+    using CsvFileReaderQiFileRule = Grammar::Csv::Qi::CsvFile<CsvFileSourceIterator, CsvFileReaderTable>;
+    using CsvFileReaderQiFieldCountRule = Grammar::Csv::Qi::CsvRecord<CsvFileSourceIterator, CsvFieldCountRecord>;
+    using CsvFileReaderX3RecordRule = Grammar::Csv::X3::CsvRecord<CsvFileReaderRecord>;
+    using CsvFileReaderX3FileRule = Grammar::Csv::X3::CsvFile<CsvFileReaderTable>;
+    using CsvFileReaderX3FieldCountRule = Grammar::Csv::X3::CsvRecord<CsvFieldCountRecord>;
+
+  } // namespace Impl{
+
+  /*
+   * Instantiated once in the library for the most common records and rules,
+   * so that they are not compiled again by each user.
+   */
+  extern template Impl::CsvFileReaderRecord CsvFileReaderTemplate::readRecord<Impl::CsvFileReaderRecord>(const Impl::CsvFileReaderQiRecordRule &);
+  extern template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderQiRecordRule &);
+  extern template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAll<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderQiFileRule &);
+  extern template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllSkippingMalformedRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderQiRecordRule &, std::vector<CsvMalformedRecord> &);
+  extern template CsvFileValidationReport CsvFileReaderTemplate::validate<Impl::CsvFieldCountRecord>(const Impl::CsvFileReaderQiFieldCountRule &);
+  extern template Impl::CsvFileReaderRecord CsvFileReaderTemplate::readRecord<Impl::CsvFileReaderRecord>(const Impl::CsvFileReaderX3RecordRule &);
+  extern template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderX3RecordRule &);
+  extern template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAll<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderX3FileRule &);
+  extern template Impl::CsvFileReaderTable CsvFileReaderTemplate::readAllSkippingMalformedRecords<Impl::CsvFileReaderTable>(const Impl::CsvFileReaderX3RecordRule &, std::vector<CsvMalformedRecord> &);
+  extern template CsvFileValidationReport CsvFileReaderTemplate::validate<Impl::CsvFieldCountRecord>(const Impl::CsvFileReaderX3FieldCountRule &);
+
 }} // namespace Mdt{ namespace PlainText{
 
 #endif // #ifndef MDT_PLAIN_TEXT_CSV_FILE_READER_TEMPLATE_H
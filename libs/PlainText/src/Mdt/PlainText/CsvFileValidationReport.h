@@ -0,0 +1,152 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_CSV_FILE_VALIDATION_REPORT_H
+#define MDT_PLAIN_TEXT_CSV_FILE_VALIDATION_REPORT_H
+
+#include "SourcePosition.h"
+#include "mdt_plaintext_export.h"
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief Report returned by a validation pass over a CSV file
+   *
+   * A validation pass parses a CSV file record by record,
+   * without storing any field payload.
+   * The memory it uses does not depend on the size of the file.
+   *
+   * A record is well formed if it conforms to the CSV grammar
+   * and is followed by a end-of-line or the end of the file.
+   *
+   * Record indexes are 0 based:
+   * the first record of the file (typically the header) has index 0.
+ *
+ * The position of the first malformed record is also reported,
+ * so that it can be located without scanning the file again.
+   *
+   * \sa CsvFileReader::validate()
+   */
+  class MDT_PLAINTEXT_EXPORT CsvFileValidationReport
+  {
+   public:
+
+    /*! \brief Check if the validated file is valid
+     *
+     * Returns true if each record is well formed
+     * and all records have the same count of columns.
+     */
+    constexpr bool isValid() const noexcept
+    {
+      return !hasMalformedRecord() && hasConsistentColumnCount();
+    }
+
+    /*! \brief Get the count of well formed records
+     */
+    constexpr int64_t recordCount() const noexcept
+    {
+      return mRecordCount;
+    }
+
+    /*! \brief Get the count of columns of the first record
+     *
+     * Returns 0 if no well formed record was found.
+     */
+    constexpr int columnCount() const noexcept
+    {
+      return mColumnCount;
+    }
+
+    /*! \brief Check if all well formed records have the same count of columns
+     */
+    constexpr bool hasConsistentColumnCount() const noexcept
+    {
+      return mFirstInconsistentRecordIndex < 0;
+    }
+
+    /*! \brief Get the index of the first record that has not the same count of columns than the first record
+     *
+     * Returns -1 if all well formed records have the same count of columns.
+     */
+    constexpr int64_t firstInconsistentRecordIndex() const noexcept
+    {
+      return mFirstInconsistentRecordIndex;
+    }
+
+    /*! \brief Check if a malformed record was found
+     */
+    constexpr bool hasMalformedRecord() const noexcept
+    {
+      return mFirstMalformedRecordIndex >= 0;
+    }
+
+    /*! \brief Get the index of the first malformed record
+     *
+     * Returns -1 if no malformed record was found.
+     */
+    constexpr int64_t firstMalformedRecordIndex() const noexcept
+    {
+      return mFirstMalformedRecordIndex;
+    }
+
+    /*! \brief Get the position in the file at which the first malformed record starts
+     *
+     * \pre A malformed record must have been found
+     * \sa hasMalformedRecord()
+     */
+    constexpr const SourcePosition & firstMalformedRecordPosition() const noexcept
+    {
+      assert( hasMalformedRecord() );
+
+      return mFirstMalformedRecordPosition;
+    }
+
+    /*! \internal Add a well formed record having \a columnCount columns
+     *
+     * \pre \a columnCount must be >= 1
+     */
+    constexpr void addRecord(int columnCount) noexcept
+    {
+      assert( columnCount >= 1 );
+
+      if(mColumnCount == 0){
+        mColumnCount = columnCount;
+      }else if( (columnCount != mColumnCount) && hasConsistentColumnCount() ){
+        mFirstInconsistentRecordIndex = currentRecordIndex();
+      }
+      ++mRecordCount;
+    }
+
+    /*! \internal Tell that the current record, which starts at \a position , is malformed
+     */
+    constexpr void addMalformedRecord(const SourcePosition & position) noexcept
+    {
+      if( !hasMalformedRecord() ){
+        mFirstMalformedRecordIndex = currentRecordIndex();
+        mFirstMalformedRecordPosition = position;
+      }
+      ++mMalformedRecordCount;
+    }
+
+   private:
+
+    constexpr int64_t currentRecordIndex() const noexcept
+    {
+      return mRecordCount + mMalformedRecordCount;
+    }
+
+    int64_t mRecordCount = 0;
+    int64_t mMalformedRecordCount = 0;
+    int64_t mFirstInconsistentRecordIndex = -1;
+    int64_t mFirstMalformedRecordIndex = -1;
+    SourcePosition mFirstMalformedRecordPosition;
+    int mColumnCount = 0;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_CSV_FILE_VALIDATION_REPORT_H
@@ -6,12 +6,28 @@
  */
 #include "CsvFileWriter.h"
 #include "CsvFileWriterTemplate.h"
-#include "Mdt/PlainText/Grammar/Csv/Karma/CsvRecord.h"
-#include "Mdt/PlainText/Grammar/Csv/Karma/CsvFile.h"
+#include "Mdt/PlainText/Impl/CsvSinkRecordWriter.h"
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{
 
+/*
+ * The records are std::vector<std::string> or std::vector<CsvValue>,
+ * so they are written directly to the file sink,
+ * which is much faster than going through the Karma CsvRecord rule.
+ * The record writer is built once in open(), then reused by each write call,
+ * which is possible because the settings cannot change while the writer is open.
+ */
+struct CsvFileWriter::Generators
+{
+  explicit Generators(const CsvGeneratorSettings & settings) noexcept
+   : recordWriter(settings)
+  {
+  }
+
+  Impl::CsvSinkRecordWriter recordWriter;
+};
+
 CsvFileWriter::CsvFileWriter()
  : mImpl( std::make_unique<CsvFileWriterTemplate>() )
 {
@@ -59,11 +75,68 @@ FileWriteOpenMode CsvFileWriter::openMode() const noexcept
   return mImpl->openMode();
 }
 
+void CsvFileWriter::setBufferSize(std::size_t size) noexcept
+{
+  assert( size > 0 );
+  assert( !isOpen() );
+
+  mImpl->setBufferSize(size);
+}
+
+std::size_t CsvFileWriter::bufferSize() const noexcept
+{
+  return mImpl->bufferSize();
+}
+
+void CsvFileWriter::setPreallocatedSize(int64_t size) noexcept
+{
+  assert( size >= 0 );
+  assert( !isOpen() );
+
+  mImpl->setPreallocatedSize(size);
+}
+
+int64_t CsvFileWriter::preallocatedSize() const noexcept
+{
+  return mImpl->preallocatedSize();
+}
+
+void CsvFileWriter::setThreadCount(int count) noexcept
+{
+  assert( count >= 1 );
+  assert( !isOpen() );
+
+  mImpl->setThreadCount(count);
+}
+
+int CsvFileWriter::threadCount() const noexcept
+{
+  return mImpl->threadCount();
+}
+
+void CsvFileWriter::setDurabilityPolicy(const FileDurabilityPolicy & policy) noexcept
+{
+  assert( !isOpen() );
+
+  mImpl->setDurabilityPolicy(policy);
+}
+
+const FileDurabilityPolicy & CsvFileWriter::durabilityPolicy() const noexcept
+{
+  return mImpl->durabilityPolicy();
+}
+
+std::string CsvFileWriter::temporaryFilePath() const
+{
+  return mImpl->temporaryFilePath();
+}
+
 void CsvFileWriter::open()
 {
   assert( !filePath().empty() );
 
   mImpl->open();
+  mGenerators = std::make_unique<Generators>( csvSettings() );
 }
 
 bool CsvFileWriter::isOpen() const
@@ -74,21 +147,45 @@ bool CsvFileWriter::isOpen() const
 void CsvFileWriter::writeLine(const std::vector<std::string> & record)
 {
   assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
 
-  using DestinationIterator = CsvFileWriterTemplate::iterator;
-
-  Grammar::Csv::Karma::CsvRecord< DestinationIterator, std::vector<std::string> > rule( csvSettings() );
-  mImpl->writeLine(record, rule);
+  mImpl->writeLineToSink(record, mGenerators->recordWriter);
 }
 
 void CsvFileWriter::writeTable(const std::vector< std::vector<std::string> > & table)
 {
   assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
 
-  using DestinationIterator = CsvFileWriterTemplate::iterator;
+  mImpl->writeTableToSink(table, mGenerators->recordWriter);
+}
+
+void CsvFileWriter::writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                               std::vector< std::vector<std::string> >::const_iterator last)
+{
+  assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
+
+  if(first == last){
+    return;
+  }
+  mImpl->writeTableToSink(first, last, mGenerators->recordWriter);
+}
+
+void CsvFileWriter::writeTypedLine(const std::vector<CsvValue> & record)
+{
+  assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
+
+  mImpl->writeLineToSink(record, mGenerators->recordWriter);
+}
+
+void CsvFileWriter::writeTypedTable(const std::vector< std::vector<CsvValue> > & table)
+{
+  assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
 
-  Grammar::Csv::Karma::CsvFile< DestinationIterator, std::vector< std::vector<std::string> > > rule( csvSettings() );
-  mImpl->writeTable(table, rule);
+  mImpl->writeTableToSink(table, mGenerators->recordWriter);
 }
 
 void CsvFileWriter::close()
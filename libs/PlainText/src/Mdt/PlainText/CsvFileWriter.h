@@ -12,7 +12,11 @@
 #include "EndOfLine.h"
 #include "CsvGeneratorSettings.h"
 #include "FileWriteOpenMode.h"
+#include "FileDurabilityPolicy.h"
+#include "CsvValue.h"
 #include "mdt_plaintext_export.h"
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -88,6 +92,85 @@ namespace Mdt{ namespace PlainText{
      */
     FileWriteOpenMode openMode() const noexcept;
 
+    /*! \brief Set the size of the write buffer
+     *
+     * A larger buffer reduces the count of system calls
+     * when writing large files.
+     * The default is BufferedFileSink::defaultBufferSize
+     *
+     * \pre \a size must be > 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setBufferSize(std::size_t size) noexcept;
+
+    /*! \brief Get the size of the write buffer
+     */
+    std::size_t bufferSize() const noexcept;
+
+    /*! \brief Set the expected count of bytes that will be written
+     *
+     * This is a hint that lets the file system
+     * reserve the space of a large export on open().
+     * The default is 0, which means no reservation.
+     *
+     * \pre \a size must be >= 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setPreallocatedSize(int64_t size) noexcept;
+
+    /*! \brief Get the expected count of bytes that will be written
+     */
+    int64_t preallocatedSize() const noexcept;
+
+    /*! \brief Set the count of threads used to write tables
+     *
+     * With a count > 1, large tables given to writeTable(), writeLines()
+     * and writeTypedTable() are split into chunks of records,
+     * which are generated by worker threads,
+     * then written to the file in order.
+     * The result is the same as with a single thread.
+     *
+     * A typical value is std::thread::hardware_concurrency().
+     * writeLine() and writeTypedLine() always use the calling thread.
+     *
+     * The default is 1
+     *
+     * \pre \a count must be >= 1
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setThreadCount(int count) noexcept;
+
+    /*! \brief Get the count of threads used to write tables
+     */
+    int threadCount() const noexcept;
+
+    /*! \brief Set the durability policy
+     *
+     * Tells what reached the storage when close() returns,
+     * as described in CsvFileWriterTemplate::setDurabilityPolicy().
+     *
+     * The default is FileDurability::None
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setDurabilityPolicy(const FileDurabilityPolicy & policy) noexcept;
+
+    /*! \brief Get the durability policy
+     */
+    const FileDurabilityPolicy & durabilityPolicy() const noexcept;
+
+    /*! \brief Get the path of the temporary file
+     *
+     * Only valid while this writer is open
+     * with FileDurability::AtomicReplace ,
+     * as described in CsvFileWriterTemplate::temporaryFilePath().
+     */
+    std::string temporaryFilePath() const;
+
     /*! \brief Open this CSV file writer
      *
      * If this file writer is allready open,
@@ -95,6 +178,9 @@ namespace Mdt{ namespace PlainText{
      *
      * Open the file set with setFilePath().
      *
+     * The generators used by writeLine() and writeTable()
+     * are built here, once for the current CSV settings.
+     *
      * \exception FileOpenError
      * \pre A path to a file must have been set
      * \sa setFilePath()
@@ -124,13 +210,81 @@ namespace Mdt{ namespace PlainText{
      */
     void writeTable(const std::vector< std::vector<std::string> > & table);
 
+    /*! \brief Write the records in the range [\a first, \a last) to this CSV file
+     *
+     * This is the batch version of writeLine():
+     * the records are written in one go, like with writeTable(),
+     * but the whole table does not have to be in memory.
+     * For example, a large export can be done by filling
+     * and writing the same batch of records many times:
+     * \code
+     * std::vector< std::vector<std::string> > batch;
+     *
+     * while( fetchRecords(batch, 1000) ){
+     *   csvWriter.writeLines( batch.cbegin(), batch.cend() );
+     * }
+     * \endcode
+     *
+     * Like writeTable(), empty records are skipped,
+     * but at least one record must be written.
+     * If the range is empty, nothing is written.
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                    std::vector< std::vector<std::string> >::const_iterator last);
+
+    /*! \brief Write a line of typed values to this CSV file
+     *
+     * Numbers and booleans are formatted directly to the file buffer,
+     * without any intermediate string:
+     * - Integers are written in decimal
+     * - Real numbers are written as described in CsvGeneratorSettings::realPrecision()
+     *   and CsvGeneratorSettings::decimalSeparator()
+     * - Booleans are written as \c true or \c false
+     *
+     * They are not checked for the field separator or the field protection,
+     * and only CsvQuotingPolicy::Always protects them,
+     * unless they can contain one of these chars,
+     * for example a comma used as decimal separator and as field separator.
+     * Strings are written like with writeLine().
+     *
+     * \code
+     * csvWriter.writeTypedLine({"Name", 25, 1.75, true});
+     * \endcode
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeTypedLine(const std::vector<CsvValue> & record);
+
+    /*! \brief Write a table of typed values to this CSV file
+     *
+     * Each record is written as described in writeTypedLine()
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeTypedTable(const std::vector< std::vector<CsvValue> > & table);
+
     /*! \brief Close this file writer
+     *
+     * Pending data are written to the file before closing it.
+     *
+     * \exception CsvFileWriteError
      */
     void close();
 
    private:
 
+    struct Generators;
+
     std::unique_ptr<CsvFileWriterTemplate> mImpl;
+    std::unique_ptr<Generators> mGenerators;
   };
 
 }} // namespace Mdt{ namespace PlainText{
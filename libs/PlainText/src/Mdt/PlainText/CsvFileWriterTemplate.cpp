@@ -5,3 +5,9 @@
  * https://www.boost.org/LICENSE_1_0.txt)
  */
 #include "CsvFileWriterTemplate.h"
+
+namespace Mdt{ namespace PlainText{
+
+constexpr std::ptrdiff_t CsvFileWriterTemplate::parallelChunkRecordCount;
+
+}} // namespace Mdt{ namespace PlainText{
@@ -12,12 +12,23 @@
 #include "EndOfLine.h"
 #include "CsvGeneratorSettings.h"
 #include "FileWriteOpenMode.h"
-#include "OpenFstream.h"
+#include "FileDurabilityPolicy.h"
+#include "BufferedFileSink.h"
+#include "Mdt/PlainText/Impl/StringSink.h"
+#include "Mdt/PlainText/Impl/GroupCommit.h"
+#include "Mdt/PlainText/Impl/FileSync.h"
 #include "mdt_plaintext_export.h"
 #include <boost/spirit/include/karma.hpp>
-#include <string>
-#include <fstream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <future>
 #include <iterator>
+#include <string>
+#include <utility>
+#include <cassert>
 
 namespace Mdt{ namespace PlainText{
 
@@ -62,6 +73,16 @@ namespace Mdt{ namespace PlainText{
    * }
    * \endcode
    *
+   * Building a rule is expensive,
+   * so a real writer should build it once in open()
+   * and reuse it for each line, like CsvFileWriter does.
+   *
+   * The file is written through a BufferedFileSink.
+   *
+   * What reached the storage when close() returns
+   * depends on the durability policy.
+   *
+   * \sa setDurabilityPolicy()
    * \sa CsvFileWriter
    */
   class MDT_PLAINTEXT_EXPORT CsvFileWriterTemplate
@@ -70,17 +91,31 @@ namespace Mdt{ namespace PlainText{
 
     /*! \brief STL iterator
      */
-    using iterator = std::ostreambuf_iterator<char>;
+    using iterator = BufferedFileSink::iterator;
 
     /*! \brief Construct a CSV file writer
      */
     CsvFileWriterTemplate() = default;
 
     /*! \brief Cleanup this CSV file writer
+     *
+     * Pending data are written to the file,
+     * but errors are ignored.
+     * Call close() explicitly to get them reported.
+     *
+     * With FileDurability::AtomicReplace ,
+     * the file is not replaced: the temporary file is removed.
      */
-    ~CsvFileWriterTemplate()
+    ~CsvFileWriterTemplate() noexcept
     {
-      close();
+      try{
+        if( isOpen() && (mDurabilityPolicy.durability() == FileDurability::AtomicReplace) ){
+          discardTemporaryFile();
+        }else{
+          close();
+        }
+      }catch(...){
+      }
     }
 
     CsvFileWriterTemplate(const CsvFileWriterTemplate &) = delete;
@@ -153,12 +188,147 @@ namespace Mdt{ namespace PlainText{
       return mOpenMode;
     }
 
+    /*! \brief Set the size of the write buffer
+     *
+     * The default is BufferedFileSink::defaultBufferSize
+     *
+     * \pre \a size must be > 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setBufferSize(std::size_t size) noexcept
+    {
+      assert( size > 0 );
+      assert( !isOpen() );
+
+      mFileSink.setBufferSize(size);
+    }
+
+    /*! \brief Get the size of the write buffer
+     */
+    std::size_t bufferSize() const noexcept
+    {
+      return mFileSink.bufferSize();
+    }
+
+    /*! \brief Set the expected count of bytes that will be written
+     *
+     * \pre \a size must be >= 0
+     * \pre This file writer must not be open
+     * \sa BufferedFileSink::setPreallocatedSize()
+     * \sa isOpen()
+     */
+    void setPreallocatedSize(int64_t size) noexcept
+    {
+      assert( size >= 0 );
+      assert( !isOpen() );
+
+      mFileSink.setPreallocatedSize(size);
+    }
+
+    /*! \brief Get the expected count of bytes that will be written
+     */
+    int64_t preallocatedSize() const noexcept
+    {
+      return mFileSink.preallocatedSize();
+    }
+
+    /*! \brief Set the durability policy
+     *
+     * - FileDurability::None : close() writes the buffer to the file,
+     *   and lets the operating system sync it later.
+     * - FileDurability::SyncOnClose : close() syncs the file to the storage.
+     * - FileDurability::GroupCommit : the file is synced by a background thread,
+     *   as described in FileDurabilityPolicy::setGroupCommitRecordCount()
+     *   and FileDurabilityPolicy::setGroupCommitInterval().
+     *   The writer does not wait for the storage,
+     *   except in close(), which syncs the last records.
+     * - FileDurability::AtomicReplace : data are written to a temporary file,
+     *   created by open() in the same directory,
+     *   with a unique name made of the file path and a random suffix.
+     *   See temporaryFilePath().
+     *   close() syncs it, then renames it to the file path.
+     *   The open mode is ignored, since the whole file is replaced.
+     *   If this writer is destroyed without close(),
+     *   the file is left unchanged.
+     *
+     * The default is FileDurability::None
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setDurabilityPolicy(const FileDurabilityPolicy & policy) noexcept
+    {
+      assert( !isOpen() );
+
+      mDurabilityPolicy = policy;
+    }
+
+    /*! \brief Get the durability policy
+     */
+    const FileDurabilityPolicy & durabilityPolicy() const noexcept
+    {
+      return mDurabilityPolicy;
+    }
+
+    /*! \brief Get the path of the temporary file
+     *
+     * Used with FileDurability::AtomicReplace .
+     * The temporary file is created with a unique name by open(),
+     * so the returned path is only valid while this writer is open.
+     * Otherwise, a empty string is returned.
+     *
+     * \sa setDurabilityPolicy()
+     */
+    std::string temporaryFilePath() const
+    {
+      if( !isOpen() || (mDurabilityPolicy.durability() != FileDurability::AtomicReplace) ){
+        return std::string();
+      }
+
+      return mFileSink.path();
+    }
+
+    /*! \brief Set the count of threads used to write tables
+     *
+     * With a count > 1, writeTableToSink() splits large tables
+     * into chunks of parallelChunkRecordCount records.
+     * The chunks are generated in memory by worker threads,
+     * then written to the file in order,
+     * so the result is the same as with a single thread.
+     *
+     * The default is 1, which means that tables are written
+     * in the calling thread, without any intermediate buffer.
+     *
+     * \pre \a count must be >= 1
+     */
+    void setThreadCount(int count) noexcept
+    {
+      assert( count >= 1 );
+
+      mThreadCount = count;
+    }
+
+    /*! \brief Get the count of threads used to write tables
+     */
+    int threadCount() const noexcept
+    {
+      return mThreadCount;
+    }
+
+    /*! \brief Count of records generated by a worker thread at once
+     *
+     * \sa setThreadCount()
+     */
+    static constexpr std::ptrdiff_t parallelChunkRecordCount = 4096;
+
     /*! \brief Open this CSV file writer
      *
      * If this file writer is allready open,
      * it will be closed first().
      *
-     * Open the file set with setFilePath().
+     * Open the file set with setFilePath(),
+     * or its temporary file with FileDurability::AtomicReplace .
      *
      * \exception FileOpenError
      * \pre A path to a file must have been set
@@ -169,7 +339,22 @@ namespace Mdt{ namespace PlainText{
     {
       assert( !filePath().empty() );
 
-      openOfstream(mFileStream, mFilePath, mOpenMode);
+      close();
+
+      try{
+        if( mDurabilityPolicy.durability() == FileDurability::AtomicReplace ){
+          mFileSink.openTemporaryFile(mFilePath);
+        }else{
+          mFileSink.open(mFilePath, mOpenMode);
+        }
+      }catch(const FileWriteError & error){
+        throw CsvFileWriteError( error.what() );
+      }
+      if( mDurabilityPolicy.durability() == FileDurability::GroupCommit ){
+        mGroupCommit.start(mDurabilityPolicy, [this](){
+          mFileSink.syncWrittenData();
+        });
+      }
     }
 
     /*! \brief Check if this file writer is open
@@ -178,7 +363,7 @@ namespace Mdt{ namespace PlainText{
      */
     bool isOpen() const
     {
-      return mFileStream.is_open();
+      return mFileSink.isOpen();
     }
 
     /*! \brief Write a line to this CSV file
@@ -192,12 +377,18 @@ namespace Mdt{ namespace PlainText{
     {
       assert( isOpen() );
 
-      iterator it(mFileStream);
-      const bool ok = boost::spirit::karma::generate(it, rule, record);
+      iterator it = mFileSink.outputIterator();
+      bool ok;
+      try{
+        ok = boost::spirit::karma::generate(it, rule, record);
+      }catch(const FileWriteError & error){
+        throw CsvFileWriteError( error.what() );
+      }
       if(!ok){
         const std::string what = "writing a line in file '" + mFilePath + "' failed";
         throw CsvFileWriteError(what);
       }
+      commitIfDue(1);
     }
 
     /*! \brief Write a table to this CSV file
@@ -211,8 +402,100 @@ namespace Mdt{ namespace PlainText{
     {
       assert( isOpen() );
 
-      iterator it(mFileStream);
-      const bool ok = boost::spirit::karma::generate(it, rule, table);
+      iterator it = mFileSink.outputIterator();
+      bool ok;
+      try{
+        ok = boost::spirit::karma::generate(it, rule, table);
+      }catch(const FileWriteError & error){
+        throw CsvFileWriteError( error.what() );
+      }
+      if(!ok){
+        const std::string what = "writing table in file '" + mFilePath + "' failed";
+        throw CsvFileWriteError(what);
+      }
+      commitIfDue( static_cast<int64_t>( table.size() ) );
+    }
+
+    /*! \brief Write a line to this CSV file using a record writer
+     *
+     * Unlike writeLine(), no Karma rule is involved:
+     * \a recordWriter writes \a record directly to the file sink.
+     * It must be callable like:
+     * \code
+     * bool recordWriter(const Record & record, BufferedFileSink & sink);
+     * \endcode
+     * and return false if \a record cannot be written.
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    template<typename Record, typename RecordWriter>
+    void writeLineToSink(const Record & record, const RecordWriter & recordWriter)
+    {
+      assert( isOpen() );
+
+      bool ok;
+      try{
+        ok = recordWriter(record, mFileSink);
+      }catch(const FileWriteError & error){
+        throw CsvFileWriteError( error.what() );
+      }
+      if(!ok){
+        const std::string what = "writing a line in file '" + mFilePath + "' failed";
+        throw CsvFileWriteError(what);
+      }
+      commitIfDue(1);
+    }
+
+    /*! \brief Write a table to this CSV file using a record writer
+     *
+     * Each record of \a table is written with \a recordWriter ,
+     * as described in writeLineToSink().
+     * Like the Karma CsvFile rule,
+     * the records that cannot be written are skipped,
+     * but at least one record must be written.
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    template<typename Table, typename RecordWriter>
+    void writeTableToSink(const Table & table, const RecordWriter & recordWriter)
+    {
+      writeTableToSink(table.begin(), table.end(), recordWriter);
+    }
+
+    /*! \brief Write the records in the range [\a first, \a last) to this CSV file using a record writer
+     *
+     * The records are written like with writeTableToSink(const Table &, const RecordWriter &),
+     * but only this part of a table has to be in memory.
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    template<typename InputIterator, typename RecordWriter>
+    void writeTableToSink(InputIterator first, InputIterator last, const RecordWriter & recordWriter)
+    {
+      assert( isOpen() );
+
+      if( (mThreadCount > 1) && (std::distance(first, last) > parallelChunkRecordCount) ){
+        writeTableToSinkParallel(first, last, recordWriter);
+        return;
+      }
+
+      bool ok = false;
+      try{
+        for(; first != last; ++first){
+          if( recordWriter(*first, mFileSink) ){
+            ok = true;
+            commitIfDue(1);
+          }
+        }
+      }catch(const FileWriteError & error){
+        throw CsvFileWriteError( error.what() );
+      }
       if(!ok){
         const std::string what = "writing table in file '" + mFilePath + "' failed";
         throw CsvFileWriteError(what);
@@ -220,18 +503,191 @@ namespace Mdt{ namespace PlainText{
     }
 
     /*! \brief Close this file writer
+     *
+     * Pending data are written to the file before closing it.
+     * Then, the durability policy is applied.
+     *
+     * \exception CsvFileWriteError
+     * \sa setDurabilityPolicy()
      */
     void close()
     {
-      mFileStream.close();
+      if( !isOpen() ){
+        return;
+      }
+
+      try{
+        switch( mDurabilityPolicy.durability() ){
+          case FileDurability::None:
+            mFileSink.close();
+            break;
+          case FileDurability::SyncOnClose:
+            syncAndCloseFile();
+            break;
+          case FileDurability::GroupCommit:
+            stopGroupCommitAndCloseFile();
+            break;
+          case FileDurability::AtomicReplace:
+            replaceFileWithTemporaryFile();
+            break;
+        }
+      }catch(const FileWriteError & error){
+        throw CsvFileWriteError( error.what() );
+      }
     }
 
    private:
 
+    /*
+     * The buffer is written to the file before the commit,
+     * so that the background thread syncs all records written so far
+     */
+    void commitIfDue(int64_t recordCount)
+    {
+      if( !mGroupCommit.isStarted() ){
+        return;
+      }
+      if( mGroupCommit.recordsWritten(recordCount) ){
+        try{
+          mFileSink.flush();
+          mGroupCommit.commit();
+        }catch(const FileWriteError & error){
+          throw CsvFileWriteError( error.what() );
+        }
+      }
+    }
+
+    /*
+     * The file is closed even if syncing failed
+     */
+    void syncAndCloseFile()
+    {
+      try{
+        mFileSink.sync();
+      }catch(...){
+        try{
+          mFileSink.close();
+        }catch(...){
+        }
+        throw;
+      }
+      mFileSink.close();
+    }
+
+    void stopGroupCommitAndCloseFile()
+    {
+      std::string error;
+      try{
+        mGroupCommit.stop();
+      }catch(const FileWriteError & groupCommitError){
+        error = groupCommitError.what();
+      }
+      syncAndCloseFile();
+      if( !error.empty() ){
+        throw FileWriteError(error);
+      }
+    }
+
+    /*
+     * If anything fails, the file is left unchanged
+     */
+    void replaceFileWithTemporaryFile()
+    {
+      const std::string temporaryPath = mFileSink.path();
+      try{
+        syncAndCloseFile();
+        Impl::replaceFile(temporaryPath, mFilePath);
+      }catch(...){
+        std::remove( temporaryPath.c_str() );
+        throw;
+      }
+    }
+
+    void discardTemporaryFile()
+    {
+      const std::string temporaryPath = mFileSink.path();
+      try{
+        mFileSink.close();
+      }catch(...){
+      }
+      std::remove( temporaryPath.c_str() );
+    }
+
+    /*
+     * Each chunk is generated to a string by a worker,
+     * while the main thread writes the previous chunks in order.
+     * At most mThreadCount chunks are pending,
+     * which bounds the memory used by the buffers.
+     * Large chunks do not fit in the file sink buffer,
+     * so they are passed directly to the file without being copied.
+     *
+     * If writing fails, the destructors of the pending futures
+     * wait for their workers, which still refer to the table.
+     */
+    template<typename InputIterator, typename RecordWriter>
+    void writeTableToSinkParallel(InputIterator first, InputIterator last, const RecordWriter & recordWriter)
+    {
+      using Chunk = std::pair<std::string, bool>;
+
+      const auto generateChunk = [&recordWriter](InputIterator chunkFirst, InputIterator chunkLast){
+        Chunk chunk;
+        chunk.second = false;
+        Impl::StringSink sink(chunk.first);
+        for(; chunkFirst != chunkLast; ++chunkFirst){
+          if( recordWriter(*chunkFirst, sink) ){
+            chunk.second = true;
+          }
+        }
+        return chunk;
+      };
+
+      std::deque< std::future<Chunk> > pendingChunks;
+      bool ok = false;
+
+      std::deque<std::ptrdiff_t> pendingChunkRecordCounts;
+
+      const auto writeFirstPendingChunk = [this, &pendingChunks, &pendingChunkRecordCounts, &ok](){
+        const Chunk chunk = pendingChunks.front().get();
+        const std::ptrdiff_t recordCount = pendingChunkRecordCounts.front();
+        pendingChunks.pop_front();
+        pendingChunkRecordCounts.pop_front();
+        mFileSink.write( chunk.first.data(), chunk.first.size() );
+        if(chunk.second){
+          ok = true;
+          commitIfDue(recordCount);
+        }
+      };
+
+      try{
+        while(first != last){
+          const auto chunkRecordCount = std::min( std::distance(first, last), parallelChunkRecordCount );
+          const auto chunkLast = std::next(first, chunkRecordCount);
+          if( static_cast<int>( pendingChunks.size() ) >= mThreadCount ){
+            writeFirstPendingChunk();
+          }
+          pendingChunks.push_back( std::async(std::launch::async, generateChunk, first, chunkLast) );
+          pendingChunkRecordCounts.push_back(chunkRecordCount);
+          first = chunkLast;
+        }
+        while( !pendingChunks.empty() ){
+          writeFirstPendingChunk();
+        }
+      }catch(const FileWriteError & error){
+        throw CsvFileWriteError( error.what() );
+      }
+      if(!ok){
+        const std::string what = "writing table in file '" + mFilePath + "' failed";
+        throw CsvFileWriteError(what);
+      }
+    }
+
     CsvGeneratorSettings mCsvSettings;
-    FileWriteOpenMode mOpenMode;
-    std::ofstream mFileStream;
+    FileWriteOpenMode mOpenMode = FileWriteOpenMode::Append;
+    FileDurabilityPolicy mDurabilityPolicy;
+    BufferedFileSink mFileSink;
+    Impl::GroupCommit mGroupCommit;
     std::string mFilePath;
+    int mThreadCount = 1;
   };
 
 }} // namespace Mdt{ namespace PlainText{
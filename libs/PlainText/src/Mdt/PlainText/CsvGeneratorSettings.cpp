@@ -5,3 +5,10 @@
  * https://www.boost.org/LICENSE_1_0.txt)
  */
 #include "CsvGeneratorSettings.h"
+
+namespace Mdt{ namespace PlainText{
+
+constexpr signed char CsvGeneratorSettings::noColumnQuotingPolicy;
+constexpr int CsvGeneratorSettings::maximumColumnQuotingPolicyCount;
+
+}} // namespace Mdt{ namespace PlainText{
@@ -8,6 +8,7 @@
 #define MDT_PLAIN_TEXT_GENERATOR_SETTINGS_H
 
 #include "EndOfLine.h"
+#include "CsvQuotingPolicy.h"
 #include "CsvGeneratorSettingsValidity.h"
 #include "mdt_plaintext_export.h"
 #include <cassert>
@@ -145,6 +146,165 @@ namespace Mdt{ namespace PlainText{
       return mEndOfLine;
     }
 
+    /*! \brief Set the quoting policy
+     *
+     * \sa quotingPolicy()
+     */
+    constexpr void setQuotingPolicy(CsvQuotingPolicy policy) noexcept
+    {
+      mQuotingPolicy = policy;
+    }
+
+    /*! \brief Get the quoting policy
+     *
+     * This policy applies to each column
+     *  that has no quoting policy of its own.
+     *
+     * The default is CsvQuotingPolicy::Minimal
+     *
+     * \sa setQuotingPolicy()
+     * \sa columnQuotingPolicy()
+     */
+    constexpr CsvQuotingPolicy quotingPolicy() const noexcept
+    {
+      return mQuotingPolicy;
+    }
+
+    /*! \brief Set the quoting policy of a column
+     *
+     * For example, a numeric column never needs protection,
+     *  so it can be declared with CsvQuotingPolicy::Never ,
+     *  and its fields are copied without being checked.
+     *
+     * The overrides are stored in this settings,
+     *  so only the first maximumColumnQuotingPolicyCount columns
+     *  can have their own quoting policy.
+     *
+     * \pre \a column must be >= 0
+     * \pre \a column must be < maximumColumnQuotingPolicyCount
+     * \sa columnQuotingPolicy()
+     */
+    constexpr void setColumnQuotingPolicy(int column, CsvQuotingPolicy policy) noexcept
+    {
+      assert( column >= 0 );
+      assert( column < maximumColumnQuotingPolicyCount );
+
+      for(int i = mColumnQuotingPolicyCount; i < column; ++i){
+        mColumnQuotingPolicies[i] = noColumnQuotingPolicy;
+      }
+      if(column >= mColumnQuotingPolicyCount){
+        mColumnQuotingPolicyCount = column + 1;
+      }
+      mColumnQuotingPolicies[column] = static_cast<signed char>(policy);
+    }
+
+    /*! \brief Get the quoting policy of a column
+     *
+     * Returns the policy set with setColumnQuotingPolicy()
+     *  if any, otherwise quotingPolicy()
+     *
+     * \pre \a column must be >= 0
+     * \sa setColumnQuotingPolicy()
+     */
+    constexpr CsvQuotingPolicy columnQuotingPolicy(int column) const noexcept
+    {
+      assert( column >= 0 );
+
+      if( column >= mColumnQuotingPolicyCount ){
+        return mQuotingPolicy;
+      }
+      if( mColumnQuotingPolicies[column] == noColumnQuotingPolicy ){
+        return mQuotingPolicy;
+      }
+
+      return static_cast<CsvQuotingPolicy>(mColumnQuotingPolicies[column]);
+    }
+
+    /*! \brief Get the count of columns that can have their own quoting policy
+     *
+     * Each column at or after this count uses quotingPolicy()
+     *
+     * \sa setColumnQuotingPolicy()
+     */
+    constexpr int columnQuotingPolicyCount() const noexcept
+    {
+      return mColumnQuotingPolicyCount;
+    }
+
+    /*! \brief Remove the quoting policy of each column
+     *
+     * After this call, each column uses quotingPolicy()
+     */
+    constexpr void clearColumnQuotingPolicies() noexcept
+    {
+      mColumnQuotingPolicyCount = 0;
+    }
+
+    /*! \brief Maximum count of columns that can have their own quoting policy
+     *
+     * \sa setColumnQuotingPolicy()
+     */
+    static constexpr int maximumColumnQuotingPolicyCount = 32;
+
+    /*! \brief Set the count of fractional digits of real numbers
+     *
+     * \pre \a precision must be >= 0
+     * \sa realPrecision()
+     */
+    constexpr void setRealPrecision(int precision) noexcept
+    {
+      assert( precision >= 0 );
+
+      mRealPrecision = precision;
+    }
+
+    /*! \brief Get the count of fractional digits of real numbers
+     *
+     * This is the maximum count of digits
+     *  written after the decimal separator.
+     *  Trailing zeros are not written,
+     *  for example 2.5 is written as 2.5 ,
+     *  and 1.0/3.0 as 0.333333 with the default precision.
+     *
+     * The default is 6
+     *
+     * \sa setRealPrecision()
+     * \sa decimalSeparator()
+     */
+    constexpr int realPrecision() const noexcept
+    {
+      return mRealPrecision;
+    }
+
+    /*! \brief Set the decimal separator of real numbers
+     *
+     * \pre \a separator must not be a end-of-line
+     * \sa isEndOfLine()
+     * \sa decimalSeparator()
+     */
+    constexpr void setDecimalSeparator(char separator) noexcept
+    {
+      assert( !isEndOfLine(separator) );
+
+      mDecimalSeparator = separator;
+    }
+
+    /*! \brief Get the decimal separator of real numbers
+     *
+     * For example, some locales use the comma ","
+     *  together with a semicolon ";" as field separator.
+     *  If the decimal separator is the same as the field separator,
+     *  real numbers are written as protected fields.
+     *
+     * The default is the dot "."
+     *
+     * \sa setDecimalSeparator()
+     */
+    constexpr char decimalSeparator() const noexcept
+    {
+      return mDecimalSeparator;
+    }
+
     /*! \brief Validate this settings
      *
      * CSV generator settings are valid if the field separator and field protection are different.
@@ -192,10 +352,17 @@ namespace Mdt{ namespace PlainText{
 
    private:
 
+    static constexpr signed char noColumnQuotingPolicy = -1;
+
     char mFieldSeparator = ',';
     char mFieldProtection = '"';
     bool mAddExp = false;
     EndOfLine mEndOfLine = EndOfLine::Native;
+    CsvQuotingPolicy mQuotingPolicy = CsvQuotingPolicy::Minimal;
+    signed char mColumnQuotingPolicies[maximumColumnQuotingPolicyCount] = {};
+    int mColumnQuotingPolicyCount = 0;
+    int mRealPrecision = 6;
+    char mDecimalSeparator = '.';
   };
 
 }} // namespace Mdt{ namespace PlainText{
@@ -0,0 +1,74 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_CSV_MALFORMED_RECORD_H
+#define MDT_PLAIN_TEXT_CSV_MALFORMED_RECORD_H
+
+#include "SourcePosition.h"
+#include "mdt_plaintext_export.h"
+#include <string>
+#include <cstdint>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief A malformed record skipped while reading a CSV file
+   *
+   * \sa CsvFileReader::readAll(std::vector<CsvMalformedRecord> &)
+   */
+  class MDT_PLAINTEXT_EXPORT CsvMalformedRecord
+  {
+   public:
+
+    /*! \brief Construct a malformed record
+     */
+    CsvMalformedRecord(const SourcePosition & position, const std::string & rawData)
+     : mPosition(position),
+       mRawData(rawData)
+    {
+    }
+
+    /*! \brief Get the position in the file at which the malformed record starts
+     */
+    const SourcePosition & position() const noexcept
+    {
+      return mPosition;
+    }
+
+    /*! \brief Get the line number at which the malformed record starts
+     *
+     * The first line of the file has the number 1.
+     */
+    int64_t lineNumber() const noexcept
+    {
+      return mPosition.lineNumber();
+    }
+
+    /*! \brief Get the offset, in bytes, from the beginning of the file to the malformed record
+     */
+    int64_t byteOffset() const noexcept
+    {
+      return mPosition.offset();
+    }
+
+    /*! \brief Get the raw data of the malformed record
+     *
+     * The raw data are the bytes from the beginning of the malformed record
+     * to the next end-of-line, which is not included.
+     */
+    const std::string & rawData() const noexcept
+    {
+      return mRawData;
+    }
+
+   private:
+
+    SourcePosition mPosition;
+    std::string mRawData;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_CSV_MALFORMED_RECORD_H
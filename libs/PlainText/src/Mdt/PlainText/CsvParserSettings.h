@@ -9,6 +9,7 @@
 
 #include "CsvParserSettingsValidity.h"
 #include "mdt_plaintext_export.h"
+#include <cstdint>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{
@@ -123,6 +124,128 @@ namespace Mdt{ namespace PlainText{
       return mParseExp;
     }
 
+    /*! \brief Set the maximum length of a field
+     *
+     * A value of 0 means no limit.
+     *
+     * \pre \a length must be >= 0
+     * \sa maximumFieldLength()
+     */
+    constexpr void setMaximumFieldLength(int64_t length) noexcept
+    {
+      assert( length >= 0 );
+
+      mMaximumFieldLength = length;
+    }
+
+    /*! \brief Get the maximum length of a field
+     *
+     * The length of a field is its count of chars,
+     * without the field protection and the EXP.
+     *
+     * A field that exceeds this limit is not consumed further
+     * and makes its record fail to parse.
+     * This is typically useful to not consume the whole source into a single field
+     * when a field protection is not terminated.
+     *
+     * The default is 0, which means no limit.
+     *
+     * \sa setMaximumFieldLength()
+     */
+    constexpr int64_t maximumFieldLength() const noexcept
+    {
+      return mMaximumFieldLength;
+    }
+
+    /*! \brief Set the maximum length of a record
+     *
+     * A value of 0 means no limit.
+     *
+     * \pre \a length must be >= 0
+     * \sa maximumRecordLength()
+     */
+    constexpr void setMaximumRecordLength(int64_t length) noexcept
+    {
+      assert( length >= 0 );
+
+      mMaximumRecordLength = length;
+    }
+
+    /*! \brief Get the maximum length of a record
+     *
+     * The length of a record is its count of chars in the source,
+     * including field separators and protections,
+     * but not the end-of-line that terminates it.
+     *
+     * This limit is enforced by the file readers,
+     * which stop reading a record when it exceeds it.
+     *
+     * The default is 0, which means no limit.
+     *
+     * \sa setMaximumRecordLength()
+     */
+    constexpr int64_t maximumRecordLength() const noexcept
+    {
+      return mMaximumRecordLength;
+    }
+
+    /*! \brief Set the maximum count of columns of a record
+     *
+     * A value of 0 means no limit.
+     *
+     * \pre \a count must be >= 0
+     * \sa maximumColumnCount()
+     */
+    constexpr void setMaximumColumnCount(int count) noexcept
+    {
+      assert( count >= 0 );
+
+      mMaximumColumnCount = count;
+    }
+
+    /*! \brief Get the maximum count of columns of a record
+     *
+     * A record that has more columns than this limit
+     * is not consumed further and fails to parse.
+     *
+     * The default is 0, which means no limit.
+     *
+     * \sa setMaximumColumnCount()
+     */
+    constexpr int maximumColumnCount() const noexcept
+    {
+      return mMaximumColumnCount;
+    }
+
+    /*! \brief Set if the source must be valid UTF-8
+     *
+     * \sa validateUtf8()
+     */
+    constexpr void setValidateUtf8(bool validate) noexcept
+    {
+      mValidateUtf8 = validate;
+    }
+
+    /*! \brief Check if the source must be valid UTF-8
+     *
+     * When true, CsvFileReader checks each block of the file
+     * while it reads it, and fails to read
+     * the line that contains the first invalid sequence.
+     * Blocks of ASCII chars are skipped quickly,
+     * so the check costs little compared to the parsing.
+     *
+     * This setting is not used by the grammars,
+     * which accept any byte.
+     *
+     * The default is false.
+     *
+     * \sa setValidateUtf8()
+     */
+    constexpr bool validateUtf8() const noexcept
+    {
+      return mValidateUtf8;
+    }
+
     /*! \brief Validate this settings
      *
      * CSV parser settings are valid if the field separator and field protection are different.
@@ -173,6 +296,10 @@ namespace Mdt{ namespace PlainText{
     char mFieldSeparator = ',';
     char mFieldProtection = '"';
     bool mParseExp = true;
+    bool mValidateUtf8 = false;
+    int mMaximumColumnCount = 0;
+    int64_t mMaximumFieldLength = 0;
+    int64_t mMaximumRecordLength = 0;
   };
 
 }} // namespace Mdt{ namespace PlainText{
@@ -0,0 +1,32 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_CSV_QUOTING_POLICY_H
+#define MDT_PLAIN_TEXT_CSV_QUOTING_POLICY_H
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief Policy to choose if a generated field is protected
+   *
+   * Field payload protection is explained
+   *  in CSV-1203 standard, §9.
+   */
+  enum class CsvQuotingPolicy
+  {
+    Minimal,  /*!< A field is protected only if it has to be:
+                   each field is checked, for example for separators or end-of-lines */
+    Always,   /*!< Each field is protected, without checking it.
+                   Field protections in the payload are still doubled */
+    Never     /*!< No field is protected, and fields are not checked:
+                   they are copied as is.
+                   The caller must ensure that no field contains
+                   a separator, a field protection or a end-of-line,
+                   otherwise the generated CSV is malformed */
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_CSV_QUOTING_POLICY_H
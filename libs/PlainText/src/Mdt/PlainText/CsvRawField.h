@@ -0,0 +1,130 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_CSV_RAW_FIELD_H
+#define MDT_PLAIN_TEXT_CSV_RAW_FIELD_H
+
+#include <string>
+#include <iterator>
+#include <cstdint>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief A field of a CSV record that refers to its source
+   *
+   * A raw field holds the range of its payload in the source,
+   * without the field protections and the EXP (Excel protection marker).
+   * Nothing is copied or decoded while parsing.
+   *
+   * The payload of a protected field can contain doubled field protections,
+   * for example \c "" for a \c " .
+   * Such a field needs to be unescaped, which is done by toString().
+   * For all other fields, the range refers directly to the value,
+   * and can be used without any copy.
+   *
+   * A raw field is only valid as long as its source is.
+   * It is typically the attribute of Grammar::Csv::X3::CsvRawRecord ,
+   * parsing a source that is fully in memory.
+   *
+   * \code
+   * using RawRecord = std::vector< CsvRawField<std::string::const_iterator> >;
+   *
+   * const Grammar::Csv::X3::CsvRawRecord<RawRecord> rule(settings);
+   * RawRecord record;
+   * if( boost::spirit::x3::parse(first, last, rule, record) ){
+   *   // Only the 3rd column is decoded
+   *   const std::string name = record[2].toString();
+   * }
+   * \endcode
+   */
+  template<typename SourceIterator>
+  class CsvRawField
+  {
+   public:
+
+    using const_iterator = SourceIterator;
+
+    /*! \brief Construct a empty raw field
+     */
+    CsvRawField() = default;
+
+    /*! \brief Construct a raw field
+     *
+     * \a first and \a last are the range of the payload in the source.
+     * \a needsUnescape tells if the payload contains doubled \a fieldProtection .
+     */
+    CsvRawField(SourceIterator first, SourceIterator last, char fieldProtection, bool needsUnescape) noexcept
+     : mFirst(first),
+       mLast(last),
+       mFieldProtection(fieldProtection),
+       mNeedsUnescape(needsUnescape)
+    {
+    }
+
+    /*! \brief Get the begin of the payload in the source
+     */
+    const_iterator begin() const noexcept
+    {
+      return mFirst;
+    }
+
+    /*! \brief Get the end of the payload in the source
+     */
+    const_iterator end() const noexcept
+    {
+      return mLast;
+    }
+
+    /*! \brief Check if this field is empty
+     */
+    bool isEmpty() const noexcept
+    {
+      return mFirst == mLast;
+    }
+
+    /*! \brief Check if the payload of this field contains doubled field protections
+     *
+     * If this is false, begin() and end() refer directly to the value of this field.
+     */
+    bool needsUnescape() const noexcept
+    {
+      return mNeedsUnescape;
+    }
+
+    /*! \brief Get the value of this field
+     *
+     * The payload is unescaped if needsUnescape() is true,
+     * otherwise it is only copied.
+     */
+    template<typename String = std::string>
+    String toString() const
+    {
+      if(!mNeedsUnescape){
+        return String(mFirst, mLast);
+      }
+
+      String str;
+      for(SourceIterator it = mFirst; it != mLast; ++it){
+        str.push_back(*it);
+        if( static_cast<uint32_t>(*it) == static_cast<uint32_t>(mFieldProtection) ){
+          ++it;
+        }
+      }
+
+      return str;
+    }
+
+   private:
+
+    SourceIterator mFirst = SourceIterator();
+    SourceIterator mLast = SourceIterator();
+    char mFieldProtection = '"';
+    bool mNeedsUnescape = false;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_CSV_RAW_FIELD_H
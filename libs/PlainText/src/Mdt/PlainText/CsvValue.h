@@ -0,0 +1,228 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_CSV_VALUE_H
+#define MDT_PLAIN_TEXT_CSV_VALUE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief Type of a CsvValue
+   */
+  enum class CsvValueType
+  {
+    Integer,          /*!< Signed integer, stored as a int64_t */
+    UnsignedInteger,  /*!< Unsigned integer, stored as a uint64_t */
+    Real,             /*!< Floating point number, stored as a double */
+    Boolean,          /*!< Boolean */
+    String            /*!< String, stored as a std::string */
+  };
+
+  /*! \brief A typed value of a CSV record
+   *
+   * A CSV record can be made of values of different types:
+   * \code
+   * const std::vector<CsvValue> record = {"Name", 25, 1.75, true};
+   *
+   * csvWriter.writeTypedLine(record);
+   * \endcode
+   *
+   * Numbers and booleans are written directly to the file,
+   * as described in CsvFileWriter::writeTypedLine().
+   */
+  class CsvValue
+  {
+   public:
+
+    /*! \brief Construct a empty string value
+     */
+    CsvValue() noexcept
+    {
+      mInteger = 0;
+    }
+
+    /*! \brief Construct a integer value
+     */
+    CsvValue(int value) noexcept
+     : mType(CsvValueType::Integer)
+    {
+      mInteger = value;
+    }
+
+    /*! \brief Construct a integer value
+     */
+    CsvValue(long value) noexcept
+     : mType(CsvValueType::Integer)
+    {
+      mInteger = value;
+    }
+
+    /*! \brief Construct a integer value
+     */
+    CsvValue(long long value) noexcept
+     : mType(CsvValueType::Integer)
+    {
+      mInteger = value;
+    }
+
+    /*! \brief Construct a unsigned integer value
+     */
+    CsvValue(unsigned int value) noexcept
+     : mType(CsvValueType::UnsignedInteger)
+    {
+      mUnsignedInteger = value;
+    }
+
+    /*! \brief Construct a unsigned integer value
+     */
+    CsvValue(unsigned long value) noexcept
+     : mType(CsvValueType::UnsignedInteger)
+    {
+      mUnsignedInteger = value;
+    }
+
+    /*! \brief Construct a unsigned integer value
+     */
+    CsvValue(unsigned long long value) noexcept
+     : mType(CsvValueType::UnsignedInteger)
+    {
+      mUnsignedInteger = value;
+    }
+
+    /*! \brief Construct a real value
+     */
+    CsvValue(float value) noexcept
+     : mType(CsvValueType::Real)
+    {
+      mReal = value;
+    }
+
+    /*! \brief Construct a real value
+     */
+    CsvValue(double value) noexcept
+     : mType(CsvValueType::Real)
+    {
+      mReal = value;
+    }
+
+    /*! \brief Construct a boolean value
+     */
+    CsvValue(bool value) noexcept
+     : mType(CsvValueType::Boolean)
+    {
+      mBoolean = value;
+    }
+
+    /*! \brief Construct a string value
+     *
+     * This overload avoids that a string literal
+     * is converted to a boolean.
+     *
+     * \pre \a value must not be a nullptr
+     */
+    CsvValue(const char *value)
+     : mString(value)
+    {
+      assert( value != nullptr );
+
+      mInteger = 0;
+    }
+
+    /*! \brief Construct a string value
+     */
+    CsvValue(std::string value) noexcept
+     : mString( std::move(value) )
+    {
+      mInteger = 0;
+    }
+
+    /*! \brief Get the type of this value
+     */
+    CsvValueType type() const noexcept
+    {
+      return mType;
+    }
+
+    /*! \brief Get the integer
+     *
+     * \pre type() must be CsvValueType::Integer
+     */
+    int64_t toInteger() const noexcept
+    {
+      assert( mType == CsvValueType::Integer );
+
+      return mInteger;
+    }
+
+    /*! \brief Get the unsigned integer
+     *
+     * \pre type() must be CsvValueType::UnsignedInteger
+     */
+    uint64_t toUnsignedInteger() const noexcept
+    {
+      assert( mType == CsvValueType::UnsignedInteger );
+
+      return mUnsignedInteger;
+    }
+
+    /*! \brief Get the real
+     *
+     * \pre type() must be CsvValueType::Real
+     */
+    double toReal() const noexcept
+    {
+      assert( mType == CsvValueType::Real );
+
+      return mReal;
+    }
+
+    /*! \brief Get the boolean
+     *
+     * \pre type() must be CsvValueType::Boolean
+     */
+    bool toBoolean() const noexcept
+    {
+      assert( mType == CsvValueType::Boolean );
+
+      return mBoolean;
+    }
+
+    /*! \brief Get the string
+     *
+     * \pre type() must be CsvValueType::String
+     */
+    const std::string & toString() const noexcept
+    {
+      assert( mType == CsvValueType::String );
+
+      return mString;
+    }
+
+   private:
+
+    CsvValueType mType = CsvValueType::String;
+    union
+    {
+      int64_t mInteger;
+      uint64_t mUnsignedInteger;
+      double mReal;
+      bool mBoolean;
+    };
+    std::string mString;
+  };
+
+  /*! \brief A CSV record made of typed values
+   */
+  using CsvValueRecord = std::vector<CsvValue>;
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_CSV_VALUE_H
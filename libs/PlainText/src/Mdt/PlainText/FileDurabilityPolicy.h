@@ -0,0 +1,127 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_FILE_DURABILITY_POLICY_H
+#define MDT_PLAIN_TEXT_FILE_DURABILITY_POLICY_H
+
+#include <chrono>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief Guarantee about the data that reached the storage
+   */
+  enum class FileDurability
+  {
+    None,           /*!< Data are left to the operating system,
+                         which writes them to the storage later.
+                         This is the fastest, but data can be lost on a power failure. */
+    SyncOnClose,    /*!< close() returns once all data are on the storage */
+    GroupCommit,    /*!< Data are regularly synced to the storage by a background thread,
+                         and close() returns once all data are on the storage */
+    AtomicReplace   /*!< Data are written to a temporary file,
+                         which replaces the file once synced to the storage by close().
+                         The file has either its old content, or the complete new one. */
+  };
+
+  /*! \brief Durability policy of a file writer
+   *
+   * By default, no guarantee is given about the data that reached the storage
+   * (FileDurability::None).
+   *
+   * Syncing a file to the storage is expensive,
+   * so syncing after each record kills the throughput.
+   * With FileDurability::GroupCommit ,
+   * the records are synced by groups, from a background thread:
+   * \code
+   * FileDurabilityPolicy policy;
+   *
+   * policy.setDurability(FileDurability::GroupCommit);
+   * policy.setGroupCommitRecordCount(10000);
+   * policy.setGroupCommitInterval( std::chrono::milliseconds(200) );
+   *
+   * csvWriter.setDurabilityPolicy(policy);
+   * \endcode
+   */
+  class FileDurabilityPolicy
+  {
+   public:
+
+    /*! \brief Set the durability
+     */
+    constexpr void setDurability(FileDurability durability) noexcept
+    {
+      mDurability = durability;
+    }
+
+    /*! \brief Get the durability
+     *
+     * The default is FileDurability::None
+     */
+    constexpr FileDurability durability() const noexcept
+    {
+      return mDurability;
+    }
+
+    /*! \brief Set the count of records after which a group is committed
+     *
+     * Only used with FileDurability::GroupCommit .
+     * A count of 0 means no limit.
+     *
+     * \pre \a count must be >= 0
+     */
+    constexpr void setGroupCommitRecordCount(int64_t count) noexcept
+    {
+      assert( count >= 0 );
+
+      mGroupCommitRecordCount = count;
+    }
+
+    /*! \brief Get the count of records after which a group is committed
+     *
+     * The default is 0, which means no limit.
+     */
+    constexpr int64_t groupCommitRecordCount() const noexcept
+    {
+      return mGroupCommitRecordCount;
+    }
+
+    /*! \brief Set the maximum time between two group commits
+     *
+     * Only used with FileDurability::GroupCommit .
+     * Once \a interval elapsed, the records that have been written
+     * are committed with the next written record.
+     * A interval of 0 means no limit.
+     *
+     * \pre \a interval must be >= 0
+     */
+    constexpr void setGroupCommitInterval(std::chrono::milliseconds interval) noexcept
+    {
+      assert( interval.count() >= 0 );
+
+      mGroupCommitInterval = interval;
+    }
+
+    /*! \brief Get the maximum time between two group commits
+     *
+     * The default is 1 second.
+     */
+    constexpr std::chrono::milliseconds groupCommitInterval() const noexcept
+    {
+      return mGroupCommitInterval;
+    }
+
+   private:
+
+    FileDurability mDurability = FileDurability::None;
+    int64_t mGroupCommitRecordCount = 0;
+    std::chrono::milliseconds mGroupCommitInterval = std::chrono::milliseconds(1000);
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_FILE_DURABILITY_POLICY_H
@@ -7,7 +7,7 @@
 #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_CSV_RECORD_H
 #define MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_CSV_RECORD_H
 
-#include "FieldColumn.h"
+#include "RecordPayloadGenerator.h"
 #include "Mdt/PlainText/CsvGeneratorSettings.h"
 #include "Mdt/PlainText/EndOfLine.h"
 #include <boost/spirit/include/karma.hpp>
@@ -16,6 +16,9 @@
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
 
   /*! \brief CSV record rule
+   *
+   * Each field is generated with the quoting policy of its column,
+   * see RecordPayloadGenerator.
    *
    * \note Some part of this API documentation refers to following standards:
    *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
@@ -32,13 +35,12 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
      */
     CsvRecord(const CsvGeneratorSettings & settings) noexcept
      : CsvRecord::base_type(mCsvRecord, "CsvRecord"),
-       mFieldColumn(settings)
+       mRecordPayloadGenerator(settings)
     {
       assert( settings.isValid() );
 
       using boost::spirit::lit;
 
-      const char fieldSep = settings.fieldSeparator();
       EndOfLine endOfLine = settings.endOfLine();
 
       if( endOfLine == EndOfLine::Native ){
@@ -58,7 +60,7 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
           break;
       }
 
-      mRecordPayload = mFieldColumn % lit(fieldSep);
+      mRecordPayload = mRecordPayloadGenerator;
 
       BOOST_SPIRIT_DEBUG_NODE(mCsvRecord);
       BOOST_SPIRIT_DEBUG_NODE(mRecordPayload);
@@ -68,7 +70,7 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
 
     boost::spirit::karma::rule<DestinationIterator, SourceRecord()> mCsvRecord;
     boost::spirit::karma::rule<DestinationIterator, SourceRecord()> mRecordPayload;
-    FieldColumn<DestinationIterator, SourceString> mFieldColumn;
+    RecordPayloadGenerator<SourceRecord> mRecordPayloadGenerator;
   };
 
 }}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
@@ -7,11 +7,9 @@
 #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_FIELD_COLUMN_H
 #define MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_FIELD_COLUMN_H
 
-#include "ProtectedField.h"
-#include "UnprotectedField.h"
+#include "FieldGenerator.h"
 #include "Mdt/PlainText/CsvGeneratorSettings.h"
 #include <boost/spirit/include/karma.hpp>
-#include <cstdint>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
@@ -21,6 +19,10 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
    * As described in CSV-1203, §9, if a field payload contains at least a field separator,
    * a double-quote or a end of line, it will be protected, otherwise not.
    *
+   * The result is the same as UnprotectedField | ProtectedField ,
+   * but each field is generated in a single pass by FieldGenerator ,
+   * without buffering the output of a alternative.
+   *
    * \note Some part of this API documentation refers to following standards:
    *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
    *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
@@ -33,13 +35,11 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
      * \pre \a settings must be valid
      */
     FieldColumn(const CsvGeneratorSettings & settings) noexcept
-     : FieldColumn::base_type(mFieldColumn, "FieldColumn"),
-       mUnprotectedField(settings),
-       mProtectedField(settings)
+     : FieldColumn::base_type(mFieldColumn, "FieldColumn")
     {
       assert( settings.isValid() );
 
-      mFieldColumn = mUnprotectedField | mProtectedField;
+      mFieldColumn = FieldGenerator<SourceString>(settings);
 
       BOOST_SPIRIT_DEBUG_NODE(mFieldColumn);
     }
@@ -47,8 +47,6 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
    private:
 
     boost::spirit::karma::rule<DestinationIterator, SourceString()> mFieldColumn;
-    UnprotectedField<DestinationIterator, SourceString> mUnprotectedField;
-    ProtectedField<DestinationIterator, SourceString> mProtectedField;
   };
 
 }}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
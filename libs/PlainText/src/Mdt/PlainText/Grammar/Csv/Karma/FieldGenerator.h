@@ -0,0 +1,140 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_FIELD_GENERATOR_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_FIELD_GENERATOR_H
+
+#include "Mdt/PlainText/Impl/CsvFieldQuoting.h"
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include "Mdt/PlainText/CsvQuotingPolicy.h"
+#include <boost/spirit/include/karma.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
+
+  /*! \brief Generator for a CSV field column
+   *
+   * With CsvQuotingPolicy::Minimal ,
+   * generates the same output as UnprotectedField | ProtectedField ,
+   * but in a single generator:
+   * the field is first checked with ValidateStringForUnprotectedField ,
+   * then written as is if it can be unprotected,
+   * otherwise written between field protections,
+   * with each field protection it contains doubled.
+   * The other quoting policies of the settings skip the check,
+   * see CsvQuotingPolicy and Impl::CsvFieldQuoting .
+   *
+   * Because it never fails, no alternative is required,
+   * so the output is not buffered.
+   * Each char is written directly, without going through a rule.
+   *
+   * \pre \a SourceString must be iterable,
+   *   and its values must be chars or Unicode code points
+   */
+  template <typename SourceString>
+  struct FieldGenerator : boost::spirit::karma::primitive_generator< FieldGenerator<SourceString> >
+  {
+    template<typename Context, typename Unused>
+    struct attribute
+    {
+      using type = SourceString;
+    };
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     */
+    explicit FieldGenerator(const CsvGeneratorSettings & settings) noexcept
+     : mQuoting(settings),
+       mFieldProtection( settings.fieldProtection() ),
+       mAddExp( settings.addExp() )
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename DestinationIterator, typename Context, typename Delimiter, typename Attribute>
+    bool generate(DestinationIterator & sink, Context &, const Delimiter & delimiter, const Attribute & attribute) const
+    {
+      generateField( sink, attribute, mQuoting.quotingPolicy() );
+
+      return boost::spirit::karma::delimit_out(sink, delimiter);
+    }
+
+    /*! \brief Generate \a field to \a sink using \a policy
+     *
+     * With CsvQuotingPolicy::Minimal , \a field is first checked
+     * to choose if it has to be protected.
+     * With the other policies, \a field is not checked.
+     */
+    template<typename DestinationIterator, typename String>
+    void generateField(DestinationIterator & sink, const String & field, CsvQuotingPolicy policy) const
+    {
+      if( mQuoting.mustProtect(field, policy) ){
+        generateProtectedField(sink, field);
+      }else{
+        generateUnprotectedField(sink, field);
+      }
+    }
+
+    /*! \brief Generate \a field to \a sink using the quoting policy of \a column
+     *
+     * \sa CsvGeneratorSettings::columnQuotingPolicy()
+     */
+    template<typename DestinationIterator, typename String>
+    void generateColumnField(DestinationIterator & sink, const String & field, std::size_t column) const
+    {
+      generateField( sink, field, mQuoting.columnQuotingPolicy(column) );
+    }
+
+    template<typename Context>
+    boost::spirit::info what(Context &) const
+    {
+      return boost::spirit::info("FieldGenerator");
+    }
+
+   private:
+
+    template<typename DestinationIterator, typename String>
+    void generateUnprotectedField(DestinationIterator & sink, const String & field) const
+    {
+      namespace karma = boost::spirit::karma;
+
+      if(mAddExp){
+        karma::detail::generate_to(sink, '~');
+      }
+      for(const auto c : field){
+        karma::detail::generate_to(sink, c);
+      }
+    }
+
+    template<typename DestinationIterator, typename String>
+    void generateProtectedField(DestinationIterator & sink, const String & field) const
+    {
+      namespace karma = boost::spirit::karma;
+
+      karma::detail::generate_to(sink, mFieldProtection);
+      if(mAddExp){
+        karma::detail::generate_to(sink, '~');
+      }
+      for(const auto c : field){
+        if( static_cast<uint32_t>(c) == static_cast<uint32_t>(mFieldProtection) ){
+          karma::detail::generate_to(sink, c);
+        }
+        karma::detail::generate_to(sink, c);
+      }
+      karma::detail::generate_to(sink, mFieldProtection);
+    }
+
+    Impl::CsvFieldQuoting mQuoting;
+    char mFieldProtection;
+    bool mAddExp;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_FIELD_GENERATOR_H
@@ -0,0 +1,88 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_RECORD_PAYLOAD_GENERATOR_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_RECORD_PAYLOAD_GENERATOR_H
+
+#include "FieldGenerator.h"
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include <boost/spirit/include/karma.hpp>
+#include <cstddef>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
+
+  /*! \brief Generator for the payload of a CSV record
+   *
+   * Generates the same output as FieldColumn % FIELDSEP ,
+   * but each field is generated with the quoting policy of its column,
+   * see CsvGeneratorSettings::columnQuotingPolicy().
+   *
+   * Like the list generator, it fails on a empty record.
+   *
+   * \pre \a SourceRecord must be iterable,
+   *   and its values must be strings accepted by FieldGenerator
+   */
+  template <typename SourceRecord>
+  struct RecordPayloadGenerator : boost::spirit::karma::primitive_generator< RecordPayloadGenerator<SourceRecord> >
+  {
+    using SourceString = typename SourceRecord::value_type;
+
+    template<typename Context, typename Unused>
+    struct attribute
+    {
+      using type = SourceRecord;
+    };
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     */
+    explicit RecordPayloadGenerator(const CsvGeneratorSettings & settings) noexcept
+     : mFieldGenerator(settings),
+       mFieldSeparator( settings.fieldSeparator() )
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename DestinationIterator, typename Context, typename Delimiter, typename Attribute>
+    bool generate(DestinationIterator & sink, Context &, const Delimiter & delimiter, const Attribute & attribute) const
+    {
+      namespace karma = boost::spirit::karma;
+
+      auto it = attribute.begin();
+      const auto last = attribute.end();
+
+      if(it == last){
+        return false;
+      }
+
+      std::size_t column = 0;
+      mFieldGenerator.generateColumnField(sink, *it, column);
+      for(++it; it != last; ++it){
+        ++column;
+        karma::detail::generate_to(sink, mFieldSeparator);
+        mFieldGenerator.generateColumnField(sink, *it, column);
+      }
+
+      return karma::delimit_out(sink, delimiter);
+    }
+
+    template<typename Context>
+    boost::spirit::info what(Context &) const
+    {
+      return boost::spirit::info("RecordPayloadGenerator");
+    }
+
+   private:
+
+    FieldGenerator<SourceString> mFieldGenerator;
+    char mFieldSeparator;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_KARMA_RECORD_PAYLOAD_GENERATOR_H
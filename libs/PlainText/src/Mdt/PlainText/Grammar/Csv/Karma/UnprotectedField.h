@@ -12,67 +12,108 @@
 #include <boost/spirit/include/phoenix_core.hpp>
 #include <boost/spirit/include/phoenix_operator.hpp>
 #include <boost/spirit/include/phoenix_stl.hpp>
-#include <boost/spirit/include/qi.hpp>
-#include <iterator>
+#include <array>
+#include <cstdint>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Karma{
 
-  /*! \internal
+  /*! \internal Check if a string can be generated as a unprotected field
+   *
+   * The first and last chars must be safe chars,
+   * which excludes the field separator, the field protection, CR, LF, TAB and space.
+   * The other chars can also be a space.
+   *
+   * The class of the chars below 256 is stored in a table
+   * built once from the settings,
+   * so a string is checked in a single pass,
+   * with one lookup per char.
+   * Other Unicode code points are always safe.
    */
-  struct ValidateStringForUnprotectedField
+  class ValidateStringForUnprotectedField
   {
-    constexpr ValidateStringForUnprotectedField(const CsvGeneratorSettings & settings) noexcept
-     : mCsvSettings(settings)
+   public:
+
+    ValidateStringForUnprotectedField(const CsvGeneratorSettings & settings) noexcept
     {
+      mIsSafeChar.fill(true);
+      mIsSafeChar[index('\n')] = false;
+      mIsSafeChar[index('\t')] = false;
+      mIsSafeChar[index('\r')] = false;
+      mIsSafeChar[index(' ')] = false;
+      mIsSafeChar[index( settings.fieldSeparator() )] = false;
+      mIsSafeChar[index( settings.fieldProtection() )] = false;
     }
 
     template<typename String>
     bool operator()(const String & str) const
     {
-      using iterator = typename String::const_iterator;
+      auto it = str.begin();
+      const auto last = str.end();
 
-      const int stringLen = std::distance(str.begin(), str.end());
-
-      if(stringLen < 1){
+      if(it == last){
+        return true;
+      }
+      if( !isSafeChar(*it) ){
+        return false;
+      }
+      ++it;
+      if(it == last){
         return true;
       }
 
-      using boost::spirit::unicode::char_;
-      using boost::spirit::lit;
-      using boost::spirit::repeat;
+      while(true){
+        const auto c = *it;
+        ++it;
+        if(it == last){
+          return isSafeChar(c);
+        }
+        if( !isChar(c) ){
+          return false;
+        }
+      }
+    }
 
-      const char fieldSep = mCsvSettings.fieldSeparator();
-      const char fieldQuote = mCsvSettings.fieldProtection();
+   private:
 
-      boost::spirit::qi::rule<iterator> validString;
-      boost::spirit::qi::rule<iterator> safeChar;
-      boost::spirit::qi::rule<iterator> Char;
+    template<typename CharType>
+    bool isSafeChar(CharType c) const noexcept
+    {
+      const uint32_t codePoint = toCodePoint(c);
 
-      if(stringLen == 1){
-        // validString = safeChar; throws a runtime exception
-        validString = safeChar >> -safeChar;
-      }else if(stringLen == 2){
-        validString = safeChar >> safeChar;
-      }else{
-        assert(stringLen > 2);
-        const int max = stringLen-2;
-        validString = safeChar >> repeat(0,max)[Char] >> safeChar;
+      if(codePoint > 255){
+        return true;
       }
 
-      const std::string exclude = std::string("\n\t\r ") + fieldSep + fieldQuote;
-      safeChar = ~char_(exclude);
+      return mIsSafeChar[codePoint];
+    }
 
-      Char = safeChar | lit(' ');
+    template<typename CharType>
+    bool isChar(CharType c) const noexcept
+    {
+      return isSafeChar(c) || (toCodePoint(c) == ' ');
+    }
 
-      BOOST_SPIRIT_DEBUG_NODE(validString);
-      BOOST_SPIRIT_DEBUG_NODE(safeChar);
-      BOOST_SPIRIT_DEBUG_NODE(Char);
+    static
+    uint32_t toCodePoint(char c) noexcept
+    {
+      return static_cast<unsigned char>(c);
+    }
 
-      return boost::spirit::qi::parse(str.begin(), str.end(), validString);
+    template<typename CharType>
+    static
+    uint32_t toCodePoint(CharType c) noexcept
+    {
+      return static_cast<uint32_t>(c);
+    }
+
+    static
+    std::size_t index(char c) noexcept
+    {
+      return static_cast<unsigned char>(c);
     }
 
-    const CsvGeneratorSettings & mCsvSettings;
+    std::array<bool, 256> mIsSafeChar;
   };
 
   /*! \brief CSV UnprotectedField rule
@@ -8,8 +8,10 @@
 #define MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CHAR_H
 
 #include "SafeChar.h"
+#include "CharClassParser.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
 #include <boost/spirit/include/qi.hpp>
+#include <type_traits>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
@@ -34,15 +36,28 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
     {
       assert( settings.isValid() );
 
-      using boost::spirit::unicode::char_;
-
-      mChar = mSafeChar | char_(' ');
+      defineChar( settings, IsByteSourceIterator<SourceIterator>() );
 
       BOOST_SPIRIT_DEBUG_NODE(mChar);
     }
 
    private:
 
+    /*
+     * For a 8-bit source, the class of each char is looked up in a table
+     */
+    void defineChar(const CsvParserSettings & settings, std::true_type) noexcept
+    {
+      mChar = CharClassParser( CharClassTable(settings), CharClass::Char );
+    }
+
+    void defineChar(const CsvParserSettings &, std::false_type) noexcept
+    {
+      using boost::spirit::unicode::char_;
+
+      mChar = mSafeChar | char_(' ');
+    }
+
     boost::spirit::qi::rule<SourceIterator, DestinationChar()> mChar;
     SafeChar<SourceIterator, DestinationChar> mSafeChar;
   };
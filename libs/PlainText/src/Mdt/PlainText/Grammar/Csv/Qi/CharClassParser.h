@@ -0,0 +1,89 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CHAR_CLASS_PARSER_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CHAR_CLASS_PARSER_H
+
+#include "CharClassTable.h"
+#include <boost/spirit/include/qi.hpp>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+  /*! \brief Check if SourceIterator refers to 8-bit chars
+   *
+   * Grammars that parse a 8-bit source can use CharClassParser ,
+   * other sources (like Unicode code points) are parsed with the Boost.Spirit char parsers.
+   */
+  template<typename SourceIterator>
+  struct IsByteSourceIterator : std::integral_constant<bool,
+    sizeof( typename std::iterator_traits<SourceIterator>::value_type ) == 1
+  >
+  {
+  };
+
+  /*! \brief Parser that accepts a 8-bit char of a given class
+   *
+   * The class of the char is looked up in a CharClassTable .
+   * The attribute is the char converted to a uint32_t ,
+   * like the one of boost::spirit::unicode::char_ .
+   *
+   * \pre The source must be made of 8-bit chars
+   * \sa IsByteSourceIterator
+   */
+  struct CharClassParser : boost::spirit::qi::primitive_parser<CharClassParser>
+  {
+    /*! \brief Construct a parser that accepts chars of class \a charClass in \a table
+     */
+    CharClassParser(const CharClassTable & table, CharClass charClass) noexcept
+     : mTable(table),
+       mCharClass(charClass)
+    {
+    }
+
+    template<typename Context, typename SourceIterator>
+    struct attribute
+    {
+      using type = uint32_t;
+    };
+
+    template<typename SourceIterator, typename Context, typename Skipper, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, Context &, const Skipper & skipper, Attribute & attribute) const
+    {
+      static_assert( IsByteSourceIterator<SourceIterator>::value, "CharClassParser requires a 8-bit source" );
+
+      boost::spirit::qi::skip_over(first, last, skipper);
+
+      if(first == last){
+        return false;
+      }
+      const char c = static_cast<char>(*first);
+      if( !mTable.isOfClass(c, mCharClass) ){
+        return false;
+      }
+      boost::spirit::traits::assign_to(static_cast<uint32_t>(*first), attribute);
+      ++first;
+
+      return true;
+    }
+
+    template<typename Context>
+    boost::spirit::info what(Context &) const
+    {
+      return boost::spirit::info("CharClassParser");
+    }
+
+   private:
+
+    CharClassTable mTable;
+    CharClass mCharClass;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CHAR_CLASS_PARSER_H
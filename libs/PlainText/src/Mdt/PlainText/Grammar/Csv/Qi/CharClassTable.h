@@ -0,0 +1,95 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CHAR_CLASS_TABLE_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CHAR_CLASS_TABLE_H
+
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include <array>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+  /*! \brief Class of a char in a CSV source
+   *
+   * Each class is a bit, so a char can be of many classes.
+   */
+  enum class CharClass : uint8_t
+  {
+    SafeChar = 1,             /*!< Any char, except the field separator, the field protection, CR, LF, TAB and space */
+    Char = 2,                 /*!< A SafeChar or a space */
+    ProtectedFieldChar = 4    /*!< Any char, except the field protection */
+  };
+
+  /*! \brief Table of the class of each 8-bit char
+   *
+   * Classifying a char is a single lookup,
+   * regardless of the settings.
+   */
+  class CharClassTable
+  {
+   public:
+
+    /*! \brief Construct a table for \a settings
+     *
+     * \pre \a settings must be valid
+     */
+    explicit CharClassTable(const CsvParserSettings & settings) noexcept
+    {
+      assert( settings.isValid() );
+
+      const char fieldSep = settings.fieldSeparator();
+      const char fieldQuote = settings.fieldProtection();
+
+      mTable.fill( classBits(CharClass::SafeChar) | classBits(CharClass::Char) | classBits(CharClass::ProtectedFieldChar) );
+
+      removeClass('\n', CharClass::SafeChar);
+      removeClass('\n', CharClass::Char);
+      removeClass('\r', CharClass::SafeChar);
+      removeClass('\r', CharClass::Char);
+      removeClass('\t', CharClass::SafeChar);
+      removeClass('\t', CharClass::Char);
+      removeClass(' ', CharClass::SafeChar);
+      removeClass(fieldSep, CharClass::SafeChar);
+      removeClass(fieldSep, CharClass::Char);
+      removeClass(fieldQuote, CharClass::SafeChar);
+      removeClass(fieldQuote, CharClass::Char);
+      removeClass(fieldQuote, CharClass::ProtectedFieldChar);
+    }
+
+    /*! \brief Check if \a c is of class \a charClass
+     */
+    bool isOfClass(char c, CharClass charClass) const noexcept
+    {
+      return mTable[index(c)] & classBits(charClass);
+    }
+
+   private:
+
+    void removeClass(char c, CharClass charClass) noexcept
+    {
+      mTable[index(c)] &= static_cast<uint8_t>( ~classBits(charClass) );
+    }
+
+    static
+    uint8_t classBits(CharClass charClass) noexcept
+    {
+      return static_cast<uint8_t>(charClass);
+    }
+
+    static
+    std::size_t index(char c) noexcept
+    {
+      return static_cast<unsigned char>(c);
+    }
+
+    std::array<uint8_t, 256> mTable;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CHAR_CLASS_TABLE_H
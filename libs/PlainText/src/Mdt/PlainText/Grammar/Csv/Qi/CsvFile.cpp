@@ -5,3 +5,10 @@
  * https://www.boost.org/LICENSE_1_0.txt)
  */
 #include "CsvFile.h"
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+  template struct CsvFile< std::string::const_iterator, std::vector< std::vector<std::string> > >;
+  template struct CsvFile< Mdt::PlainText::Impl::CsvFileSourceIterator, std::vector< std::vector<std::string> > >;
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
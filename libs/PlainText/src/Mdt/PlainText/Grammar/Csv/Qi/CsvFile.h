@@ -8,8 +8,13 @@
 #define MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CSV_FILE_H
 
 #include "CsvRecord.h"
+#include "FlushMultiPass.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/Impl/CsvFileSourceIterator.h"
+#include "mdt_plaintext_export.h"
 #include <boost/spirit/include/qi.hpp>
+#include <string>
+#include <vector>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
@@ -27,6 +32,13 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
    * That means that each record MUST have a EOR (end of record),
    * and a file requires at least 1 record, which is the header.
    *
+   * Once a record has been parsed,
+   * the input it used is released if the source iterator is a multi pass iterator,
+   * so the memory used by the source buffer is bounded by the largest record.
+   * Because of this, this rule must not be part of a alternative
+   * that could backtrack before its last parsed record.
+   *
+   * \sa FlushMultiPass
    *
    * \note Some part of this API documentation refers to following standards:
    *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
@@ -41,22 +53,7 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
      *
      * \pre \a settings must be valid
      */
-    CsvFile(const CsvParserSettings & settings) noexcept
-     : CsvFile::base_type(mCsvFile, "CsvFile"),
-       mRecord(settings)
-    {
-      assert( settings.isValid() );
-
-      namespace qi = boost::spirit::qi;
-
-      using qi::eol;
-
-      nameRules();
-
-      mCsvFile = (mRecord % eol) >> -eol;
-
-      BOOST_SPIRIT_DEBUG_NODE(mCsvFile);
-    }
+    CsvFile(const CsvParserSettings & settings) noexcept;
 
    private:
 
@@ -70,6 +67,35 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
     CsvRecord<SourceIterator, Record> mRecord;
   };
 
+  /*
+   * Not defined inline, so that the explicit instantiation declarations below
+   * also prevent optimizing compilers from instantiating it.
+   */
+  template <typename SourceIterator, typename DestinationTable>
+  CsvFile<SourceIterator, DestinationTable>::CsvFile(const CsvParserSettings & settings) noexcept
+   : CsvFile::base_type(mCsvFile, "CsvFile"),
+     mRecord(settings)
+  {
+    assert( settings.isValid() );
+
+    namespace qi = boost::spirit::qi;
+
+    using qi::eol;
+
+    nameRules();
+
+    mCsvFile = ( (mRecord >> FlushMultiPass()) % eol ) >> -eol;
+
+    BOOST_SPIRIT_DEBUG_NODE(mCsvFile);
+  }
+
+  /*
+   * Instantiated once in the library for the most common sources and attributes,
+   * so that they are not compiled again by each user.
+   */
+  extern template struct MDT_PLAINTEXT_EXPORT CsvFile< std::string::const_iterator, std::vector< std::vector<std::string> > >;
+  extern template struct MDT_PLAINTEXT_EXPORT CsvFile< Mdt::PlainText::Impl::CsvFileSourceIterator, std::vector< std::vector<std::string> > >;
+
 }}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
 
 #endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CSV_FILE_H
@@ -5,3 +5,10 @@
  * https://www.boost.org/LICENSE_1_0.txt)
  */
 #include "CsvFileLine.h"
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+  template struct CsvFileLine< std::string::const_iterator, std::vector<std::string> >;
+  template struct CsvFileLine< Mdt::PlainText::Impl::CsvFileSourceIterator, std::vector<std::string> >;
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
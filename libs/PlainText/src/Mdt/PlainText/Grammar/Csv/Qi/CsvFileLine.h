@@ -9,7 +9,11 @@
 
 #include "CsvRecord.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/Impl/CsvFileSourceIterator.h"
+#include "mdt_plaintext_export.h"
 #include <boost/spirit/include/qi.hpp>
+#include <string>
+#include <vector>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
@@ -27,22 +31,7 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
      *
      * \pre \a settings must be valid
      */
-    CsvFileLine(const CsvParserSettings & settings) noexcept
-     : CsvFileLine::base_type(mCsvFileLine, "CsvFileLine"),
-       mRecord(settings)
-    {
-      assert( settings.isValid() );
-
-      namespace qi = boost::spirit::qi;
-
-      using qi::eol;
-
-      nameRules();
-
-      mCsvFileLine = mRecord >> -eol;
-
-      BOOST_SPIRIT_DEBUG_NODE(mCsvFileLine);
-    }
+    CsvFileLine(const CsvParserSettings & settings) noexcept;
 
    private:
 
@@ -55,6 +44,35 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
     CsvRecord<SourceIterator, DestinationRecord> mRecord;
   };
 
+  /*
+   * Not defined inline, so that the explicit instantiation declarations below
+   * also prevent optimizing compilers from instantiating it.
+   */
+  template <typename SourceIterator, typename DestinationRecord>
+  CsvFileLine<SourceIterator, DestinationRecord>::CsvFileLine(const CsvParserSettings & settings) noexcept
+   : CsvFileLine::base_type(mCsvFileLine, "CsvFileLine"),
+     mRecord(settings)
+  {
+    assert( settings.isValid() );
+
+    namespace qi = boost::spirit::qi;
+
+    using qi::eol;
+
+    nameRules();
+
+    mCsvFileLine = mRecord >> -eol;
+
+    BOOST_SPIRIT_DEBUG_NODE(mCsvFileLine);
+  }
+
+  /*
+   * Instantiated once in the library for the most common sources and attributes,
+   * so that they are not compiled again by each user.
+   */
+  extern template struct MDT_PLAINTEXT_EXPORT CsvFileLine< std::string::const_iterator, std::vector<std::string> >;
+  extern template struct MDT_PLAINTEXT_EXPORT CsvFileLine< Mdt::PlainText::Impl::CsvFileSourceIterator, std::vector<std::string> >;
+
 }}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
 
 #endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CSV_FILE_LINE_H
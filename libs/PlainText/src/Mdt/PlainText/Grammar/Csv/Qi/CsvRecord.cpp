@@ -5,3 +5,11 @@
  * https://www.boost.org/LICENSE_1_0.txt)
  */
 #include "CsvRecord.h"
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+  template struct CsvRecord< std::string::const_iterator, std::vector<std::string> >;
+  template struct CsvRecord< Mdt::PlainText::Impl::CsvFileSourceIterator, std::vector<std::string> >;
+  template struct CsvRecord< Mdt::PlainText::Impl::CsvFileSourceIterator, Mdt::PlainText::Impl::CsvFieldCountRecord >;
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
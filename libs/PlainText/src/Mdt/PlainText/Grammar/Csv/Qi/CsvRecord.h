@@ -10,10 +10,12 @@
 #include "FieldColumn.h"
 #include "NonEmptyFieldColumn.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/Impl/CsvFieldCountRecord.h"
+#include "Mdt/PlainText/Impl/CsvFileSourceIterator.h"
+#include "mdt_plaintext_export.h"
 #include <boost/spirit/include/qi.hpp>
-#include <boost/spirit/include/phoenix_core.hpp>
-#include <boost/spirit/include/phoenix_operator.hpp>
-#include <boost/spirit/include/phoenix_stl.hpp>
+#include <string>
+#include <vector>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
@@ -39,9 +41,9 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
    * as well as 1 column records.
    * To avoid empty records, the grammar becomes:
    * \code
-   * CsvRecord = RecordPayload / NonEmptyFieldColumn
-   * RecordPayload = FieldColumn *(COMMA FieldColumn)
+   * CsvRecord = (NonEmptyFieldColumn *(COMMA FieldColumn)) / (EmptyFieldColumn 1*(COMMA FieldColumn))
    * \endcode
+   * Each field is parsed only once, whatever the count of columns is.
    *
    * \note Some part of this API documentation refers to following standards:
    *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
@@ -56,59 +58,90 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
      *
      * \pre \a settings must be valid
      */
-    CsvRecord(const CsvParserSettings & settings) noexcept
-     : CsvRecord::base_type(mCsvRecord, "CsvRecord"),
-       mNonEmptyFieldColumn(settings),
-       mFieldColumn(settings)
-    {
-      assert( settings.isValid() );
-
-      namespace qi = boost::spirit::qi;
-
-      using qi::eol;
-      using qi::lit;
-      using qi::_val;
-      using qi::_1;
-      using boost::phoenix::push_back;
-
-      const char fieldSep = settings.fieldSeparator();
-
-      nameRules();
-
-      /*
-       * Why we use semantic actions here
-       *
-       * When using automatic attributes propagation,
-       * attributes are propagated despite a parser will eventually fail.
-       * For example, parsing "ABC":
-       *  - RecordPayload will parse and propagate attributes
-       *  - RecordPayload fails
-       *  - NonEmptyFieldColumn propagates attributes
-       *  - The result is a record that contains [ABC,ABC]
-       *
-       * Semantic actions are only called when a parser succeeds.
-       */
-      mCsvRecord = mRecordPayload[_val = _1] | mNonEmptyFieldColumn[push_back(_val, _1)];
-      mRecordPayload = mFieldColumn >> lit(fieldSep) >> ( mFieldColumn % lit(fieldSep) );
-
-      BOOST_SPIRIT_DEBUG_NODE(mCsvRecord);
-      BOOST_SPIRIT_DEBUG_NODE(mRecordPayload);
-    }
+    CsvRecord(const CsvParserSettings & settings) noexcept;
 
    private:
 
     void nameRules()
     {
       mCsvRecord.name("CsvRecord");
-      mRecordPayload.name("RecordPayload");
+      mEmptyFieldColumn.name("EmptyFieldColumn");
     }
 
     boost::spirit::qi::rule<SourceIterator, DestinationRecord()> mCsvRecord;
-    boost::spirit::qi::rule<SourceIterator, DestinationRecord()> mRecordPayload;
+    boost::spirit::qi::rule<SourceIterator, StringType()> mEmptyFieldColumn;
     NonEmptyFieldColumn<SourceIterator, StringType> mNonEmptyFieldColumn;
     FieldColumn<SourceIterator, StringType> mFieldColumn;
   };
 
+  /*
+   * Not defined inline, so that the explicit instantiation declarations below
+   * also prevent optimizing compilers from instantiating it.
+   */
+  template <typename SourceIterator, typename DestinationRecord>
+  CsvRecord<SourceIterator, DestinationRecord>::CsvRecord(const CsvParserSettings & settings) noexcept
+   : CsvRecord::base_type(mCsvRecord, "CsvRecord"),
+     mNonEmptyFieldColumn(settings),
+     mFieldColumn(settings)
+  {
+    assert( settings.isValid() );
+
+    namespace qi = boost::spirit::qi;
+
+    using qi::lit;
+    using qi::attr;
+    using qi::repeat;
+
+    const char fieldSep = settings.fieldSeparator();
+    const bool parseExp = settings.parseExp();
+    const int maxColumnCount = settings.maximumColumnCount();
+
+    nameRules();
+
+    /*
+     * Each field must be parsed exactly once,
+     * also for 1 column records.
+     * So, the record is split on its first column:
+     *  - If it is not empty, any count of other columns can follow
+     *  - If it is empty, at least 1 other column must follow,
+     *    otherwise it would be a empty record
+     *
+     * A empty first column is a unprotected field without any char,
+     * except the EXP if parseExp is true.
+     * A protected field, like "", is never empty here.
+     *
+     * The first alternative can only fail on its first column,
+     * so it never propagates a attribute
+     * when the second alternative is used.
+     */
+    if(parseExp){
+      mEmptyFieldColumn = -lit('~') >> attr( StringType() );
+    }else{
+      mEmptyFieldColumn = attr( StringType() );
+    }
+
+    if(maxColumnCount == 1){
+      mCsvRecord = mNonEmptyFieldColumn;
+    }else if(maxColumnCount > 1){
+      mCsvRecord = ( mNonEmptyFieldColumn >> repeat(0, maxColumnCount-1)[lit(fieldSep) >> mFieldColumn] )
+                 | ( mEmptyFieldColumn >> repeat(1, maxColumnCount-1)[lit(fieldSep) >> mFieldColumn] );
+    }else{
+      mCsvRecord = ( mNonEmptyFieldColumn >> *(lit(fieldSep) >> mFieldColumn) )
+                 | ( mEmptyFieldColumn >> +(lit(fieldSep) >> mFieldColumn) );
+    }
+
+    BOOST_SPIRIT_DEBUG_NODE(mCsvRecord);
+    BOOST_SPIRIT_DEBUG_NODE(mEmptyFieldColumn);
+  }
+
+  /*
+   * Instantiated once in the library for the most common sources and attributes,
+   * so that they are not compiled again by each user.
+   */
+  extern template struct MDT_PLAINTEXT_EXPORT CsvRecord< std::string::const_iterator, std::vector<std::string> >;
+  extern template struct MDT_PLAINTEXT_EXPORT CsvRecord< Mdt::PlainText::Impl::CsvFileSourceIterator, std::vector<std::string> >;
+  extern template struct MDT_PLAINTEXT_EXPORT CsvRecord< Mdt::PlainText::Impl::CsvFileSourceIterator, Mdt::PlainText::Impl::CsvFieldCountRecord >;
+
 }}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
 
 #endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_CSV_RECORD_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_FLUSH_MULTI_PASS_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_FLUSH_MULTI_PASS_H
+
+#include "Mdt/PlainText/Impl/MultiPassQueue.h"
+#include <boost/spirit/include/qi.hpp>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+  /*! \brief Parser that releases the already consumed input of a multi pass iterator
+   *
+   * Always succeeds without consuming anything.
+   *
+   * If the source iterator is a boost::spirit::multi_pass ,
+   * possibly wrapped in a PositionTrackingIterator ,
+   * its buffer is cleared, so all the input consumed so far is released.
+   * For other iterators, this parser does nothing.
+   *
+   * This is similar to boost::spirit::repository::qi::flush_multi_pass ,
+   * but also works with a wrapped multi pass iterator.
+   *
+   * \warning The buffer is cleared even if other copies of the source iterator
+   *  still exist, for example saved by a enclosing parser to backtrack.
+   *  Those copies then refer to released input and must not be used anymore.
+   *  So, after this parser, the grammar must never backtrack
+   *  before the current position.
+   *  A grammar that uses FlushMultiPass must only place it
+   *  where no enclosing parser can go back before it:
+   *  CsvFile flushes after each complete record,
+   *  and a record that follows can only fail back to the end of the flushed one.
+   */
+  struct FlushMultiPass : boost::spirit::qi::primitive_parser<FlushMultiPass>
+  {
+    template<typename Context, typename SourceIterator>
+    struct attribute
+    {
+      using type = boost::spirit::unused_type;
+    };
+
+    template<typename SourceIterator, typename Context, typename Skipper, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator &, Context &, const Skipper &, Attribute &) const
+    {
+      Mdt::PlainText::Impl::MultiPassQueue<SourceIterator>::clear(first);
+
+      return true;
+    }
+
+    template<typename Context>
+    boost::spirit::info what(Context &) const
+    {
+      return boost::spirit::info("FlushMultiPass");
+    }
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_FLUSH_MULTI_PASS_H
@@ -44,21 +44,31 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
       namespace qi = boost::spirit::qi;
 
       using qi::lit;
+      using qi::repeat;
 
       const bool parseExp = settings.parseExp();
+      const int64_t maxLength = settings.maximumFieldLength();
+
+      if(maxLength > 0){
+        mFieldPayload = repeat(static_cast<int64_t>(1), maxLength)[mChar];
+      }else{
+        mFieldPayload = +mChar;
+      }
 
       if(parseExp){
-        mNonEmptyUnprotectedField = -lit('~') >> +mChar;
+        mNonEmptyUnprotectedField = -lit('~') >> mFieldPayload;
       }else{
-        mNonEmptyUnprotectedField = +mChar;
+        mNonEmptyUnprotectedField = mFieldPayload;
       }
 
       BOOST_SPIRIT_DEBUG_NODE(mNonEmptyUnprotectedField);
+      BOOST_SPIRIT_DEBUG_NODE(mFieldPayload);
     }
 
    private:
 
     boost::spirit::qi::rule<SourceIterator, DestinationString()> mNonEmptyUnprotectedField;
+    boost::spirit::qi::rule<SourceIterator, DestinationString()> mFieldPayload;
     Char<SourceIterator, uint32_t> mChar;
   };
 
@@ -8,9 +8,11 @@
 #define MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_PROTECTED_FIELD_H
 
 #include "Char.h"
+#include "CharClassParser.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
 #include <boost/spirit/include/qi.hpp>
 #include <cstdint>
+#include <type_traits>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
@@ -38,12 +40,11 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
       namespace qi = boost::spirit::qi;
 
       using qi::lit;
-      using boost::spirit::unicode::char_;
-      using boost::spirit::unicode::space;
+      using qi::repeat;
 
-      const char fieldSep = settings.fieldSeparator();
       const char fieldQuote = settings.fieldProtection();
       const bool parseExp = settings.parseExp();
+      const int64_t maxLength = settings.maximumFieldLength();
 
       nameRules();
 
@@ -52,9 +53,12 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
       }else{
         mProtectedField = lit(fieldQuote) >> mFieldPayload >> lit(fieldQuote);
       }
-      mFieldPayload = *mAnychar;
-      // Character collections
-      mAnychar = mChar | char_(fieldSep) | (char_(fieldQuote) >> lit(fieldQuote)) | space; // space matches space, CR, LF and other See std::isspace()
+      if(maxLength > 0){
+        mFieldPayload = repeat(static_cast<int64_t>(0), maxLength)[mAnychar];
+      }else{
+        mFieldPayload = *mAnychar;
+      }
+      defineAnychar( settings, IsByteSourceIterator<SourceIterator>() );
 
       BOOST_SPIRIT_DEBUG_NODE(mProtectedField);
       BOOST_SPIRIT_DEBUG_NODE(mFieldPayload);
@@ -63,6 +67,33 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
 
    private:
 
+    /*
+     * For a 8-bit source, any char except the field protection is looked up in a table,
+     * which gives the same result as the character collections below.
+     */
+    void defineAnychar(const CsvParserSettings & settings, std::true_type) noexcept
+    {
+      using boost::spirit::qi::lit;
+      using boost::spirit::unicode::char_;
+
+      const char fieldQuote = settings.fieldProtection();
+
+      mAnychar = CharClassParser( CharClassTable(settings), CharClass::ProtectedFieldChar ) | (char_(fieldQuote) >> lit(fieldQuote));
+    }
+
+    void defineAnychar(const CsvParserSettings & settings, std::false_type) noexcept
+    {
+      using boost::spirit::qi::lit;
+      using boost::spirit::unicode::char_;
+      using boost::spirit::unicode::space;
+
+      const char fieldSep = settings.fieldSeparator();
+      const char fieldQuote = settings.fieldProtection();
+
+      // Character collections
+      mAnychar = mChar | char_(fieldSep) | (char_(fieldQuote) >> lit(fieldQuote)) | space; // space matches space, CR, LF and other See std::isspace()
+    }
+
     void nameRules()
     {
       mFieldPayload.name("FieldPayload");
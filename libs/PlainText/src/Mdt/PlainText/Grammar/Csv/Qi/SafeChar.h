@@ -7,10 +7,12 @@
 #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_SAFE_CHAR_H
 #define MDT_PLAIN_TEXT_GRAMMAR_CSV_QI_SAFE_CHAR_H
 
+#include "CharClassParser.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
 #include <boost/spirit/include/qi.hpp>
 #include <cassert>
 #include <string>
+#include <type_traits>
 
 namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace Qi{
 
@@ -33,23 +35,34 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
     {
       assert( settings.isValid() );
 
-      namespace qi = boost::spirit::qi;
+      nameRules();
+
+      defineSafeChar( settings, IsByteSourceIterator<SourceIterator>() );
+
+      BOOST_SPIRIT_DEBUG_NODE(mSafeChar);
+    }
+
+   private:
+
+    /*
+     * For a 8-bit source, the class of each char is looked up in a table
+     */
+    void defineSafeChar(const CsvParserSettings & settings, std::true_type) noexcept
+    {
+      mSafeChar = CharClassParser( CharClassTable(settings), CharClass::SafeChar );
+    }
 
+    void defineSafeChar(const CsvParserSettings & settings, std::false_type) noexcept
+    {
       using boost::spirit::unicode::char_;
 
       const char fieldSep = settings.fieldSeparator();
       const char fieldQuote = settings.fieldProtection();
 
-      nameRules();
-
       const std::string exclude = std::string("\n\t\r ") + fieldSep + fieldQuote;
       mSafeChar = ~char_(exclude);
-
-      BOOST_SPIRIT_DEBUG_NODE(mSafeChar);
     }
 
-   private:
-
     void nameRules()
     {
       mSafeChar.name("SafeChar");
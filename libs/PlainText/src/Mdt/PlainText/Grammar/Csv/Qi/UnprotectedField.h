@@ -44,21 +44,31 @@ namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace
       namespace qi = boost::spirit::qi;
 
       using qi::lit;
+      using qi::repeat;
 
       const bool parseExp = settings.parseExp();
+      const int64_t maxLength = settings.maximumFieldLength();
+
+      if(maxLength > 0){
+        mFieldPayload = repeat(static_cast<int64_t>(0), maxLength)[mChar];
+      }else{
+        mFieldPayload = *mChar;
+      }
 
       if(parseExp){
-        mUnprotectedField = -lit('~') >> *mChar;
+        mUnprotectedField = -lit('~') >> mFieldPayload;
       }else{
-        mUnprotectedField = *mChar;
+        mUnprotectedField = mFieldPayload;
       }
 
       BOOST_SPIRIT_DEBUG_NODE(mUnprotectedField);
+      BOOST_SPIRIT_DEBUG_NODE(mFieldPayload);
     }
 
    private:
 
     boost::spirit::qi::rule<SourceIterator, DestinationString()> mUnprotectedField;
+    boost::spirit::qi::rule<SourceIterator, DestinationString()> mFieldPayload;
     Char<SourceIterator, uint32_t> mChar;
   };
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CHAR_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CHAR_H
+
+#include "SafeChar.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief Char parser
+   *
+   * Matches a SafeChar or a space.
+   *
+   * \note Some part of this API documentation refers to following standards:
+   *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
+   *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
+   */
+  template<typename Dialect = RuntimeCsvDialect>
+  struct Char : boost::spirit::x3::parser< Char<Dialect> >
+  {
+    using attribute_type = uint32_t;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit Char(const CsvParserSettings & settings) noexcept
+     : mSafeChar(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext &, Attribute & attribute) const
+    {
+      boost::spirit::x3::skip_over(first, last, context);
+      if(first == last){
+        return false;
+      }
+      const uint32_t codePoint = static_cast<uint32_t>(*first);
+      if( (codePoint != ' ') && !mSafeChar.isSafeChar(codePoint) ){
+        return false;
+      }
+      boost::spirit::x3::traits::move_to(codePoint, attribute);
+      ++first;
+
+      return true;
+    }
+
+   private:
+
+    SafeChar<Dialect> mSafeChar;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CHAR_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_FILE_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_FILE_H
+
+#include "CsvRecord.h"
+#include "FlushMultiPass.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  namespace Impl{
+
+    /*! \internal CSV record followed by a FlushMultiPass
+     *
+     * Using a X3 sequence, like CsvRecord >> FlushMultiPass,
+     * in a list would parse each record into a temporary table,
+     * which is then appended to the table.
+     */
+    template<typename DestinationRecord, typename Dialect>
+    struct FlushedCsvRecord : boost::spirit::x3::parser< FlushedCsvRecord<DestinationRecord, Dialect> >
+    {
+      using attribute_type = DestinationRecord;
+      static const bool has_attribute = true;
+
+      explicit FlushedCsvRecord(const CsvParserSettings & settings) noexcept
+       : mRecord(settings)
+      {
+      }
+
+      template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+      bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+      {
+        if( !mRecord.parse(first, last, context, rcontext, attribute) ){
+          return false;
+        }
+
+        return FlushMultiPass().parse(first, last, context, rcontext, boost::spirit::x3::unused);
+      }
+
+     private:
+
+      CsvRecord<DestinationRecord, Dialect> mRecord;
+    };
+
+  } // namespace Impl{
+
+  /*! \brief CSV file parser
+   *
+   * Same grammar as Qi::CsvFile :
+   * \code
+   * CsvFile = CsvRecord *(EOL CsvRecord) [EOL]
+   * \endcode
+   * Once a record has been parsed,
+   * the input it used is released if the source iterator is a multi pass iterator.
+   *
+   * \sa FlushMultiPass
+   * \note Some part of this API documentation refers to following standards:
+   *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
+   *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
+   */
+  template <typename DestinationTable, typename Dialect = RuntimeCsvDialect>
+  struct CsvFile : boost::spirit::x3::parser< CsvFile<DestinationTable, Dialect> >
+  {
+    using Record = typename DestinationTable::value_type;
+    using attribute_type = DestinationTable;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit CsvFile(const CsvParserSettings & settings) noexcept
+     : mRecord(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      return ( (mRecord % x3::eol) >> -x3::eol ).parse(first, last, context, rcontext, attribute);
+    }
+
+   private:
+
+    Impl::FlushedCsvRecord<Record, Dialect> mRecord;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_FILE_H
@@ -0,0 +1,226 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_RAW_RECORD_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_RAW_RECORD_H
+
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include "Mdt/PlainText/CsvRawField.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief CSV record parser that does not decode the fields
+   *
+   * Accepts exactly the same records as CsvRecord ,
+   * including the limits defined in the settings,
+   * but each field is stored as a CsvRawField ,
+   * which refers to its payload in the source.
+   * Whether a protected field contains doubled field protections
+   * is found while scanning it, so a field is only unescaped
+   * if its value is requested.
+   * This is useful when only some columns, or some records, are used.
+   *
+   * \a DestinationRecord is a container of CsvRawField ,
+   * for example std::vector< CsvRawField<SourceIterator> > .
+   *
+   * The source must remain valid as long as the fields are used,
+   * so this parser is not suitable for a multi pass iterator
+   * that releases its buffer, like the one of CsvFileReaderTemplate .
+   */
+  template <typename DestinationRecord, typename Dialect = RuntimeCsvDialect>
+  struct CsvRawRecord : boost::spirit::x3::parser< CsvRawRecord<DestinationRecord, Dialect> >
+  {
+    using RawField = typename DestinationRecord::value_type;
+    using attribute_type = DestinationRecord;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit CsvRawRecord(const CsvParserSettings & settings) noexcept
+     : mDialect(settings),
+       mMaximumFieldLength( settings.maximumFieldLength() ),
+       mMaximumColumnCount( settings.maximumColumnCount() )
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext &, Attribute & attribute) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      x3::skip_over(first, last, context);
+
+      SourceIterator current = first;
+      RawField column;
+
+      /*
+       * Same as CsvRecord:
+       * a empty first column must be followed by at least 1 other column
+       */
+      const bool firstColumnIsEmpty = !parseFieldColumn(current, last, column, true);
+      if(firstColumnIsEmpty){
+        skipExp(current, last);
+        if( !isNextColumn(current, last, 1) ){
+          return false;
+        }
+        column = RawField(current, current, mDialect.fieldProtection(), false);
+      }
+      x3::traits::push_back( attribute, std::move(column) );
+
+      int columnCount = 1;
+      while( isNextColumn(current, last, columnCount) ){
+        ++current;
+        parseFieldColumn(current, last, column, false);
+        x3::traits::push_back( attribute, std::move(column) );
+        ++columnCount;
+      }
+      first = current;
+
+      return true;
+    }
+
+   private:
+
+    template<typename SourceIterator>
+    bool isNextColumn(const SourceIterator & first, const SourceIterator & last, int columnCount) const noexcept
+    {
+      if( (mMaximumColumnCount > 0) && (columnCount >= mMaximumColumnCount) ){
+        return false;
+      }
+
+      return (first != last) && ( static_cast<uint32_t>(*first) == static_cast<uint32_t>(mDialect.fieldSeparator()) );
+    }
+
+    /*
+     * Like FieldColumn (or NonEmptyFieldColumn if nonEmpty is true):
+     * a protected field, or, if it fails, a unprotected field
+     */
+    template<typename SourceIterator>
+    bool parseFieldColumn(SourceIterator & first, const SourceIterator & last, RawField & field, bool nonEmpty) const
+    {
+      if( parseProtectedField(first, last, field) ){
+        return true;
+      }
+
+      return parseUnprotectedField(first, last, field, nonEmpty);
+    }
+
+    /*
+     * Like ProtectedField:
+     * a doubled field protection counts as 1 char of the payload
+     * and tells that the field needs to be unescaped
+     */
+    template<typename SourceIterator>
+    bool parseProtectedField(SourceIterator & first, const SourceIterator & last, RawField & field) const
+    {
+      const uint32_t fieldProtection = static_cast<uint32_t>( mDialect.fieldProtection() );
+
+      if( (first == last) || (static_cast<uint32_t>(*first) != fieldProtection) ){
+        return false;
+      }
+      SourceIterator current = first;
+      ++current;
+      skipExp(current, last);
+
+      const SourceIterator payloadBegin = current;
+      int64_t length = 0;
+      bool needsUnescape = false;
+
+      while(current != last){
+        const bool maximumLengthReached = (mMaximumFieldLength > 0) && (length >= mMaximumFieldLength);
+        if(static_cast<uint32_t>(*current) == fieldProtection){
+          SourceIterator next = current;
+          ++next;
+          if( maximumLengthReached || (next == last) || (static_cast<uint32_t>(*next) != fieldProtection) ){
+            break;
+          }
+          needsUnescape = true;
+          current = ++next;
+        }else{
+          if(maximumLengthReached){
+            return false;
+          }
+          ++current;
+        }
+        ++length;
+      }
+      if(current == last){
+        return false;
+      }
+
+      field = RawField(payloadBegin, current, mDialect.fieldProtection(), needsUnescape);
+      first = ++current;
+
+      return true;
+    }
+
+    /*
+     * Like UnprotectedField (or NonEmptyUnprotectedField if nonEmpty is true)
+     */
+    template<typename SourceIterator>
+    bool parseUnprotectedField(SourceIterator & first, const SourceIterator & last, RawField & field, bool nonEmpty) const
+    {
+      SourceIterator current = first;
+      skipExp(current, last);
+
+      const SourceIterator payloadBegin = current;
+      int64_t length = 0;
+
+      while( (current != last) && isChar(*current) ){
+        if( (mMaximumFieldLength > 0) && (length >= mMaximumFieldLength) ){
+          break;
+        }
+        ++current;
+        ++length;
+      }
+      if( nonEmpty && (length == 0) ){
+        return false;
+      }
+
+      field = RawField(payloadBegin, current, mDialect.fieldProtection(), false);
+      first = current;
+
+      return true;
+    }
+
+    /*
+     * Same chars as Char
+     */
+    template<typename CharType>
+    bool isChar(CharType c) const noexcept
+    {
+      const uint32_t codePoint = static_cast<uint32_t>(c);
+
+      return (codePoint != '\n') && (codePoint != '\t') && (codePoint != '\r')
+          && ( codePoint != static_cast<uint32_t>(mDialect.fieldSeparator()) )
+          && ( codePoint != static_cast<uint32_t>(mDialect.fieldProtection()) );
+    }
+
+    template<typename SourceIterator>
+    void skipExp(SourceIterator & first, const SourceIterator & last) const noexcept
+    {
+      if( mDialect.parseExp() && (first != last) && (static_cast<uint32_t>(*first) == '~') ){
+        ++first;
+      }
+    }
+
+    Dialect mDialect;
+    int64_t mMaximumFieldLength;
+    int mMaximumColumnCount;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_RAW_RECORD_H
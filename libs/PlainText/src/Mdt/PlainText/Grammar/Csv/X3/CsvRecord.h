@@ -0,0 +1,150 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_RECORD_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_RECORD_H
+
+#include "FieldColumn.h"
+#include "NonEmptyFieldColumn.h"
+#include "OptionalExp.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief CSV record parser
+   *
+   * Same grammar as Qi::CsvRecord :
+   * \code
+   * CsvRecord = (NonEmptyFieldColumn *(COMMA FieldColumn)) / (EmptyFieldColumn 1*(COMMA FieldColumn))
+   * \endcode
+   * Each field is parsed only once, whatever the count of columns is.
+   * If a maximum column count is defined, a record can not have more columns.
+   *
+   * Like all the X3 parsers, CsvRecord can be instantiated with a CsvDialect ,
+   * for example with visitCsvDialect() .
+   *
+   * \note Some part of this API documentation refers to following standards:
+   *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
+   *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
+   */
+  template <typename DestinationRecord, typename Dialect = RuntimeCsvDialect>
+  struct CsvRecord : boost::spirit::x3::parser< CsvRecord<DestinationRecord, Dialect> >
+  {
+    using StringType = typename DestinationRecord::value_type;
+    using attribute_type = DestinationRecord;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit CsvRecord(const CsvParserSettings & settings) noexcept
+     : mDialect(settings),
+       mMaximumColumnCount( settings.maximumColumnCount() ),
+       mOptionalExp(settings),
+       mNonEmptyFieldColumn(settings),
+       mFieldColumn(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      /*
+       * The columns are added one by one to the record.
+       * Using X3 operators, like *(COMMA FieldColumn),
+       * the columns after the first one would be parsed into a temporary record,
+       * which is then appended to the record.
+       *
+       * See Qi::CsvRecord for the details about the empty first column.
+       */
+      SourceIterator current = first;
+      StringType firstColumn;
+
+      const bool firstColumnIsEmpty = !mNonEmptyFieldColumn.parse(current, last, context, rcontext, firstColumn);
+      if(firstColumnIsEmpty){
+        mOptionalExp.parse(current, last, context, rcontext, x3::unused);
+        if( !parseNextColumn(current, last, context, rcontext, attribute, 1, &firstColumn) ){
+          return false;
+        }
+      }else{
+        x3::traits::push_back( attribute, std::move(firstColumn) );
+      }
+
+      parseColumnsAfter(current, last, context, rcontext, attribute, firstColumnIsEmpty ? 2 : 1);
+      first = current;
+
+      return true;
+    }
+
+    /*! \internal Parse the columns that follow the \a columnCount columns already added to \a attribute
+     *
+     * \a first must be at the field separator that follows the last of those columns,
+     * or at the end of the record.
+     *
+     * Used by HybridCsvRecord to continue a record that it began to split.
+     */
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    void parseColumnsAfter(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext,
+                           Attribute & attribute, int columnCount) const
+    {
+      while( parseNextColumn(first, last, context, rcontext, attribute, columnCount, nullptr) ){
+        ++columnCount;
+      }
+    }
+
+   private:
+
+    /*
+     * Parse a field separator followed by a FieldColumn
+     * and add it to the record.
+     * If previousColumn is not null, it is added to the record before.
+     *
+     * Fails if the maximum column count is reached.
+     */
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parseNextColumn(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext,
+                         Attribute & attribute, int columnCount, StringType *previousColumn) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      if( (mMaximumColumnCount > 0) && (columnCount >= mMaximumColumnCount) ){
+        return false;
+      }
+      if( (first == last) || ( static_cast<uint32_t>(*first) != static_cast<uint32_t>(mDialect.fieldSeparator()) ) ){
+        return false;
+      }
+      ++first;
+
+      StringType column;
+      mFieldColumn.parse(first, last, context, rcontext, column);
+      if(previousColumn != nullptr){
+        x3::traits::push_back( attribute, std::move(*previousColumn) );
+      }
+      x3::traits::push_back( attribute, std::move(column) );
+
+      return true;
+    }
+
+    Dialect mDialect;
+    int mMaximumColumnCount;
+    OptionalExp<Dialect> mOptionalExp;
+    NonEmptyFieldColumn<StringType, Dialect> mNonEmptyFieldColumn;
+    FieldColumn<StringType, Dialect> mFieldColumn;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_CSV_RECORD_H
@@ -0,0 +1,62 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_FIELD_COLUMN_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_FIELD_COLUMN_H
+
+#include "ProtectedField.h"
+#include "UnprotectedField.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief CSV field column parser
+   *
+   * Same grammar as Qi::FieldColumn :
+   * \code
+   * FieldColumn = ProtectedField / UnprotectedField
+   * \endcode
+   *
+   * \note Some part of this API documentation refers to following standards:
+   *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
+   *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
+   */
+  template <typename DestinationString, typename Dialect = RuntimeCsvDialect>
+  struct FieldColumn : boost::spirit::x3::parser< FieldColumn<DestinationString, Dialect> >
+  {
+    using attribute_type = DestinationString;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit FieldColumn(const CsvParserSettings & settings) noexcept
+     : mProtectedField(settings),
+       mUnprotectedField(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+    {
+      return ( mProtectedField | mUnprotectedField ).parse(first, last, context, rcontext, attribute);
+    }
+
+   private:
+
+    ProtectedField<DestinationString, Dialect> mProtectedField;
+    UnprotectedField<DestinationString, Dialect> mUnprotectedField;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_FIELD_COLUMN_H
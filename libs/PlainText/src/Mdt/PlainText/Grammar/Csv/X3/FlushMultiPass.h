@@ -0,0 +1,41 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_FLUSH_MULTI_PASS_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_FLUSH_MULTI_PASS_H
+
+#include "Mdt/PlainText/Impl/MultiPassQueue.h"
+#include <boost/spirit/home/x3.hpp>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief Parser that releases the already consumed input of a multi pass iterator
+   *
+   * This is the X3 version of Qi::FlushMultiPass .
+   *
+   * \warning Like Qi::FlushMultiPass , the buffer is cleared
+   *  even if other copies of the source iterator still exist.
+   *  After this parser, the grammar must never backtrack
+   *  before the current position.
+   *  CsvFile respects this by flushing only after a complete record.
+   */
+  struct FlushMultiPass : boost::spirit::x3::parser<FlushMultiPass>
+  {
+    using attribute_type = boost::spirit::x3::unused_type;
+    static const bool has_attribute = false;
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator &, const Context &, RContext &, Attribute &) const
+    {
+      Mdt::PlainText::Impl::MultiPassQueue<SourceIterator>::clear(first);
+
+      return true;
+    }
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_FLUSH_MULTI_PASS_H
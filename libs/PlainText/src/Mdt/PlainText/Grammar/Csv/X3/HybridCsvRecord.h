@@ -0,0 +1,331 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_HYBRID_CSV_RECORD_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_HYBRID_CSV_RECORD_H
+
+#include "CsvRecord.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  namespace Impl{
+
+    /*! \internal Check if SourceIterator refers to chars that are contiguous in memory
+     */
+    template<typename SourceIterator>
+    struct IsContiguousCharIterator : std::integral_constant<bool,
+      std::is_same<SourceIterator, const char*>::value
+      || std::is_same<SourceIterator, char*>::value
+      || std::is_same<SourceIterator, std::string::const_iterator>::value
+      || std::is_same<SourceIterator, std::string::iterator>::value
+    >
+    {
+    };
+
+    /*! \internal Find the first \a c in [first, last) , or last
+     *
+     * \a SourceIterator must refer to chars that are contiguous in memory.
+     */
+    template<typename SourceIterator>
+    SourceIterator findChar(const SourceIterator & first, const SourceIterator & last, char c) noexcept
+    {
+      if(first == last){
+        return last;
+      }
+      const char *begin = &*first;
+      const auto length = static_cast<std::size_t>( std::distance(first, last) );
+      const void *found = std::memchr( begin, c, length );
+      if(found == nullptr){
+        return last;
+      }
+
+      return first + ( static_cast<const char*>(found) - begin );
+    }
+
+    /*! \internal Find the end of the line that begins at \a first
+     *
+     * Returns false if a \a fieldProtection,
+     * or a tab that is not the \a fieldSeparator ,
+     * is found before the end of the line,
+     * in which case \a lineEnd is not set.
+     *
+     * \a SourceIterator must refer to chars that are contiguous in memory.
+     */
+    template<typename SourceIterator>
+    bool findSimpleLineEnd(const SourceIterator & first, const SourceIterator & last, char fieldSeparator, char fieldProtection,
+                           SourceIterator & lineEnd) noexcept
+    {
+      SourceIterator end = findChar(first, last, '\n');
+      end = findChar(first, end, '\r');
+      if( findChar(first, end, fieldProtection) != end ){
+        return false;
+      }
+      if( (fieldSeparator != '\t') && (findChar(first, end, '\t') != end) ){
+        return false;
+      }
+      lineEnd = end;
+
+      return true;
+    }
+
+  } // namespace Impl{
+
+  /*! \brief CSV record parser with a fast path for records without field protection
+   *
+   * Gives exactly the same result as CsvRecord ,
+   * including the limits defined in the settings.
+   *
+   * The end of the line that begins at the current position is searched first.
+   * If it contains no field protection (and no tab, which ends a unprotected field,
+   * unless it is the field separator),
+   * the line is a record made of unprotected fields only.
+   * It is then split on the field separator, and the EXP of each field removed,
+   * without going through the field parsers.
+   * If the source is contiguous in memory, like a std::string ,
+   * the searches use std::memchr() .
+   *
+   * Other sources, like the multi pass iterator used by CsvFileReader ,
+   * are read only once: the fields are added to the attribute
+   * while the line is scanned.
+   * Scanning ahead would make a multi pass iterator buffer the whole line,
+   * which is then read again, and would be slower than CsvRecord .
+   * When a protected field begins after the first column,
+   * CsvRecord continues the record from the preceding field separator.
+   * In the other cases, the fields are removed again
+   * and the whole record is parsed by CsvRecord .
+   * This requires a empty attribute, otherwise CsvRecord is used.
+   *
+   * Any other record is parsed by CsvRecord .
+   * This is also the case of records that exceed a limit of the settings,
+   * so that they are handled exactly as by CsvRecord .
+   */
+  template <typename DestinationRecord, typename Dialect = RuntimeCsvDialect>
+  struct HybridCsvRecord : boost::spirit::x3::parser< HybridCsvRecord<DestinationRecord, Dialect> >
+  {
+    using StringType = typename DestinationRecord::value_type;
+    using attribute_type = DestinationRecord;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit HybridCsvRecord(const CsvParserSettings & settings) noexcept
+     : mDialect(settings),
+       mMaximumFieldLength( settings.maximumFieldLength() ),
+       mMaximumColumnCount( settings.maximumColumnCount() ),
+       mCsvRecord(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+    {
+      boost::spirit::x3::skip_over(first, last, context);
+
+      return parse(first, last, context, rcontext, attribute, Impl::IsContiguousCharIterator<SourceIterator>());
+    }
+
+   private:
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute, std::true_type) const
+    {
+      SourceIterator lineEnd;
+      if( Impl::findSimpleLineEnd(first, last, mDialect.fieldSeparator(), mDialect.fieldProtection(), lineEnd) && isSimpleRecord(first, lineEnd) ){
+        splitRecord(first, lineEnd, attribute);
+        first = lineEnd;
+        return true;
+      }
+
+      return mCsvRecord.parse(first, last, context, rcontext, attribute);
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute, std::false_type) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      if( !x3::traits::is_empty(attribute) ){
+        return mCsvRecord.parse(first, last, context, rcontext, attribute);
+      }
+
+      const uint32_t fieldSeparator = static_cast<uint32_t>( mDialect.fieldSeparator() );
+      const uint32_t fieldProtection = static_cast<uint32_t>( mDialect.fieldProtection() );
+      const bool tabIsSeparator = (fieldSeparator == '\t');
+
+      SourceIterator it = first;
+      SourceIterator lastSeparator;
+      StringType field;
+      int64_t fieldLength = 0;
+      int columnCount = 1;
+      bool atFieldBegin = true;
+
+      while(it != last){
+        const uint32_t codePoint = static_cast<uint32_t>(*it);
+        if( (codePoint == '\n') || (codePoint == '\r') ){
+          break;
+        }
+        if( (codePoint == fieldProtection) && atFieldBegin && (columnCount > 1) ){
+          /*
+           * The columns before are unprotected fields that CsvRecord would give the same way,
+           * so it continues at the field separator that precedes this field.
+           */
+          mCsvRecord.parseColumnsAfter(lastSeparator, last, context, rcontext, attribute, columnCount - 1);
+          first = lastSeparator;
+          return true;
+        }
+        if( (codePoint == fieldProtection) || ( (codePoint == '\t') && !tabIsSeparator ) ){
+          return parseWithCsvRecord(first, last, context, rcontext, attribute);
+        }
+        if(codePoint == fieldSeparator){
+          ++columnCount;
+          if( (mMaximumColumnCount > 0) && (columnCount > mMaximumColumnCount) ){
+            return parseWithCsvRecord(first, last, context, rcontext, attribute);
+          }
+          x3::traits::push_back( attribute, std::move(field) );
+          field = StringType();
+          fieldLength = 0;
+          atFieldBegin = true;
+          lastSeparator = it;
+        }else if( atFieldBegin && mDialect.parseExp() && (codePoint == '~') ){
+          atFieldBegin = false;
+        }else{
+          ++fieldLength;
+          if( (mMaximumFieldLength > 0) && (fieldLength > mMaximumFieldLength) ){
+            return parseWithCsvRecord(first, last, context, rcontext, attribute);
+          }
+          x3::traits::push_back(field, *it);
+          atFieldBegin = false;
+        }
+        ++it;
+      }
+
+      // A record with a single empty column is not valid
+      if( (columnCount == 1) && (fieldLength == 0) ){
+        return parseWithCsvRecord(first, last, context, rcontext, attribute);
+      }
+      x3::traits::push_back( attribute, std::move(field) );
+      first = it;
+
+      return true;
+    }
+
+    /*
+     * Drop the fields added to attribute so far
+     * and parse the record from first with CsvRecord
+     */
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parseWithCsvRecord(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+    {
+      attribute.clear();
+
+      return mCsvRecord.parse(first, last, context, rcontext, attribute);
+    }
+
+    /*
+     * Check that the unprotected fields of [first, last)
+     * are a record that CsvRecord would parse completely.
+     */
+    template<typename SourceIterator>
+    bool isSimpleRecord(const SourceIterator & first, const SourceIterator & last) const
+    {
+      const char fieldSeparator = mDialect.fieldSeparator();
+
+      if( (mMaximumFieldLength == 0) && (mMaximumColumnCount == 0) ){
+        return !isSingleEmptyColumn(first, last);
+      }
+
+      int columnCount = 0;
+      SourceIterator fieldBegin = first;
+      while(true){
+        ++columnCount;
+        if( (mMaximumColumnCount > 0) && (columnCount > mMaximumColumnCount) ){
+          return false;
+        }
+        const SourceIterator fieldEnd = Impl::findChar(fieldBegin, last, fieldSeparator);
+        if(mMaximumFieldLength > 0){
+          SourceIterator payloadBegin = fieldBegin;
+          skipExp(payloadBegin, fieldEnd);
+          if( std::distance(payloadBegin, fieldEnd) > mMaximumFieldLength ){
+            return false;
+          }
+        }
+        if(fieldEnd == last){
+          break;
+        }
+        fieldBegin = fieldEnd;
+        ++fieldBegin;
+      }
+
+      return !isSingleEmptyColumn(first, last);
+    }
+
+    /*
+     * A record with a single empty column is not valid
+     */
+    template<typename SourceIterator>
+    bool isSingleEmptyColumn(const SourceIterator & first, const SourceIterator & last) const
+    {
+      SourceIterator payloadBegin = first;
+      skipExp(payloadBegin, last);
+
+      return payloadBegin == last;
+    }
+
+    template<typename SourceIterator, typename Attribute>
+    void splitRecord(const SourceIterator & first, const SourceIterator & last, Attribute & attribute) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      const char fieldSeparator = mDialect.fieldSeparator();
+      SourceIterator fieldBegin = first;
+
+      while(true){
+        const SourceIterator fieldEnd = Impl::findChar(fieldBegin, last, fieldSeparator);
+        SourceIterator payloadBegin = fieldBegin;
+        skipExp(payloadBegin, fieldEnd);
+        StringType field;
+        x3::traits::append(field, payloadBegin, fieldEnd);
+        x3::traits::push_back( attribute, std::move(field) );
+        if(fieldEnd == last){
+          return;
+        }
+        fieldBegin = fieldEnd;
+        ++fieldBegin;
+      }
+    }
+
+    template<typename SourceIterator>
+    void skipExp(SourceIterator & first, const SourceIterator & last) const noexcept
+    {
+      if( mDialect.parseExp() && (first != last) && (static_cast<uint32_t>(*first) == '~') ){
+        ++first;
+      }
+    }
+
+    Dialect mDialect;
+    int64_t mMaximumFieldLength;
+    int mMaximumColumnCount;
+    CsvRecord<DestinationRecord, Dialect> mCsvRecord;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_HYBRID_CSV_RECORD_H
@@ -0,0 +1,65 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_OPTIONAL_EXP_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_OPTIONAL_EXP_H
+
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief Optional EXP parser
+   *
+   * If the settings tells to parse the Excel protection marker (EXP),
+   * consumes a ~ if the source begins with it.
+   * Otherwise, does nothing.
+   *
+   * Always succeeds, and has no attribute.
+   * This is the same as \code -lit('~') \endcode
+   * in the Qi grammar, but selected at runtime.
+   *
+   * \sa CsvParserSettings::setParseExp()
+   */
+  template<typename Dialect = RuntimeCsvDialect>
+  struct OptionalExp : boost::spirit::x3::parser< OptionalExp<Dialect> >
+  {
+    using attribute_type = boost::spirit::x3::unused_type;
+    static const bool has_attribute = false;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit OptionalExp(const CsvParserSettings & settings) noexcept
+     : mDialect(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext &, Attribute &) const
+    {
+      boost::spirit::x3::skip_over(first, last, context);
+      if( mDialect.parseExp() && (first != last) && (static_cast<uint32_t>(*first) == '~') ){
+        ++first;
+      }
+
+      return true;
+    }
+
+   private:
+
+    Dialect mDialect;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_OPTIONAL_EXP_H
@@ -0,0 +1,152 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_PROTECTED_FIELD_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_PROTECTED_FIELD_H
+
+#include "OptionalExp.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  namespace Impl{
+
+    /*! \internal Char of a protected field payload
+     *
+     * In Qi::ProtectedField , a Anychar is a Char, a field separator,
+     * 2 field protection chars (which gives 1 field protection char) or a space
+     * (space, CR, LF and other See std::isspace()).
+     * This is any char, except a lone field protection char.
+     */
+    template<typename Dialect>
+    struct ProtectedFieldChar : boost::spirit::x3::parser< ProtectedFieldChar<Dialect> >
+    {
+      using attribute_type = uint32_t;
+      static const bool has_attribute = true;
+
+      explicit ProtectedFieldChar(const CsvParserSettings & settings) noexcept
+       : mDialect(settings)
+      {
+      }
+
+      template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+      bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext &, Attribute & attribute) const
+      {
+        boost::spirit::x3::skip_over(first, last, context);
+        if(first == last){
+          return false;
+        }
+        const uint32_t codePoint = static_cast<uint32_t>(*first);
+        const uint32_t fieldProtection = static_cast<uint32_t>( mDialect.fieldProtection() );
+        if(codePoint != fieldProtection){
+          boost::spirit::x3::traits::move_to(codePoint, attribute);
+          ++first;
+          return true;
+        }
+        SourceIterator next = first;
+        ++next;
+        if( (next == last) || (static_cast<uint32_t>(*next) != fieldProtection) ){
+          return false;
+        }
+        boost::spirit::x3::traits::move_to(codePoint, attribute);
+        first = ++next;
+
+        return true;
+      }
+
+     private:
+
+      Dialect mDialect;
+    };
+
+    /*! \internal Clear the attribute of a parser
+     */
+    template<typename Attribute>
+    void clearAttribute(Attribute & attribute)
+    {
+      attribute.clear();
+    }
+
+    inline
+    void clearAttribute(const boost::spirit::x3::unused_type &) noexcept
+    {
+    }
+
+  } // namespace Impl{
+
+  /*! \brief CSV protected field parser
+   *
+   * Same grammar as Qi::ProtectedField :
+   * \code
+   * ProtectedField = DQUOTE [EXP] *Anychar DQUOTE
+   * \endcode
+   * where EXP is only accepted if the settings tells to parse it,
+   * and the count of Anychar is bounded by the maximum field length, if any.
+   *
+   * If this parser fails, its attribute is cleared,
+   * so it can be used in a alternative
+   * (the attribute of a X3 alternative is not restored on failure).
+   *
+   * \note Some part of this API documentation refers to following standards:
+   *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
+   *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
+   */
+  template <typename DestinationString, typename Dialect = RuntimeCsvDialect>
+  struct ProtectedField : boost::spirit::x3::parser< ProtectedField<DestinationString, Dialect> >
+  {
+    using attribute_type = DestinationString;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit ProtectedField(const CsvParserSettings & settings) noexcept
+     : mDialect(settings),
+       mMaximumLength( settings.maximumFieldLength() ),
+       mOptionalExp(settings),
+       mAnychar(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      const auto fieldQuote = x3::lit( mDialect.fieldProtection() );
+      bool ok;
+
+      if(mMaximumLength > 0){
+        ok = ( fieldQuote >> mOptionalExp >> x3::repeat(static_cast<int64_t>(0), mMaximumLength)[mAnychar] >> fieldQuote )
+             .parse(first, last, context, rcontext, attribute);
+      }else{
+        ok = ( fieldQuote >> mOptionalExp >> *mAnychar >> fieldQuote ).parse(first, last, context, rcontext, attribute);
+      }
+      if(!ok){
+        Impl::clearAttribute(attribute);
+      }
+
+      return ok;
+    }
+
+   private:
+
+    Dialect mDialect;
+    int64_t mMaximumLength;
+    OptionalExp<Dialect> mOptionalExp;
+    Impl::ProtectedFieldChar<Dialect> mAnychar;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_PROTECTED_FIELD_H
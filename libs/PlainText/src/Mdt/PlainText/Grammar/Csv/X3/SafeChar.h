@@ -0,0 +1,84 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_SAFE_CHAR_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_SAFE_CHAR_H
+
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief SafeChar parser
+   *
+   * Matches any char, except the field separator,
+   * the field protection, a space, a tab, a CR and a LF.
+   *
+   * The attribute is the code point of the parsed char,
+   * like for Qi::SafeChar .
+   *
+   * \a Dialect can be a CsvDialect , to compare to constant chars,
+   * or RuntimeCsvDialect .
+   *
+   * \note Some part of this API documentation refers to following standards:
+   *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
+   *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
+   */
+  template<typename Dialect = RuntimeCsvDialect>
+  struct SafeChar : boost::spirit::x3::parser< SafeChar<Dialect> >
+  {
+    using attribute_type = uint32_t;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit SafeChar(const CsvParserSettings & settings) noexcept
+     : mDialect(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    /*! \brief Check if \a codePoint is a safe char
+     */
+    constexpr
+    bool isSafeChar(uint32_t codePoint) const noexcept
+    {
+      return (codePoint != '\n') && (codePoint != '\t') && (codePoint != '\r') && (codePoint != ' ')
+          && ( codePoint != static_cast<uint32_t>(mDialect.fieldSeparator()) )
+          && ( codePoint != static_cast<uint32_t>(mDialect.fieldProtection()) );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext &, Attribute & attribute) const
+    {
+      boost::spirit::x3::skip_over(first, last, context);
+      if(first == last){
+        return false;
+      }
+      const uint32_t codePoint = static_cast<uint32_t>(*first);
+      if( !isSafeChar(codePoint) ){
+        return false;
+      }
+      boost::spirit::x3::traits::move_to(codePoint, attribute);
+      ++first;
+
+      return true;
+    }
+
+   private:
+
+    Dialect mDialect;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_SAFE_CHAR_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_UNPROTECTED_FIELD_H
+#define MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_UNPROTECTED_FIELD_H
+
+#include "Char.h"
+#include "OptionalExp.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/CsvDialect.h"
+#include <boost/spirit/home/x3.hpp>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+  /*! \brief CSV unprotected field parser
+   *
+   * Same grammar as Qi::UnprotectedField :
+   * \code
+   * UnprotectedField = [EXP] *Char
+   * \endcode
+   * where EXP is only accepted if the settings tells to parse it,
+   * and the count of Char is bounded by the maximum field length, if any.
+   *
+   * \note Some part of this API documentation refers to following standards:
+   *       \li CSV-1203 available here: https://idoc.pub/documents/csv-file-format-specification-standard-csv-1203-6nq88y5xr9nw
+   *       \li RFC 4180 available here: https://tools.ietf.org/html/rfc4180
+   */
+  template <typename DestinationString, typename Dialect = RuntimeCsvDialect>
+  struct UnprotectedField : boost::spirit::x3::parser< UnprotectedField<DestinationString, Dialect> >
+  {
+    using attribute_type = DestinationString;
+    static const bool has_attribute = true;
+
+    /*! \brief Constructor
+     *
+     * \pre \a settings must be valid
+     * \pre \a settings must be compatible with \a Dialect
+     */
+    explicit UnprotectedField(const CsvParserSettings & settings) noexcept
+     : mMaximumLength( settings.maximumFieldLength() ),
+       mOptionalExp(settings),
+       mChar(settings)
+    {
+      assert( settings.isValid() );
+    }
+
+    template<typename SourceIterator, typename Context, typename RContext, typename Attribute>
+    bool parse(SourceIterator & first, const SourceIterator & last, const Context & context, RContext & rcontext, Attribute & attribute) const
+    {
+      namespace x3 = boost::spirit::x3;
+
+      if(mMaximumLength > 0){
+        return ( mOptionalExp >> x3::repeat(static_cast<int64_t>(0), mMaximumLength)[mChar] ).parse(first, last, context, rcontext, attribute);
+      }
+
+      return ( mOptionalExp >> *mChar ).parse(first, last, context, rcontext, attribute);
+    }
+
+   private:
+
+    int64_t mMaximumLength;
+    OptionalExp<Dialect> mOptionalExp;
+    Char<Dialect> mChar;
+  };
+
+}}}}} // namespace Mdt{ namespace PlainText{ namespace Grammar{ namespace Csv{ namespace X3{
+
+#endif // #ifndef MDT_PLAIN_TEXT_GRAMMAR_CSV_X3_UNPROTECTED_FIELD_H
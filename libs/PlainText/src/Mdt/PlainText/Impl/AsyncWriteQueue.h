@@ -0,0 +1,241 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_ASYNC_WRITE_QUEUE_H
+#define MDT_PLAIN_TEXT_IMPL_ASYNC_WRITE_QUEUE_H
+
+#include "Mdt/PlainText/FileWriteError.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Bounded queue of formatted data, from many producers to one writer thread
+   *
+   * Producers push blocks of data that are allready formatted,
+   * so the lock is only held to move a string.
+   * The writer thread takes all pending blocks at once.
+   *
+   * The queue is bounded by the size of its pending data:
+   * push() blocks while the capacity is reached (backpressure).
+   * A block is always accepted by a empty queue,
+   * even if it is larger than the capacity.
+   *
+   * To avoid switching to the writer thread for each block,
+   * it is only woken up once half of the capacity is pending,
+   * or on a flush or stop request.
+   *
+   * A error reported by the writer thread with setError()
+   * is thrown by each following push() and waitFlushed().
+   */
+  class AsyncWriteQueue
+  {
+   public:
+
+    /*! \internal Constructor
+     *
+     * \pre \a capacity must be > 0
+     */
+    explicit AsyncWriteQueue(std::size_t capacity) noexcept
+     : mCapacity(capacity),
+       mWakeUpSize( (capacity + 1) / 2 )
+    {
+      assert( capacity > 0 );
+    }
+
+    AsyncWriteQueue(const AsyncWriteQueue &) = delete;
+    AsyncWriteQueue & operator=(const AsyncWriteQueue &) = delete;
+    AsyncWriteQueue(AsyncWriteQueue &&) = delete;
+    AsyncWriteQueue & operator=(AsyncWriteQueue &&) = delete;
+
+    /*! \internal Push \a data to this queue
+     *
+     * Blocks while the capacity is reached.
+     *
+     * \exception FileWriteError Thrown if the writer thread reported a error
+     */
+    void push(std::string && data)
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+
+      if( !canPush() ){
+        ++mWaitingProducerCount;
+        mProducerCondition.wait(lock, [this](){
+          return canPush();
+        });
+        --mWaitingProducerCount;
+      }
+      throwIfError();
+
+      const std::size_t previousPendingSize = mPendingSize;
+      mPendingSize += data.size();
+      const std::size_t pendingSize = mPendingSize;
+      mBlocks.push_back( std::move(data) );
+      ++mPushedCount;
+      lock.unlock();
+
+      /*
+       * The writer thread only waits when all pending blocks have been written,
+       * so the pending size starts from 0,
+       * and it must be woken up once when it crosses mWakeUpSize
+       */
+      if( (previousPendingSize < mWakeUpSize) && (pendingSize >= mWakeUpSize) ){
+        mWriterCondition.notify_one();
+      }
+    }
+
+    /*! \internal Take all pending blocks
+     *
+     * Called by the writer thread.
+     * Blocks until there is some data, a flush request or a stop request.
+     * On return, \a flushRequested tells if the sink must be flushed
+     * once \a blocks have been written.
+     *
+     * Returns false once stop was requested and all blocks have been taken.
+     */
+    bool take(std::vector<std::string> & blocks, bool & flushRequested)
+    {
+      assert( blocks.empty() );
+
+      std::unique_lock<std::mutex> lock(mMutex);
+
+      mWriterCondition.wait(lock, [this](){
+        return (mPendingSize >= mWakeUpSize) || mFlushRequested || mStopRequested;
+      });
+
+      blocks.swap(mBlocks);
+      flushRequested = mFlushRequested;
+      mFlushRequested = false;
+      mTakenCount += blocks.size();
+
+      return !blocks.empty() || flushRequested || !mStopRequested;
+    }
+
+    /*! \internal Tell that the blocks taken so far have been written
+     *
+     * Called by the writer thread.
+     * \a size is the size of the written blocks.
+     * If \a flushed is true, the data are in the file
+     * and waitFlushed() returns.
+     */
+    void setWritten(std::size_t size, bool flushed) noexcept
+    {
+      bool mustNotify;
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        assert( mPendingSize >= size );
+        mPendingSize -= size;
+        if(flushed){
+          mFlushedCount = mTakenCount;
+        }
+        mustNotify = (mWaitingProducerCount > 0) || flushed;
+      }
+      if(mustNotify){
+        mProducerCondition.notify_all();
+      }
+    }
+
+    /*! \internal Report a error from the writer thread
+     *
+     * The pending blocks are discarded,
+     * and the producers that wait are woken up.
+     *
+     * \pre \a what must not be empty
+     */
+    void setError(const std::string & what)
+    {
+      assert( !what.empty() );
+
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if( mError.empty() ){
+          mError = what;
+        }
+        mBlocks.clear();
+        mPendingSize = 0;
+      }
+      mProducerCondition.notify_all();
+    }
+
+    /*! \internal Wait until all blocks pushed before this call are in the file
+     *
+     * \exception FileWriteError Thrown if the writer thread reported a error
+     */
+    void waitFlushed()
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+
+      const uint64_t target = mPushedCount;
+      mFlushRequested = true;
+      mWriterCondition.notify_one();
+
+      mProducerCondition.wait(lock, [this, target](){
+        return !mError.empty() || (mFlushedCount >= target);
+      });
+      throwIfError();
+    }
+
+    /*! \internal Request the writer thread to stop once all blocks have been taken
+     */
+    void requestStop() noexcept
+    {
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+      }
+      mWriterCondition.notify_one();
+    }
+
+    /*! \internal Get the error reported by the writer thread
+     *
+     * Returns a empty string if no error was reported.
+     */
+    std::string error() const
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+
+      return mError;
+    }
+
+   private:
+
+    bool canPush() const noexcept
+    {
+      return !mError.empty() || mBlocks.empty() || (mPendingSize < mCapacity);
+    }
+
+    void throwIfError() const
+    {
+      if( !mError.empty() ){
+        throw FileWriteError(mError);
+      }
+    }
+
+    mutable std::mutex mMutex;
+    std::condition_variable mProducerCondition;
+    std::condition_variable mWriterCondition;
+    std::vector<std::string> mBlocks;
+    std::size_t mCapacity;
+    std::size_t mWakeUpSize;
+    std::size_t mPendingSize = 0;
+    uint64_t mPushedCount = 0;
+    uint64_t mTakenCount = 0;
+    uint64_t mFlushedCount = 0;
+    int mWaitingProducerCount = 0;
+    bool mFlushRequested = false;
+    bool mStopRequested = false;
+    std::string mError;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_ASYNC_WRITE_QUEUE_H
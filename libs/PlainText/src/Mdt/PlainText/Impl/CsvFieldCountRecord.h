@@ -0,0 +1,135 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_CSV_FIELD_COUNT_RECORD_H
+#define MDT_PLAIN_TEXT_IMPL_CSV_FIELD_COUNT_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal A string that discards every char added to it
+   *
+   * Can be used as field attribute for the Qi and X3 grammars
+   * when only the structure of a CSV source is of interest.
+   * No memory is allocated for the field payloads.
+   */
+  class NullString
+  {
+   public:
+
+    using value_type = uint32_t;
+    using size_type = std::size_t;
+    using reference = const uint32_t &;
+    using const_reference = const uint32_t &;
+    using iterator = const uint32_t *;
+    using const_iterator = const uint32_t *;
+
+    iterator begin() const noexcept
+    {
+      return nullptr;
+    }
+
+    iterator end() const noexcept
+    {
+      return nullptr;
+    }
+
+    iterator insert(iterator pos, value_type) noexcept
+    {
+      return pos;
+    }
+
+    template<typename InputIterator>
+    iterator insert(iterator pos, InputIterator, InputIterator) noexcept
+    {
+      return pos;
+    }
+
+    void push_back(value_type) noexcept
+    {
+    }
+
+    void clear() noexcept
+    {
+    }
+
+    bool empty() const noexcept
+    {
+      return true;
+    }
+
+    size_type size() const noexcept
+    {
+      return 0;
+    }
+  };
+
+  /*! \internal A record that only counts its fields
+   *
+   * Can be used as record attribute for the Qi and X3 grammars,
+   * for example to validate a CSV file in constant memory.
+   *
+   * \sa NullString
+   */
+  class CsvFieldCountRecord
+  {
+   public:
+
+    using value_type = NullString;
+    using size_type = int;
+    using reference = const NullString &;
+    using const_reference = const NullString &;
+    using iterator = const NullString *;
+    using const_iterator = const NullString *;
+
+    iterator begin() const noexcept
+    {
+      return nullptr;
+    }
+
+    iterator end() const noexcept
+    {
+      return nullptr;
+    }
+
+    iterator insert(iterator pos, const NullString &) noexcept
+    {
+      ++mFieldCount;
+      return pos;
+    }
+
+    void push_back(const NullString &) noexcept
+    {
+      ++mFieldCount;
+    }
+
+    void clear() noexcept
+    {
+      mFieldCount = 0;
+    }
+
+    bool empty() const noexcept
+    {
+      return mFieldCount == 0;
+    }
+
+    /*! \brief Get the count of fields added to this record
+     */
+    int size() const noexcept
+    {
+      return mFieldCount;
+    }
+
+   private:
+
+    int mFieldCount = 0;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_CSV_FIELD_COUNT_RECORD_H
@@ -0,0 +1,96 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_CSV_FIELD_QUOTING_H
+#define MDT_PLAIN_TEXT_IMPL_CSV_FIELD_QUOTING_H
+
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include "Mdt/PlainText/CsvQuotingPolicy.h"
+#include "Mdt/PlainText/Grammar/Csv/Karma/UnprotectedField.h"
+#include <cstddef>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Choose if a generated field is protected
+   *
+   * Resolves the quoting policy of each column,
+   * see CsvGeneratorSettings::columnQuotingPolicy(),
+   * and applies it to a field:
+   * - CsvQuotingPolicy::Minimal : the field is checked
+   *   with ValidateStringForUnprotectedField
+   * - CsvQuotingPolicy::Always : the field is protected without being checked
+   * - CsvQuotingPolicy::Never : the field is not protected and not checked
+   *
+   * Shared by Grammar::Csv::Karma::FieldGenerator
+   * and CsvSinkRecordWriter, so that both generate the same CSV.
+   */
+  class CsvFieldQuoting
+  {
+   public:
+
+    /*! \internal Constructor
+     *
+     * \pre \a settings must be valid
+     */
+    explicit CsvFieldQuoting(const CsvGeneratorSettings & settings) noexcept
+     : mValidateString(settings),
+       mQuotingPolicy( settings.quotingPolicy() ),
+       mColumnQuotingPolicyCount( static_cast<std::size_t>( settings.columnQuotingPolicyCount() ) )
+    {
+      assert( settings.isValid() );
+
+      for(int column = 0; column < settings.columnQuotingPolicyCount(); ++column){
+        mColumnQuotingPolicies[column] = settings.columnQuotingPolicy(column);
+      }
+    }
+
+    /*! \internal Get the quoting policy that applies to fields that have no column
+     */
+    CsvQuotingPolicy quotingPolicy() const noexcept
+    {
+      return mQuotingPolicy;
+    }
+
+    /*! \internal Get the quoting policy of \a column
+     */
+    CsvQuotingPolicy columnQuotingPolicy(std::size_t column) const noexcept
+    {
+      if( column < mColumnQuotingPolicyCount ){
+        return mColumnQuotingPolicies[column];
+      }
+
+      return mQuotingPolicy;
+    }
+
+    /*! \internal Check if \a field must be protected with \a policy
+     */
+    template<typename String>
+    bool mustProtect(const String & field, CsvQuotingPolicy policy) const
+    {
+      switch(policy){
+        case CsvQuotingPolicy::Minimal:
+          return !mValidateString(field);
+        case CsvQuotingPolicy::Always:
+          return true;
+        case CsvQuotingPolicy::Never:
+          return false;
+      }
+
+      return false;
+    }
+
+   private:
+
+    Grammar::Csv::Karma::ValidateStringForUnprotectedField mValidateString;
+    CsvQuotingPolicy mQuotingPolicy;
+    std::size_t mColumnQuotingPolicyCount;
+    CsvQuotingPolicy mColumnQuotingPolicies[CsvGeneratorSettings::maximumColumnQuotingPolicyCount] = {};
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_CSV_FIELD_QUOTING_H
@@ -0,0 +1,26 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_CSV_FILE_SOURCE_ITERATOR_H
+#define MDT_PLAIN_TEXT_IMPL_CSV_FILE_SOURCE_ITERATOR_H
+
+#include "Mdt/PlainText/PositionTrackingIterator.h"
+#include <boost/spirit/include/support_multi_pass.hpp>
+#include <iterator>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Source iterator used by CsvFileReaderTemplate
+   *
+   * Defined here so that the grammars can declare
+   * their explicit instantiations for it
+   * without depending on the file reader.
+   */
+  using CsvFileSourceIterator = PositionTrackingIterator< boost::spirit::multi_pass< std::istreambuf_iterator<char> > >;
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_CSV_FILE_SOURCE_ITERATOR_H
@@ -0,0 +1,254 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_CSV_SINK_RECORD_WRITER_H
+#define MDT_PLAIN_TEXT_IMPL_CSV_SINK_RECORD_WRITER_H
+
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include "Mdt/PlainText/CsvQuotingPolicy.h"
+#include "Mdt/PlainText/CsvValue.h"
+#include "Mdt/PlainText/EndOfLine.h"
+#include "CsvFieldQuoting.h"
+#include "CsvValueFormatter.h"
+#include <iterator>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Write CSV records of std::string directly to a sink
+   *
+   * Generates the same output as Grammar::Csv::Karma::CsvRecord ,
+   * but without Karma:
+   * each field is checked with ValidateStringForUnprotectedField ,
+   * then copied to the sink as a block.
+   * For a protected field, the blocks between the field protections
+   * are copied, and each field protection is doubled.
+   *
+   * The quoting policy of each column is applied with CsvFieldQuoting ,
+   * like Grammar::Csv::Karma::FieldGenerator does:
+   * a column declared with CsvQuotingPolicy::Never is copied without any check.
+   *
+   * Records of CsvValue are also supported:
+   * numbers and booleans are formatted with CsvValueFormatter
+   * directly to the sink, without being checked.
+   * They only are protected with CsvQuotingPolicy::Always ,
+   * or if they could contain the field separator or the field protection,
+   * for example a real number with a comma as decimal separator
+   * and as field separator.
+   *
+   * Like the Karma CsvRecord, a empty record is not written.
+   *
+   * The sink is typically a BufferedFileSink .
+   * It can also be a StringSink , to generate records in memory.
+   * A record writer is not modified by writing,
+   * so it can be shared by many threads.
+   */
+  class CsvSinkRecordWriter
+  {
+   public:
+
+    /*! \internal Constructor
+     *
+     * \pre \a settings must be valid
+     */
+    explicit CsvSinkRecordWriter(const CsvGeneratorSettings & settings) noexcept
+     : mQuoting(settings),
+       mFieldSeparator( settings.fieldSeparator() ),
+       mFieldProtection( settings.fieldProtection() ),
+       mAddExp( settings.addExp() ),
+       mValueFormatter(settings),
+       mFormattedValueNeedsCheck( formattedValueCanContain( settings.fieldSeparator(), settings )
+                                  || formattedValueCanContain( settings.fieldProtection(), settings ) )
+    {
+      assert( settings.isValid() );
+
+      EndOfLine endOfLine = settings.endOfLine();
+      if( endOfLine == EndOfLine::Native ){
+        endOfLine = nativeEndOfLine();
+      }
+      switch(endOfLine){
+        case EndOfLine::Lf:
+          mEndOfLine[0] = '\n';
+          mEndOfLineSize = 1;
+          break;
+        case EndOfLine::CrLf:
+          mEndOfLine[0] = '\r';
+          mEndOfLine[1] = '\n';
+          mEndOfLineSize = 2;
+          break;
+        case EndOfLine::Cr:
+          mEndOfLine[0] = '\r';
+          mEndOfLineSize = 1;
+          break;
+        default:
+          break;
+      }
+    }
+
+    /*! \internal Write \a record to \a sink
+     *
+     * Returns false if \a record is empty,
+     * in which case nothing is written.
+     *
+     * \exception FileWriteError
+     */
+    template<typename Record, typename Sink>
+    bool operator()(const Record & record, Sink & sink) const
+    {
+      auto it = record.begin();
+      const auto last = record.end();
+
+      if(it == last){
+        return false;
+      }
+
+      std::size_t column = 0;
+      writeField( *it, mQuoting.columnQuotingPolicy(column), sink );
+      for(++it; it != last; ++it){
+        ++column;
+        sink.put(mFieldSeparator);
+        writeField( *it, mQuoting.columnQuotingPolicy(column), sink );
+      }
+      sink.write(mEndOfLine, mEndOfLineSize);
+
+      return true;
+    }
+
+   private:
+
+    template<typename Sink>
+    void writeField(const std::string & field, CsvQuotingPolicy policy, Sink & sink) const
+    {
+      if( mQuoting.mustProtect(field, policy) ){
+        writeProtectedField(field, sink);
+      }else{
+        writeUnprotectedField(field, sink);
+      }
+    }
+
+    template<typename Sink>
+    void writeField(const CsvValue & value, CsvQuotingPolicy policy, Sink & sink) const
+    {
+      if( value.type() == CsvValueType::String ){
+        writeField(value.toString(), policy, sink);
+        return;
+      }
+      if(mFormattedValueNeedsCheck){
+        std::string field;
+        auto it = std::back_inserter(field);
+        generateValue(it, value);
+        writeField(field, policy, sink);
+        return;
+      }
+
+      const bool protect = (policy == CsvQuotingPolicy::Always);
+      if(protect){
+        sink.put(mFieldProtection);
+      }
+      if(mAddExp){
+        sink.put('~');
+      }
+      auto it = sink.outputIterator();
+      generateValue(it, value);
+      if(protect){
+        sink.put(mFieldProtection);
+      }
+    }
+
+    template<typename OutputIterator>
+    void generateValue(OutputIterator & it, const CsvValue & value) const
+    {
+      switch( value.type() ){
+        case CsvValueType::Integer:
+          mValueFormatter.generateInteger( it, value.toInteger() );
+          break;
+        case CsvValueType::UnsignedInteger:
+          mValueFormatter.generateUnsignedInteger( it, value.toUnsignedInteger() );
+          break;
+        case CsvValueType::Real:
+          mValueFormatter.generateReal( it, value.toReal() );
+          break;
+        case CsvValueType::Boolean:
+          for(const char *c = CsvValueFormatter::booleanText( value.toBoolean() ); *c != '\0'; ++c){
+            *it = *c;
+            ++it;
+          }
+          break;
+        case CsvValueType::String:
+          break;
+      }
+    }
+
+    /*
+     * Chars that a formatted number or boolean can contain,
+     * including nan and inf
+     */
+    static
+    bool formattedValueCanContain(char c, const CsvGeneratorSettings & settings) noexcept
+    {
+      if( c == settings.decimalSeparator() ){
+        return true;
+      }
+      if(c == '\0'){
+        return false;
+      }
+      return std::strchr("0123456789+-.eEnaiftrusl", c) != nullptr;
+    }
+
+    template<typename Sink>
+    void writeUnprotectedField(const std::string & field, Sink & sink) const
+    {
+      if(mAddExp){
+        sink.put('~');
+      }
+      sink.write( field.data(), field.size() );
+    }
+
+    template<typename Sink>
+    void writeProtectedField(const std::string & field, Sink & sink) const
+    {
+      sink.put(mFieldProtection);
+      if(mAddExp){
+        sink.put('~');
+      }
+      writeProtectedFieldPayload(field, sink);
+      sink.put(mFieldProtection);
+    }
+
+    template<typename Sink>
+    void writeProtectedFieldPayload(const std::string & field, Sink & sink) const
+    {
+      const char *first = field.data();
+      const char * const last = first + field.size();
+
+      while(first != last){
+        const auto *protection = static_cast<const char*>( std::memchr(first, mFieldProtection, static_cast<std::size_t>(last - first)) );
+        if(protection == nullptr){
+          sink.write( first, static_cast<std::size_t>(last - first) );
+          return;
+        }
+        sink.write( first, static_cast<std::size_t>(protection - first + 1) );
+        sink.put(mFieldProtection);
+        first = protection + 1;
+      }
+    }
+
+    CsvFieldQuoting mQuoting;
+    char mFieldSeparator;
+    char mFieldProtection;
+    bool mAddExp;
+    CsvValueFormatter mValueFormatter;
+    bool mFormattedValueNeedsCheck;
+    char mEndOfLine[2] = {'\n', '\n'};
+    std::size_t mEndOfLineSize = 1;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_CSV_SINK_RECORD_WRITER_H
@@ -0,0 +1,140 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_CSV_VALUE_FORMATTER_H
+#define MDT_PLAIN_TEXT_IMPL_CSV_VALUE_FORMATTER_H
+
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include <boost/spirit/include/karma_generate.hpp>
+#include <boost/spirit/include/karma_int.hpp>
+#include <boost/spirit/include/karma_uint.hpp>
+#include <boost/spirit/include/karma_real.hpp>
+#include <boost/spirit/include/karma_char.hpp>
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Karma real policies for CSV fields
+   *
+   * Real numbers are written in fixed notation,
+   * with at most precision() fractional digits, without trailing zeros.
+   * Very large numbers, that would require many digits,
+   * are written in scientific notation.
+   *
+   * Unlike Karma's default policies,
+   * the precision and the decimal separator are given at runtime.
+   */
+  class CsvRealPolicies : public boost::spirit::karma::real_policies<double>
+  {
+   public:
+
+    /*! \internal Constructor
+     */
+    CsvRealPolicies(unsigned int precision, char decimalSeparator) noexcept
+     : mPrecision(precision),
+       mDecimalSeparator(decimalSeparator)
+    {
+    }
+
+    static
+    int floatfield(double n) noexcept
+    {
+      if( std::fabs(n) < 1e15 ){
+        return fmtflags::fixed;
+      }
+      return fmtflags::scientific;
+    }
+
+    unsigned int precision(double) const noexcept
+    {
+      return mPrecision;
+    }
+
+    /*
+     * With a precision of 0, no fractional part is written,
+     * so the decimal separator must not be written either
+     */
+    template<typename OutputIterator>
+    bool dot(OutputIterator & sink, double, unsigned int) const
+    {
+      if(mPrecision == 0){
+        return true;
+      }
+      return boost::spirit::karma::char_inserter<>::call(sink, mDecimalSeparator);
+    }
+
+   private:
+
+    unsigned int mPrecision;
+    char mDecimalSeparator;
+  };
+
+  /*! \internal Format numbers and booleans of CSV fields to a output iterator
+   *
+   * The values are generated with Karma's numeric generators,
+   * directly to the output iterator, without any allocation.
+   *
+   * Booleans are written as \c true or \c false
+   */
+  class CsvValueFormatter
+  {
+   public:
+
+    /*! \internal Constructor
+     */
+    explicit CsvValueFormatter(const CsvGeneratorSettings & settings) noexcept
+     : mRealGenerator( CsvRealPolicies( static_cast<unsigned int>( settings.realPrecision() ), settings.decimalSeparator() ) )
+    {
+      assert( settings.realPrecision() >= 0 );
+    }
+
+    /*! \internal Write \a value to \a sink
+     */
+    template<typename OutputIterator>
+    bool generateInteger(OutputIterator & sink, int64_t value) const
+    {
+      return boost::spirit::karma::generate(sink, mIntegerGenerator, value);
+    }
+
+    /*! \internal Write \a value to \a sink
+     */
+    template<typename OutputIterator>
+    bool generateUnsignedInteger(OutputIterator & sink, uint64_t value) const
+    {
+      return boost::spirit::karma::generate(sink, mUnsignedIntegerGenerator, value);
+    }
+
+    /*! \internal Write \a value to \a sink
+     */
+    template<typename OutputIterator>
+    bool generateReal(OutputIterator & sink, double value) const
+    {
+      return boost::spirit::karma::generate(sink, mRealGenerator, value);
+    }
+
+    /*! \internal Get the text of \a value
+     */
+    static
+    const char *booleanText(bool value) noexcept
+    {
+      if(value){
+        return "true";
+      }
+      return "false";
+    }
+
+   private:
+
+    boost::spirit::karma::int_generator<int64_t> mIntegerGenerator;
+    boost::spirit::karma::uint_generator<uint64_t> mUnsignedIntegerGenerator;
+    boost::spirit::karma::real_generator<double, CsvRealPolicies> mRealGenerator;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_CSV_VALUE_FORMATTER_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "FileSync.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#if defined(MDT_PLAIN_TEXT_OS_UNIX)
+ #include <sys/types.h>
+ #include <sys/stat.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+#else
+ #include <io.h>
+ #include <windows.h>
+#endif // #if defined(MDT_PLAIN_TEXT_OS_UNIX)
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+namespace{
+
+#if defined(MDT_PLAIN_TEXT_OS_UNIX)
+
+  /*
+   * On Linux, fdatasync() does not sync the metadata that are not required
+   * to read the data back, like the modification time.
+   * On macOS, fsync() does not flush the disk cache, F_FULLFSYNC does.
+   */
+  int syncFile(int fd) noexcept
+  {
+    int result;
+    do{
+#if defined(__linux__)
+      result = ::fdatasync(fd);
+#elif defined(F_FULLFSYNC)
+      result = ::fcntl(fd, F_FULLFSYNC);
+      if(result != 0){
+        result = ::fsync(fd);
+      }
+#else
+      result = ::fsync(fd);
+#endif
+    }while( (result != 0) && (errno == EINTR) );
+
+    return result;
+  }
+
+  std::string directoryPath(const std::string & filePath)
+  {
+    const auto separatorPosition = filePath.rfind('/');
+    if(separatorPosition == std::string::npos){
+      return ".";
+    }
+    if(separatorPosition == 0){
+      return "/";
+    }
+
+    return filePath.substr(0, separatorPosition);
+  }
+
+  /*
+   * Some file systems do not support syncing a directory,
+   * so errors are ignored
+   */
+  void syncDirectory(const std::string & path) noexcept
+  {
+    int flags = O_RDONLY;
+#if defined(O_DIRECTORY)
+    flags |= O_DIRECTORY;
+#endif
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+    const int fd = ::open(path.c_str(), flags);
+    if(fd < 0){
+      return;
+    }
+    ::fsync(fd);
+    ::close(fd);
+  }
+
+#endif // #if defined(MDT_PLAIN_TEXT_OS_UNIX)
+
+} // namespace{
+
+void syncFileDescriptor(int fileDescriptor, const std::string & path)
+{
+  assert( fileDescriptor >= 0 );
+
+#if defined(MDT_PLAIN_TEXT_OS_UNIX)
+  if( syncFile(fileDescriptor) != 0 ){
+    const std::string what = "syncing file '" + path + "' failed: " + std::strerror(errno);
+    throw FileWriteError(what);
+  }
+#else
+  if( ::_commit(fileDescriptor) != 0 ){
+    const std::string what = "syncing file '" + path + "' failed: " + std::strerror(errno);
+    throw FileWriteError(what);
+  }
+#endif
+}
+
+void replaceFile(const std::string & source, const std::string & destination)
+{
+  assert( !source.empty() );
+  assert( !destination.empty() );
+
+#if defined(MDT_PLAIN_TEXT_OS_UNIX)
+  if( std::rename( source.c_str(), destination.c_str() ) != 0 ){
+    const std::string what = "replacing file '" + destination + "' failed: " + std::strerror(errno);
+    throw FileWriteError(what);
+  }
+  syncDirectory( directoryPath(destination) );
+#else
+  if( !::MoveFileExA( source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) ){
+    const std::string what = "replacing file '" + destination + "' failed: error " + std::to_string( ::GetLastError() );
+    throw FileWriteError(what);
+  }
+#endif
+}
+
+void syncParentDirectory(const std::string & filePath) noexcept
+{
+  assert( !filePath.empty() );
+
+#if defined(MDT_PLAIN_TEXT_OS_UNIX)
+  syncDirectory( directoryPath(filePath) );
+#endif
+}
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
@@ -0,0 +1,56 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_FILE_SYNC_H
+#define MDT_PLAIN_TEXT_IMPL_FILE_SYNC_H
+
+#include "Mdt/PlainText/FileWriteError.h"
+#include "mdt_plaintext_export.h"
+#include <string>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Sync the data written to \a fileDescriptor to the storage
+   *
+   * Only the data allready passed to the operating system are synced.
+   * This can be called by a other thread than the one that writes.
+   *
+   * \a path is only used for the error message.
+   *
+   * \pre \a fileDescriptor must be a valid file descriptor
+   * \exception FileWriteError
+   */
+  MDT_PLAINTEXT_EXPORT
+  void syncFileDescriptor(int fileDescriptor, const std::string & path);
+
+  /*! \internal Replace \a destination with \a source
+   *
+   * \a source is renamed to \a destination ,
+   * which is replaced atomically if it exists.
+   * On Unix, the directory is then synced,
+   * so that the rename itself is on the storage.
+   *
+   * \pre \a source and \a destination must not be empty
+   * \exception FileWriteError
+   */
+  MDT_PLAINTEXT_EXPORT
+  void replaceFile(const std::string & source, const std::string & destination);
+
+  /*! \internal Sync the directory that contains \a filePath to the storage
+   *
+   * This makes a rename done by someone else (like QSaveFile)
+   * reach the storage.
+   * Errors are ignored, like in replaceFile().
+   * Does nothing on Windows.
+   *
+   * \pre \a filePath must not be empty
+   */
+  MDT_PLAINTEXT_EXPORT
+  void syncParentDirectory(const std::string & filePath) noexcept;
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_FILE_SYNC_H
@@ -0,0 +1,109 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "GroupCommit.h"
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+GroupCommit::~GroupCommit() noexcept
+{
+  try{
+    stop();
+  }catch(...){
+  }
+}
+
+void GroupCommit::start(const FileDurabilityPolicy & policy, const SyncFunction & sync)
+{
+  assert( sync );
+  assert( !isStarted() );
+
+  mSync = sync;
+  mRecordCount = policy.groupCommitRecordCount();
+  mPendingRecordCount = 0;
+  mInterval = policy.groupCommitInterval();
+  mCommitRequested.store(false);
+  mSyncRequested = false;
+  mStopRequested = false;
+  mError.clear();
+  mThread = std::thread(&GroupCommit::run, this);
+}
+
+void GroupCommit::commit()
+{
+  assert( isStarted() );
+
+  mPendingRecordCount = 0;
+  mCommitRequested.store(false, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if( !mError.empty() ){
+      throw FileWriteError(mError);
+    }
+    mSyncRequested = true;
+  }
+  mCondition.notify_one();
+}
+
+void GroupCommit::stop()
+{
+  if( !isStarted() ){
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopRequested = true;
+  }
+  mCondition.notify_one();
+  mThread.join();
+
+  if( !mError.empty() ){
+    throw FileWriteError(mError);
+  }
+}
+
+/*
+ * When the interval elapsed without any commit,
+ * the writer is asked to commit with its next record,
+ * because the data can still be in its buffer.
+ */
+void GroupCommit::run()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+
+  const auto isWakeUpRequested = [this](){
+    return mSyncRequested || mStopRequested;
+  };
+
+  while(!mStopRequested){
+    if(mInterval.count() > 0){
+      if( !mCondition.wait_for(lock, mInterval, isWakeUpRequested) ){
+        mCommitRequested.store(true, std::memory_order_relaxed);
+        continue;
+      }
+    }else{
+      mCondition.wait(lock, isWakeUpRequested);
+    }
+    if(mSyncRequested){
+      mSyncRequested = false;
+      lock.unlock();
+      std::string error;
+      try{
+        mSync();
+      }catch(const FileWriteError & syncError){
+        error = syncError.what();
+      }
+      lock.lock();
+      if( mError.empty() ){
+        mError = error;
+      }
+    }
+  }
+}
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
@@ -0,0 +1,133 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_GROUP_COMMIT_H
+#define MDT_PLAIN_TEXT_IMPL_GROUP_COMMIT_H
+
+#include "Mdt/PlainText/FileWriteError.h"
+#include "Mdt/PlainText/FileDurabilityPolicy.h"
+#include "mdt_plaintext_export.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Sync a file to the storage by groups of records, from a background thread
+   *
+   * The writer tells how many records it wrote with recordsWritten().
+   * When it returns true, the writer passes its buffered data
+   * to the operating system, then calls commit().
+   * The sync function is then called by the background thread,
+   * while the writer goes on.
+   *
+   * A commit is due once the group commit record count is reached,
+   * or once the group commit interval elapsed:
+   * the background thread then sets a flag,
+   * which the writer sees with its next record.
+   * So, checking for a commit only costs a counter
+   * and a relaxed atomic load per record.
+   *
+   * A error thrown by the sync function is reported
+   * by the next commit() or by stop().
+   */
+  class MDT_PLAINTEXT_EXPORT GroupCommit
+  {
+   public:
+
+    /*! \internal Function that syncs the file
+     *
+     * It is called from the background thread,
+     * and can throw FileWriteError.
+     */
+    using SyncFunction = std::function<void()>;
+
+    GroupCommit() noexcept = default;
+
+    /*! \internal Stop the background thread
+     *
+     * Errors are ignored.
+     */
+    ~GroupCommit() noexcept;
+
+    GroupCommit(const GroupCommit &) = delete;
+    GroupCommit & operator=(const GroupCommit &) = delete;
+    GroupCommit(GroupCommit &&) = delete;
+    GroupCommit & operator=(GroupCommit &&) = delete;
+
+    /*! \internal Start the background thread
+     *
+     * \pre \a sync must be valid
+     * \pre This group commit must not be started
+     */
+    void start(const FileDurabilityPolicy & policy, const SyncFunction & sync);
+
+    /*! \internal Check if the background thread is started
+     */
+    bool isStarted() const noexcept
+    {
+      return mThread.joinable();
+    }
+
+    /*! \internal Tell that \a count records have been written
+     *
+     * Returns true if a commit is due.
+     */
+    bool recordsWritten(int64_t count) noexcept
+    {
+      mPendingRecordCount += count;
+      if( (mRecordCount > 0) && (mPendingRecordCount >= mRecordCount) ){
+        return true;
+      }
+
+      return mCommitRequested.load(std::memory_order_relaxed);
+    }
+
+    /*! \internal Request the background thread to sync the file
+     *
+     * The data written so far must have been passed to the operating system.
+     *
+     * \exception FileWriteError Thrown if a previous sync failed
+     * \pre This group commit must be started
+     */
+    void commit();
+
+    /*! \internal Stop the background thread
+     *
+     * The last records are not synced:
+     * the writer must sync the file itself before closing it.
+     *
+     * Does nothing if the background thread is not started.
+     *
+     * \exception FileWriteError Thrown if a sync failed
+     */
+    void stop();
+
+   private:
+
+    void run();
+
+    SyncFunction mSync;
+    int64_t mRecordCount = 0;
+    int64_t mPendingRecordCount = 0;
+    std::chrono::milliseconds mInterval = std::chrono::milliseconds(0);
+    std::atomic<bool> mCommitRequested = {false};
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mSyncRequested = false;
+    bool mStopRequested = false;
+    std::string mError;
+    std::thread mThread;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_GROUP_COMMIT_H
@@ -0,0 +1,57 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_MULTI_PASS_QUEUE_H
+#define MDT_PLAIN_TEXT_IMPL_MULTI_PASS_QUEUE_H
+
+#include "Mdt/PlainText/PositionTrackingIterator.h"
+#include <boost/spirit/include/support_multi_pass.hpp>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Clear the buffer of a multi pass iterator
+   *
+   * Does nothing for other iterators.
+   *
+   * Used by the Qi and the X3 FlushMultiPass parsers.
+   *
+   * The buffer is cleared with clear_mode::clear_always ,
+   * so it is released even if other copies of the iterator still exist.
+   * The caller must ensure that none of those copies
+   * is used to read the input afterwards.
+   */
+  template<typename Iterator>
+  struct MultiPassQueue
+  {
+    static
+    void clear(Iterator &) noexcept
+    {
+    }
+  };
+
+  template<typename T, typename Policies>
+  struct MultiPassQueue< boost::spirit::multi_pass<T, Policies> >
+  {
+    static
+    void clear(boost::spirit::multi_pass<T, Policies> & iterator)
+    {
+      boost::spirit::traits::clear_queue(iterator, boost::spirit::traits::clear_mode::clear_always);
+    }
+  };
+
+  template<typename BaseIterator>
+  struct MultiPassQueue< PositionTrackingIterator<BaseIterator> >
+  {
+    static
+    void clear(PositionTrackingIterator<BaseIterator> & iterator)
+    {
+      MultiPassQueue<BaseIterator>::clear( iterator.base() );
+    }
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_MULTI_PASS_QUEUE_H
@@ -0,0 +1,47 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_PARSE_RULE_H
+#define MDT_PLAIN_TEXT_IMPL_PARSE_RULE_H
+
+#include <boost/spirit/include/qi_parse.hpp>
+#include <boost/spirit/home/x3/core/parser.hpp>
+#include <boost/spirit/home/x3/core/parse.hpp>
+#include <type_traits>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Tells if \a Rule is a Boost.Spirit X3 parser
+   */
+  template<typename Rule>
+  using IsX3Parser = std::is_base_of<boost::spirit::x3::parser_base, Rule>;
+
+  template<typename SourceIterator, typename Rule, typename Attribute>
+  bool parseRule(SourceIterator & first, const SourceIterator & last, const Rule & rule, Attribute & attribute, std::false_type)
+  {
+    return boost::spirit::qi::parse(first, last, rule, attribute);
+  }
+
+  template<typename SourceIterator, typename Rule, typename Attribute>
+  bool parseRule(SourceIterator & first, const SourceIterator & last, const Rule & rule, Attribute & attribute, std::true_type)
+  {
+    return boost::spirit::x3::parse(first, last, rule, attribute);
+  }
+
+  /*! \internal Parse a source with a Qi or a X3 rule
+   *
+   * Lets the readers accept the grammars from Grammar::Csv::Qi
+   * as well as the ones from Grammar::Csv::X3 .
+   */
+  template<typename SourceIterator, typename Rule, typename Attribute>
+  bool parseRule(SourceIterator & first, const SourceIterator & last, const Rule & rule, Attribute & attribute)
+  {
+    return parseRule( first, last, rule, attribute, IsX3Parser<Rule>() );
+  }
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_PARSE_RULE_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_STRING_SINK_H
+#define MDT_PLAIN_TEXT_IMPL_STRING_SINK_H
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Sink that appends to a std::string
+   *
+   * Has the same interface as BufferedFileSink
+   * used by CsvSinkRecordWriter ,
+   * so that records can be generated in memory,
+   * for example by a worker thread.
+   */
+  class StringSink
+  {
+   public:
+
+    using iterator = std::back_insert_iterator<std::string>;
+
+    /*! \internal Construct a sink that appends to \a data
+     */
+    explicit StringSink(std::string & data) noexcept
+     : mData(&data)
+    {
+    }
+
+    /*! \internal Get a output iterator that appends chars to this sink
+     */
+    iterator outputIterator() noexcept
+    {
+      return std::back_inserter(*mData);
+    }
+
+    /*! \internal Put \a c to this sink
+     */
+    void put(char c)
+    {
+      mData->push_back(c);
+    }
+
+    /*! \internal Write \a size bytes from \a data to this sink
+     */
+    void write(const char *data, std::size_t size)
+    {
+      assert( (data != nullptr) || (size == 0) );
+
+      mData->append(data, size);
+    }
+
+   private:
+
+    std::string *mData;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_STRING_SINK_H
@@ -0,0 +1,194 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_UTF8_VALIDATING_STREAM_BUFFER_H
+#define MDT_PLAIN_TEXT_IMPL_UTF8_VALIDATING_STREAM_BUFFER_H
+
+#include "Utf8Validation.h"
+#include <streambuf>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Input stream buffer that validates UTF-8 while it is read
+   *
+   * Reads its source by blocks, and validates each block
+   * with a Utf8Validator before giving access to it.
+   * The source is never read twice and never seeked,
+   * so it can also be a pipe.
+   *
+   * Only complete lines are made available,
+   * the end of a block is kept until the end-of-line
+   * that terminates it is read.
+   * If a invalid sequence is found,
+   * the input ends at the beginning of the line that contains it.
+   * This way, a parser never sees a truncated line,
+   * and invalidSequenceReached() tells if it reached the end of the input
+   * because of a invalid sequence.
+   *
+   * \code
+   * Utf8ValidatingStreamBuffer buffer;
+   * buffer.setSource( fileStream.rdbuf() );
+   * std::istreambuf_iterator<char> first(&buffer);
+   * \endcode
+   */
+  class Utf8ValidatingStreamBuffer : public std::streambuf
+  {
+   public:
+
+    /*! \internal Set the source to read from
+     *
+     * This buffer is reset to the beginning of \a source .
+     *
+     * \pre \a source must be a valid pointer
+     */
+    void setSource(std::streambuf *source)
+    {
+      assert( source != nullptr );
+
+      constexpr std::size_t blockSize = 64 * 1024;
+
+      mSource = source;
+      mBuffer.resize(blockSize);
+      mEnd = 0;
+      mBufferOffset = 0;
+      mSourceAtEnd = false;
+      mInvalidSequenceReached = false;
+      mValidator = Utf8Validator();
+      setg( mBuffer.data(), mBuffer.data(), mBuffer.data() );
+    }
+
+    /*! \internal Check if the end of the input was reached because of a invalid sequence
+     *
+     * \sa errorOffset()
+     */
+    bool invalidSequenceReached() const noexcept
+    {
+      return mInvalidSequenceReached;
+    }
+
+    /*! \internal Get the offset of the first invalid sequence in the source
+     *
+     * Returns -1 if no invalid sequence was found so far.
+     */
+    int64_t errorOffset() const noexcept
+    {
+      return mValidator.errorOffset();
+    }
+
+   protected:
+
+    int_type underflow() override
+    {
+      assert( mSource != nullptr );
+
+      if( gptr() < egptr() ){
+        return traits_type::to_int_type(*gptr());
+      }
+
+      dropConsumedChars();
+
+      const std::size_t available = readLines();
+      if(available == 0){
+        mInvalidSequenceReached = !mValidator.isValid();
+        return traits_type::eof();
+      }
+      setg( mBuffer.data(), mBuffer.data(), mBuffer.data() + available );
+
+      return traits_type::to_int_type(*gptr());
+    }
+
+   private:
+
+    /*
+     * Move the chars that are not yet available
+     * to the beginning of the buffer
+     */
+    void dropConsumedChars() noexcept
+    {
+      const auto consumed = static_cast<std::size_t>( egptr() - eback() );
+
+      if(consumed > 0){
+        std::memmove( mBuffer.data(), mBuffer.data() + consumed, mEnd - consumed );
+        mEnd -= consumed;
+        mBufferOffset += static_cast<int64_t>(consumed);
+      }
+      setg( mBuffer.data(), mBuffer.data(), mBuffer.data() );
+    }
+
+    /*
+     * Read the source until at least one complete line is buffered,
+     * or its end is reached.
+     * Returns the count of chars that can be made available.
+     */
+    std::size_t readLines()
+    {
+      while( mValidator.isValid() && !mSourceAtEnd ){
+        if( mEnd == mBuffer.size() ){
+          mBuffer.resize( 2 * mBuffer.size() );
+        }
+        const std::size_t blockBegin = mEnd;
+        const std::streamsize n = mSource->sgetn( mBuffer.data() + mEnd, static_cast<std::streamsize>(mBuffer.size() - mEnd) );
+        if(n > 0){
+          mValidator.validate( mBuffer.data() + mEnd, static_cast<std::size_t>(n) );
+          mEnd += static_cast<std::size_t>(n);
+        }else{
+          mSourceAtEnd = true;
+          mValidator.finish();
+        }
+        // The chars before blockBegin never contain a end-of-line
+        if( mValidator.isValid() && !mSourceAtEnd ){
+          const std::size_t available = lineBegin(mEnd, blockBegin);
+          if(available > 0){
+            return available;
+          }
+        }
+      }
+
+      if( !mValidator.isValid() ){
+        const int64_t errorIndex = mValidator.errorOffset() - mBufferOffset;
+        assert( (errorIndex >= 0) && (errorIndex <= static_cast<int64_t>(mEnd)) );
+        return lineBegin(static_cast<std::size_t>(errorIndex), 0);
+      }
+
+      return mEnd;
+    }
+
+    /*
+     * Get the index of the beginning of the line that contains the char at index
+     * (which is after the last end-of-line before it).
+     * Only the chars from first are searched,
+     * 0 is returned if none of them is a end-of-line.
+     */
+    std::size_t lineBegin(std::size_t index, std::size_t first) const noexcept
+    {
+      while(index > first){
+        const char c = mBuffer[index - 1];
+        if( (c == '\n') || (c == '\r') ){
+          return index;
+        }
+        --index;
+      }
+
+      return 0;
+    }
+
+    std::streambuf *mSource = nullptr;
+    std::vector<char> mBuffer;
+    std::size_t mEnd = 0;
+    int64_t mBufferOffset = 0;
+    bool mSourceAtEnd = false;
+    bool mInvalidSequenceReached = false;
+    Utf8Validator mValidator;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_UTF8_VALIDATING_STREAM_BUFFER_H
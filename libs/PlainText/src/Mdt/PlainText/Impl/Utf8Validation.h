@@ -0,0 +1,193 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_IMPL_UTF8_VALIDATION_H
+#define MDT_PLAIN_TEXT_IMPL_UTF8_VALIDATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{ namespace Impl{
+
+  /*! \internal Get the count of ASCII chars at the beginning of \a data
+   *
+   * The chars are tested 16 at a time,
+   * using 64-bit words.
+   */
+  inline
+  std::size_t asciiPrefixLength(const char *data, std::size_t size) noexcept
+  {
+    constexpr uint64_t highBits = 0x8080808080808080;
+
+    std::size_t i = 0;
+
+    while( (i + 16) <= size ){
+      uint64_t first;
+      uint64_t second;
+      std::memcpy(&first, data + i, 8);
+      std::memcpy(&second, data + i + 8, 8);
+      if( (first | second) & highBits ){
+        break;
+      }
+      i += 16;
+    }
+    while( (i < size) && (static_cast<unsigned char>(data[i]) < 0x80) ){
+      ++i;
+    }
+
+    return i;
+  }
+
+  /*! \internal Check if \a data only contains ASCII chars
+   */
+  inline
+  bool isAscii(const char *data, std::size_t size) noexcept
+  {
+    return asciiPrefixLength(data, size) == size;
+  }
+
+  /*! \internal Incremental UTF-8 validator
+   *
+   * A source is validated block by block,
+   * a UTF-8 sequence can span many blocks.
+   * Runs of ASCII chars are skipped using asciiPrefixLength().
+   *
+   * Overlong sequences, surrogates and code points above U+10FFFF
+   * are rejected, as defined in the Unicode standard, table 3-7.
+   *
+   * \code
+   * Utf8Validator validator;
+   * while( readBlock(block) ){
+   *   if( !validator.validate( block.data(), block.size() ) ){
+   *     handleError( validator.errorOffset() );
+   *   }
+   * }
+   * if( !validator.finish() ){
+   *   handleError( validator.errorOffset() );
+   * }
+   * \endcode
+   */
+  class Utf8Validator
+  {
+   public:
+
+    /*! \internal Validate the next block of the source
+     *
+     * Returns false on the first invalid sequence.
+     *
+     * \pre No error must have been found before
+     * \sa isValid()
+     */
+    bool validate(const char *data, std::size_t size) noexcept
+    {
+      assert( isValid() );
+
+      std::size_t i = 0;
+
+      while(i < size){
+        if(mPendingContinuationCount == 0){
+          i += asciiPrefixLength(data + i, size - i);
+          if(i == size){
+            break;
+          }
+          mSequenceOffset = mOffset + static_cast<int64_t>(i);
+          if( !beginSequence( static_cast<unsigned char>(data[i]) ) ){
+            mErrorOffset = mSequenceOffset;
+            return false;
+          }
+        }else{
+          const auto c = static_cast<unsigned char>(data[i]);
+          if( (c < mLowerBound) || (c > mUpperBound) ){
+            mErrorOffset = mSequenceOffset;
+            return false;
+          }
+          mLowerBound = 0x80;
+          mUpperBound = 0xBF;
+          --mPendingContinuationCount;
+        }
+        ++i;
+      }
+      mOffset += static_cast<int64_t>(size);
+
+      return true;
+    }
+
+    /*! \internal Check that the source does not end in the middle of a sequence
+     *
+     * Must be called once the last block has been validated.
+     */
+    bool finish() noexcept
+    {
+      if( isValid() && (mPendingContinuationCount > 0) ){
+        mErrorOffset = mSequenceOffset;
+      }
+
+      return isValid();
+    }
+
+    /*! \internal Check if no error was found so far
+     */
+    bool isValid() const noexcept
+    {
+      return mErrorOffset < 0;
+    }
+
+    /*! \internal Get the offset of the first invalid sequence in the source
+     *
+     * Returns -1 if no error was found.
+     */
+    int64_t errorOffset() const noexcept
+    {
+      return mErrorOffset;
+    }
+
+   private:
+
+    bool beginSequence(unsigned char lead) noexcept
+    {
+      assert( lead >= 0x80 );
+
+      mLowerBound = 0x80;
+      mUpperBound = 0xBF;
+
+      if( (lead >= 0xC2) && (lead <= 0xDF) ){
+        mPendingContinuationCount = 1;
+      }else if(lead == 0xE0){
+        mPendingContinuationCount = 2;
+        mLowerBound = 0xA0;
+      }else if(lead == 0xED){
+        mPendingContinuationCount = 2;
+        mUpperBound = 0x9F;
+      }else if( (lead >= 0xE1) && (lead <= 0xEF) ){
+        mPendingContinuationCount = 2;
+      }else if(lead == 0xF0){
+        mPendingContinuationCount = 3;
+        mLowerBound = 0x90;
+      }else if( (lead >= 0xF1) && (lead <= 0xF3) ){
+        mPendingContinuationCount = 3;
+      }else if(lead == 0xF4){
+        mPendingContinuationCount = 3;
+        mUpperBound = 0x8F;
+      }else{
+        return false;
+      }
+
+      return true;
+    }
+
+    int mPendingContinuationCount = 0;
+    unsigned char mLowerBound = 0x80;
+    unsigned char mUpperBound = 0xBF;
+    int64_t mOffset = 0;
+    int64_t mSequenceOffset = 0;
+    int64_t mErrorOffset = -1;
+  };
+
+}}} // namespace Mdt{ namespace PlainText{ namespace Impl{
+
+#endif // #ifndef MDT_PLAIN_TEXT_IMPL_UTF8_VALIDATION_H
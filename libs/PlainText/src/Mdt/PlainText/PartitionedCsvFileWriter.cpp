@@ -0,0 +1,294 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "PartitionedCsvFileWriter.h"
+#include "Mdt/PlainText/Impl/CsvSinkRecordWriter.h"
+#include <iterator>
+#include <utility>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+constexpr int PartitionedCsvFileWriter::defaultMaxOpenFileCount;
+constexpr std::size_t PartitionedCsvFileWriter::defaultBufferSize;
+
+PartitionedCsvFileWriter::PartitionedCsvFileWriter()
+{
+}
+
+PartitionedCsvFileWriter::~PartitionedCsvFileWriter() noexcept
+{
+  try{
+    close();
+  }catch(...){
+  }
+}
+
+void PartitionedCsvFileWriter::setDirectoryPath(const std::string & directoryPath)
+{
+  assert( !directoryPath.empty() );
+  assert( !isOpen() );
+
+  mDirectoryPath = directoryPath;
+}
+
+void PartitionedCsvFileWriter::setFileNameSuffix(const std::string & suffix)
+{
+  assert( !isOpen() );
+
+  mFileNameSuffix = suffix;
+}
+
+void PartitionedCsvFileWriter::setKeyExtractor(const KeyExtractor & extractor)
+{
+  assert( extractor );
+  assert( !isOpen() );
+
+  mKeyExtractor = extractor;
+}
+
+void PartitionedCsvFileWriter::setKeyColumn(int column)
+{
+  assert( column >= 0 );
+
+  const auto index = static_cast<std::size_t>(column);
+
+  setKeyExtractor( [index](const std::vector<std::string> & record){
+    if( index >= record.size() ){
+      return std::string();
+    }
+    return record[index];
+  });
+}
+
+void PartitionedCsvFileWriter::setHeader(const std::vector<std::string> & header)
+{
+  assert( !isOpen() );
+
+  mHeader = header;
+}
+
+void PartitionedCsvFileWriter::setCsvSettings(const CsvGeneratorSettings & settings) noexcept
+{
+  assert( settings.isValid() );
+  assert( !isOpen() );
+
+  mCsvSettings = settings;
+}
+
+void PartitionedCsvFileWriter::setOpenMode(FileWriteOpenMode mode) noexcept
+{
+  assert( !isOpen() );
+
+  mOpenMode = mode;
+}
+
+void PartitionedCsvFileWriter::setMaxOpenFileCount(int count) noexcept
+{
+  assert( count >= 1 );
+  assert( !isOpen() );
+
+  mMaxOpenFileCount = count;
+}
+
+void PartitionedCsvFileWriter::setBufferSize(std::size_t size) noexcept
+{
+  assert( size > 0 );
+  assert( !isOpen() );
+
+  mBufferSize = size;
+}
+
+void PartitionedCsvFileWriter::open()
+{
+  assert( !directoryPath().empty() );
+  assert( mKeyExtractor );
+
+  close();
+
+  mRecordWriter = std::make_unique<Impl::CsvSinkRecordWriter>(mCsvSettings);
+  mKnownPartitions.clear();
+  mIsOpen = true;
+}
+
+void PartitionedCsvFileWriter::writeLine(const std::vector<std::string> & record)
+{
+  assert( isOpen() );
+
+  writeRecord(record);
+}
+
+void PartitionedCsvFileWriter::writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                                          std::vector< std::vector<std::string> >::const_iterator last)
+{
+  assert( isOpen() );
+
+  for(; first != last; ++first){
+    writeRecord(*first);
+  }
+}
+
+std::string PartitionedCsvFileWriter::partitionFilePath(const std::string & key) const
+{
+  assert( !key.empty() );
+
+  return mDirectoryPath + '/' + key + mFileNameSuffix;
+}
+
+void PartitionedCsvFileWriter::flush()
+{
+  assert( isOpen() );
+
+  try{
+    for(auto & partition : mOpenPartitions){
+      partition.sink.flush();
+    }
+  }catch(const FileWriteError & error){
+    throw CsvFileWriteError( error.what() );
+  }
+}
+
+void PartitionedCsvFileWriter::close()
+{
+  if( !isOpen() ){
+    return;
+  }
+
+  std::string error;
+  for(auto & partition : mOpenPartitions){
+    try{
+      partition.sink.close();
+    }catch(const FileWriteError & closeError){
+      if( error.empty() ){
+        error = closeError.what();
+      }
+    }
+  }
+  mOpenPartitionMap.clear();
+  mOpenPartitions.clear();
+  mRecordWriter.reset();
+  mIsOpen = false;
+
+  if( !error.empty() ){
+    throw CsvFileWriteError(error);
+  }
+}
+
+/*
+ * Records of the same partition often come in runs,
+ * so the most recently used partition is checked
+ * before looking up the map.
+ */
+BufferedFileSink & PartitionedCsvFileWriter::partitionSink(const std::string & key)
+{
+  if( !mOpenPartitions.empty() && (mOpenPartitions.front().key == key) ){
+    return mOpenPartitions.front().sink;
+  }
+
+  const auto it = mOpenPartitionMap.find(key);
+  if( it != mOpenPartitionMap.end() ){
+    mOpenPartitions.splice( mOpenPartitions.begin(), mOpenPartitions, it->second );
+    return it->second->sink;
+  }
+
+  PartitionList::iterator partition;
+  if( openFileCount() < mMaxOpenFileCount ){
+    mOpenPartitions.emplace_front();
+    partition = mOpenPartitions.begin();
+    partition->sink.setBufferSize(mBufferSize);
+  }else{
+    partition = std::prev( mOpenPartitions.end() );
+    mOpenPartitionMap.erase(partition->key);
+    mOpenPartitions.splice( mOpenPartitions.begin(), mOpenPartitions, partition );
+  }
+
+  try{
+    partition->sink.close();
+    partition->key = key;
+    openPartition(*partition);
+  }catch(const FileWriteError & error){
+    mOpenPartitions.erase(partition);
+    throw CsvFileWriteError( error.what() );
+  }catch(...){
+    mOpenPartitions.erase(partition);
+    throw;
+  }
+  mOpenPartitionMap.emplace(key, partition);
+
+  return partition->sink;
+}
+
+/*
+ * A partition that was allready opened since open()
+ * has been evicted, and must not be truncated again
+ */
+void PartitionedCsvFileWriter::openPartition(Partition & partition)
+{
+  assert( !partition.sink.isOpen() );
+
+  FileWriteOpenMode mode = mOpenMode;
+  if( mKnownPartitions.count(partition.key) > 0 ){
+    mode = FileWriteOpenMode::Append;
+  }
+
+  partition.sink.open(partitionFilePath(partition.key), mode);
+  mKnownPartitions.insert(partition.key);
+  if( !mHeader.empty() && (partition.sink.fileSizeAtOpen() == 0) ){
+    (*mRecordWriter)(mHeader, partition.sink);
+  }
+}
+
+void PartitionedCsvFileWriter::writeRecord(const std::vector<std::string> & record)
+{
+  assert( mRecordWriter.get() != nullptr );
+
+  if( record.empty() ){
+    throwKeyError();
+  }
+  const std::string key = mKeyExtractor(record);
+  if( key.empty() ){
+    throwKeyError();
+  }
+  if( !isValidKey(key) ){
+    throwInvalidKeyError(key);
+  }
+
+  BufferedFileSink & sink = partitionSink(key);
+  try{
+    (*mRecordWriter)(record, sink);
+  }catch(const FileWriteError & error){
+    throw CsvFileWriteError( error.what() );
+  }
+}
+
+/*
+ * The key comes from the record data,
+ * so it must not be able to name a file
+ * outside of the directory
+ */
+bool PartitionedCsvFileWriter::isValidKey(const std::string & key) noexcept
+{
+  if( (key == ".") || (key == "..") ){
+    return false;
+  }
+
+  return ( key.find_first_of("/\\") == std::string::npos ) && ( key.find('\0') == std::string::npos );
+}
+
+void PartitionedCsvFileWriter::throwKeyError() const
+{
+  const std::string what = "writing a line in directory '" + mDirectoryPath + "' failed: the record has no partition key";
+  throw CsvFileWriteError(what);
+}
+
+void PartitionedCsvFileWriter::throwInvalidKeyError(const std::string & key) const
+{
+  const std::string what = "writing a line in directory '" + mDirectoryPath + "' failed: the partition key '"
+                         + key + "' is not a valid file name";
+  throw CsvFileWriteError(what);
+}
+
+}} // namespace Mdt{ namespace PlainText{
@@ -0,0 +1,365 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_PARTITIONED_CSV_FILE_WRITER_H
+#define MDT_PLAIN_TEXT_PARTITIONED_CSV_FILE_WRITER_H
+
+#include "FileOpenError.h"
+#include "CsvFileWriteError.h"
+#include "CsvGeneratorSettings.h"
+#include "FileWriteOpenMode.h"
+#include "BufferedFileSink.h"
+#include "mdt_plaintext_export.h"
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Mdt{ namespace PlainText{
+
+  namespace Impl{
+    class CsvSinkRecordWriter;
+  }
+
+  /*! \brief CSV writer that splits records into one file per key
+   *
+   * Each record is routed to a partition by a key extractor,
+   * for example the value of a column.
+   * The records of a partition are written to a file in the directory
+   * set with setDirectoryPath(), named after the key:
+   * \code
+   * Mdt::PlainText::PartitionedCsvFileWriter csvWriter;
+   *
+   * csvWriter.setDirectoryPath("/some/path/to/exports");
+   * csvWriter.setKeyColumn(0);
+   * csvWriter.setHeader({"Customer","Date","Amount"});
+   * csvWriter.open();
+   * csvWriter.writeLine({"Customer1","2020-05-12","12"}); // Written to Customer1.csv
+   * csvWriter.writeLine({"Customer2","2020-05-12","5"});  // Written to Customer2.csv
+   * csvWriter.close();
+   * \endcode
+   *
+   * Each open partition has its own buffered file sink,
+   * so records are written in large blocks.
+   * At most maxOpenFileCount() files are open at the same time:
+   * when a new partition must be opened,
+   * the least recently used one is flushed and closed.
+   * If it receives records again, it is reopened in append mode.
+   *
+   * The memory used by the buffers is at most
+   * maxOpenFileCount() * bufferSize().
+   */
+  class MDT_PLAINTEXT_EXPORT PartitionedCsvFileWriter
+  {
+   public:
+
+    /*! \brief Function that returns the key of a record
+     */
+    using KeyExtractor = std::function<std::string(const std::vector<std::string> & record)>;
+
+    /*! \brief Default maximum count of open files
+     */
+    static constexpr int defaultMaxOpenFileCount = 64;
+
+    /*! \brief Default size of the buffer of each partition, in bytes
+     */
+    static constexpr std::size_t defaultBufferSize = 64 * 1024;
+
+    /*! \brief Construct a partitioned CSV file writer
+     */
+    PartitionedCsvFileWriter();
+
+    /*! \brief Close this CSV file writer
+     *
+     * Pending data are written to the files,
+     * but errors are ignored.
+     * Call close() explicitly to get them reported.
+     */
+    ~PartitionedCsvFileWriter() noexcept;
+
+    PartitionedCsvFileWriter(const PartitionedCsvFileWriter &) = delete;
+    PartitionedCsvFileWriter & operator=(const PartitionedCsvFileWriter &) = delete;
+    PartitionedCsvFileWriter(PartitionedCsvFileWriter &&) = delete;
+    PartitionedCsvFileWriter & operator=(PartitionedCsvFileWriter &&) = delete;
+
+    /*! \brief Set the path to the directory where the files are written
+     *
+     * \pre \a directoryPath must not be empty
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setDirectoryPath(const std::string & directoryPath);
+
+    /*! \brief Get the path to the directory where the files are written
+     */
+    const std::string & directoryPath() const noexcept
+    {
+      return mDirectoryPath;
+    }
+
+    /*! \brief Set the suffix of the file names
+     *
+     * The file of a partition is named key + suffix.
+     *
+     * The default is \c .csv
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setFileNameSuffix(const std::string & suffix);
+
+    /*! \brief Get the suffix of the file names
+     */
+    const std::string & fileNameSuffix() const noexcept
+    {
+      return mFileNameSuffix;
+    }
+
+    /*! \brief Set the key extractor
+     *
+     * \a extractor is called for each record written by writeLine()
+     * and must return the key of its partition.
+     * The key is used as file name,
+     * so it must not be empty and must be a valid file name.
+     * A record whose key contains a '/', a '\\' or a null character,
+     * or whose key is \c . or \c .. , is rejected by writeLine().
+     *
+     * \pre \a extractor must be valid
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     * \sa setKeyColumn()
+     */
+    void setKeyExtractor(const KeyExtractor & extractor);
+
+    /*! \brief Use the value of \a column as key
+     *
+     * A record that has no such column can not be written.
+     *
+     * \pre \a column must be >= 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     * \sa setKeyExtractor()
+     */
+    void setKeyColumn(int column);
+
+    /*! \brief Set the header
+     *
+     * If \a header is not empty,
+     * it is written once at the beginning of each partition file.
+     * If a file opened in append mode allready has some content,
+     * the header is not written again.
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setHeader(const std::vector<std::string> & header);
+
+    /*! \brief Get the header
+     */
+    const std::vector<std::string> & header() const noexcept
+    {
+      return mHeader;
+    }
+
+    /*! \brief Set CSV settings
+     *
+     * \pre \a settings must be valid
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setCsvSettings(const CsvGeneratorSettings & settings) noexcept;
+
+    /*! \brief Get CSV settings
+     */
+    const CsvGeneratorSettings & csvSettings() const noexcept
+    {
+      return mCsvSettings;
+    }
+
+    /*! \brief Set the open mode for this writer
+     *
+     * \a mode is used the first time a partition is opened.
+     * A partition that was closed to open a other one
+     * is always reopened in append mode.
+     *
+     * The default open mode is FileWriteOpenMode::Append
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setOpenMode(FileWriteOpenMode mode) noexcept;
+
+    /*! \brief Get the open mode
+     */
+    FileWriteOpenMode openMode() const noexcept
+    {
+      return mOpenMode;
+    }
+
+    /*! \brief Set the maximum count of files open at the same time
+     *
+     * The default is defaultMaxOpenFileCount
+     *
+     * \pre \a count must be >= 1
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setMaxOpenFileCount(int count) noexcept;
+
+    /*! \brief Get the maximum count of files open at the same time
+     */
+    int maxOpenFileCount() const noexcept
+    {
+      return mMaxOpenFileCount;
+    }
+
+    /*! \brief Set the size of the buffer of each partition
+     *
+     * The default is defaultBufferSize
+     *
+     * \pre \a size must be > 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setBufferSize(std::size_t size) noexcept;
+
+    /*! \brief Get the size of the buffer of each partition
+     */
+    std::size_t bufferSize() const noexcept
+    {
+      return mBufferSize;
+    }
+
+    /*! \brief Open this CSV file writer
+     *
+     * If this file writer is allready open,
+     * it will be closed first.
+     *
+     * No file is opened here:
+     * the file of a partition is opened when its first record is written.
+     *
+     * \exception CsvFileWriteError Thrown if closing the previous files failed
+     * \pre The directory path and the key extractor must have been set
+     * \sa setDirectoryPath()
+     * \sa setKeyExtractor()
+     * \sa close()
+     */
+    void open();
+
+    /*! \brief Check if this file writer is open
+     *
+     * \sa open()
+     */
+    bool isOpen() const noexcept
+    {
+      return mIsOpen;
+    }
+
+    /*! \brief Write a line to the file of its partition
+     *
+     * \exception FileOpenError Thrown if the file of the partition could not be opened
+     * \exception CsvFileWriteError Thrown if \a record is empty,
+     *   if its key is empty or not a valid file name, or if writing failed
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLine(const std::vector<std::string> & record);
+
+    /*! \brief Write the records in the range [\a first, \a last)
+     *
+     * Each record is written to the file of its partition,
+     * as described in writeLine().
+     *
+     * \exception FileOpenError
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                    std::vector< std::vector<std::string> >::const_iterator last);
+
+    /*! \brief Get the count of partitions written since open()
+     */
+    int partitionCount() const noexcept
+    {
+      return static_cast<int>( mKnownPartitions.size() );
+    }
+
+    /*! \brief Get the count of files currently open
+     */
+    int openFileCount() const noexcept
+    {
+      return static_cast<int>( mOpenPartitionMap.size() );
+    }
+
+    /*! \brief Get the path to the file of the partition of \a key
+     *
+     * \pre \a key must not be empty
+     */
+    std::string partitionFilePath(const std::string & key) const;
+
+    /*! \brief Write the pending data of each open partition to its file
+     *
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void flush();
+
+    /*! \brief Close this file writer
+     *
+     * Each open file is flushed and closed.
+     * All files are closed, even if closing one of them failed.
+     *
+     * \exception CsvFileWriteError Thrown with the first error
+     */
+    void close();
+
+   private:
+
+    /*
+     * Open partitions are stored from the most recently used
+     * to the least recently used one.
+     * The node of a evicted partition is reused,
+     * so that its buffer is not allocated again.
+     */
+    struct Partition
+    {
+      std::string key;
+      BufferedFileSink sink;
+    };
+
+    using PartitionList = std::list<Partition>;
+
+    BufferedFileSink & partitionSink(const std::string & key);
+    void openPartition(Partition & partition);
+    void writeRecord(const std::vector<std::string> & record);
+    static bool isValidKey(const std::string & key) noexcept;
+    [[noreturn]] void throwKeyError() const;
+    [[noreturn]] void throwInvalidKeyError(const std::string & key) const;
+
+    std::string mDirectoryPath;
+    std::string mFileNameSuffix = ".csv";
+    KeyExtractor mKeyExtractor;
+    std::vector<std::string> mHeader;
+    CsvGeneratorSettings mCsvSettings;
+    FileWriteOpenMode mOpenMode = FileWriteOpenMode::Append;
+    int mMaxOpenFileCount = defaultMaxOpenFileCount;
+    std::size_t mBufferSize = defaultBufferSize;
+    bool mIsOpen = false;
+    std::unique_ptr<Impl::CsvSinkRecordWriter> mRecordWriter;
+    PartitionList mOpenPartitions;
+    std::unordered_map<std::string, PartitionList::iterator> mOpenPartitionMap;
+    std::unordered_set<std::string> mKnownPartitions;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_PARTITIONED_CSV_FILE_WRITER_H
@@ -0,0 +1,153 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_POSITION_TRACKING_ITERATOR_H
+#define MDT_PLAIN_TEXT_POSITION_TRACKING_ITERATOR_H
+
+#include "SourcePosition.h"
+#include <boost/iterator/iterator_facade.hpp>
+#include <iterator>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief Forward iterator that tracks its position in the source
+   *
+   * Wraps a forward iterator, typically a boost::spirit::multi_pass ,
+   * and counts the offset, the line and the column
+   * each time it is incremented.
+   *
+   * Because the position is part of the iterator,
+   * a parser that backtracks restores it for free
+   * when it restores its iterator.
+   *
+   * \sa SourcePosition
+   */
+  template<typename BaseIterator>
+  class PositionTrackingIterator : public boost::iterator_facade<
+      PositionTrackingIterator<BaseIterator>,                       // Derived
+      typename std::iterator_traits<BaseIterator>::value_type,      // Value
+      boost::forward_traversal_tag,                                 // CategoryOrTraversal
+      typename std::iterator_traits<BaseIterator>::reference        // Reference
+    >
+  {
+    using Reference = typename std::iterator_traits<BaseIterator>::reference;
+    using Value = typename std::iterator_traits<BaseIterator>::value_type;
+
+   public:
+
+    /*! \brief Construct a default iterator
+     */
+    PositionTrackingIterator() = default;
+
+    /*! \brief Construct a iterator at the beginning of the source
+     */
+    explicit PositionTrackingIterator(const BaseIterator & baseIterator)
+     : mBaseIterator(baseIterator)
+    {
+    }
+
+    /*! \brief Construct a end iterator that is reached at \a offsetLimit
+     *
+     * A iterator compares equal to the returned one
+     * when it is at the end of the source,
+     * or when its offset is at least \a offsetLimit .
+     * This can be used to limit the count of chars a parser can consume.
+     *
+     * \pre \a offsetLimit must be >= 0
+     */
+    static
+    PositionTrackingIterator boundedEnd(const BaseIterator & end, int64_t offsetLimit)
+    {
+      assert( offsetLimit >= 0 );
+
+      PositionTrackingIterator it(end);
+      it.mOffsetLimit = offsetLimit;
+
+      return it;
+    }
+
+    /*! \brief Get the current position
+     */
+    SourcePosition position() const noexcept
+    {
+      return SourcePosition(mOffset, mLineNumber, mColumnNumber);
+    }
+
+    /*! \brief Access the wrapped iterator
+     */
+    BaseIterator & base() noexcept
+    {
+      return mBaseIterator;
+    }
+
+    /*! \brief Access the wrapped iterator
+     */
+    const BaseIterator & base() const noexcept
+    {
+      return mBaseIterator;
+    }
+
+   private:
+
+    friend class boost::iterator_core_access;
+
+    void increment()
+    {
+      const Value c = *mBaseIterator;
+      ++mBaseIterator;
+      ++mOffset;
+
+      if(c == '\n'){
+        if(!mAfterCarriageReturn){
+          newLine();
+        }
+        mAfterCarriageReturn = false;
+      }else if(c == '\r'){
+        newLine();
+        mAfterCarriageReturn = true;
+      }else{
+        ++mColumnNumber;
+        mAfterCarriageReturn = false;
+      }
+    }
+
+    bool equal(const PositionTrackingIterator & other) const
+    {
+      if( reachedLimitOf(other) || other.reachedLimitOf(*this) ){
+        return true;
+      }
+      return mBaseIterator == other.mBaseIterator;
+    }
+
+    bool reachedLimitOf(const PositionTrackingIterator & end) const noexcept
+    {
+      return (end.mOffsetLimit >= 0) && (mOffset >= end.mOffsetLimit);
+    }
+
+    Reference dereference() const
+    {
+      return *mBaseIterator;
+    }
+
+    void newLine() noexcept
+    {
+      ++mLineNumber;
+      mColumnNumber = 1;
+    }
+
+    BaseIterator mBaseIterator;
+    int64_t mOffset = 0;
+    int64_t mLineNumber = 1;
+    int64_t mColumnNumber = 1;
+    int64_t mOffsetLimit = -1;
+    bool mAfterCarriageReturn = false;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_POSITION_TRACKING_ITERATOR_H
@@ -0,0 +1,363 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "RotatingCsvFileWriter.h"
+#include "Mdt/PlainText/Impl/CsvSinkRecordWriter.h"
+#include "Mdt/PlainText/Impl/StringSink.h"
+#include <cstdio>
+#include <utility>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+namespace{
+
+  std::unique_ptr<BufferedFileSink> openSink(const std::string & path, std::size_t bufferSize)
+  {
+    auto sink = std::make_unique<BufferedFileSink>();
+
+    sink->setBufferSize(bufferSize);
+    sink->open(path, FileWriteOpenMode::Truncate);
+
+    return sink;
+  }
+
+} // namespace{
+
+RotatingCsvFileWriter::RotatingCsvFileWriter()
+{
+}
+
+RotatingCsvFileWriter::~RotatingCsvFileWriter() noexcept
+{
+  try{
+    close();
+  }catch(...){
+  }
+}
+
+void RotatingCsvFileWriter::setFilePath(const std::string & filePath)
+{
+  assert( !filePath.empty() );
+  assert( !isOpen() );
+
+  mFilePath = filePath;
+}
+
+std::string RotatingCsvFileWriter::rotatedFilePath(int index) const
+{
+  assert( index >= 1 );
+
+  std::string suffix = std::to_string(index);
+  if( suffix.size() < 4 ){
+    suffix.insert(0, 4 - suffix.size(), '0');
+  }
+  suffix.insert(0, 1, '_');
+
+  /*
+   * The extension starts at the last dot of the file name,
+   * unless the file name starts with it, like .hidden
+   */
+  const auto separatorPosition = mFilePath.find_last_of("/\\");
+  std::size_t fileNamePosition = 0;
+  if( separatorPosition != std::string::npos ){
+    fileNamePosition = separatorPosition + 1;
+  }
+  const auto dotPosition = mFilePath.rfind('.');
+  if( (dotPosition == std::string::npos) || (dotPosition <= fileNamePosition) ){
+    return mFilePath + suffix;
+  }
+
+  std::string path = mFilePath;
+  path.insert(dotPosition, suffix);
+
+  return path;
+}
+
+void RotatingCsvFileWriter::setCsvSettings(const CsvGeneratorSettings & settings) noexcept
+{
+  assert( settings.isValid() );
+  assert( !isOpen() );
+
+  mCsvSettings = settings;
+}
+
+void RotatingCsvFileWriter::setHeader(const std::vector<std::string> & header)
+{
+  assert( !isOpen() );
+
+  mHeader = header;
+}
+
+void RotatingCsvFileWriter::setMaxFileSize(int64_t size) noexcept
+{
+  assert( size >= 0 );
+  assert( !isOpen() );
+
+  mMaxFileSize = size;
+}
+
+void RotatingCsvFileWriter::setMaxRecordCount(int64_t count) noexcept
+{
+  assert( count >= 0 );
+  assert( !isOpen() );
+
+  mMaxRecordCount = count;
+}
+
+void RotatingCsvFileWriter::setBufferSize(std::size_t size) noexcept
+{
+  assert( size > 0 );
+  assert( !isOpen() );
+
+  mBufferSize = size;
+}
+
+void RotatingCsvFileWriter::open()
+{
+  assert( !filePath().empty() );
+
+  close();
+
+  mRecordWriter = std::make_unique<Impl::CsvSinkRecordWriter>(mCsvSettings);
+  mFileIndex = 1;
+  mFileSize = 0;
+  mFileRecordCount = 0;
+  mTotalSize = 0;
+  mTotalRecordCount = 0;
+  mSink = openSink(rotatedFilePath(mFileIndex), mBufferSize);
+  writeHeader();
+  openNextSinkInBackground();
+}
+
+void RotatingCsvFileWriter::writeLine(const std::vector<std::string> & record)
+{
+  assert( isOpen() );
+
+  if( !writeRecord(record) ){
+    throwLineError();
+  }
+}
+
+void RotatingCsvFileWriter::writeTypedLine(const std::vector<CsvValue> & record)
+{
+  assert( isOpen() );
+
+  if( !writeRecord(record) ){
+    throwLineError();
+  }
+}
+
+void RotatingCsvFileWriter::writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                                       std::vector< std::vector<std::string> >::const_iterator last)
+{
+  assert( isOpen() );
+
+  if(first == last){
+    return;
+  }
+
+  bool ok = false;
+  for(; first != last; ++first){
+    if( writeRecord(*first) ){
+      ok = true;
+    }
+  }
+  if(!ok){
+    throwLineError();
+  }
+}
+
+void RotatingCsvFileWriter::close()
+{
+  if( !isOpen() ){
+    return;
+  }
+
+  std::string error;
+  try{
+    mSink->close();
+  }catch(const FileWriteError & closeError){
+    error = closeError.what();
+  }
+  mSink.reset();
+  try{
+    waitPreviousSinkClosed();
+  }catch(const CsvFileWriteError & closeError){
+    if( error.empty() ){
+      error = closeError.what();
+    }
+  }
+  discardNextSink();
+  mRecordWriter.reset();
+
+  if( !error.empty() ){
+    throw CsvFileWriteError(error);
+  }
+}
+
+/*
+ * The record is formatted to mRecordData first,
+ * so that its size is known before choosing the file.
+ * mRecordData keeps its capacity, so this does not allocate.
+ */
+template<typename Record>
+bool RotatingCsvFileWriter::writeRecord(const Record & record)
+{
+  assert( mRecordWriter.get() != nullptr );
+
+  mRecordData.clear();
+  Impl::StringSink stringSink(mRecordData);
+  if( !(*mRecordWriter)(record, stringSink) ){
+    return false;
+  }
+
+  if( mustRollOver( mRecordData.size() ) ){
+    rollOver();
+  }
+  writeData();
+  ++mFileRecordCount;
+  ++mTotalRecordCount;
+
+  return true;
+}
+
+/*
+ * A file has at least one record,
+ * even if it is larger than the maximum file size
+ */
+bool RotatingCsvFileWriter::mustRollOver(std::size_t recordSize) const noexcept
+{
+  if(mFileRecordCount == 0){
+    return false;
+  }
+  if( (mMaxRecordCount > 0) && (mFileRecordCount >= mMaxRecordCount) ){
+    return true;
+  }
+  if( (mMaxFileSize > 0) && (mFileSize + static_cast<int64_t>(recordSize) > mMaxFileSize) ){
+    return true;
+  }
+
+  return false;
+}
+
+/*
+ * The current sink is closed by a background task,
+ * which is waited for at the next roll over, or by close()
+ */
+void RotatingCsvFileWriter::rollOver()
+{
+  Sink nextSink = takeNextSink();
+  waitPreviousSinkClosed();
+
+  mPreviousSinkClosed = std::async(std::launch::async, [](Sink sink){
+    sink->close();
+  }, std::move(mSink));
+  mSink = std::move(nextSink);
+  ++mFileIndex;
+  mFileSize = 0;
+  mFileRecordCount = 0;
+
+  /*
+   * The record to write is in mRecordData,
+   * it is kept aside while the header is written
+   */
+  std::string recordData;
+  recordData.swap(mRecordData);
+  writeHeader();
+  recordData.swap(mRecordData);
+
+  openNextSinkInBackground();
+}
+
+void RotatingCsvFileWriter::writeHeader()
+{
+  if( mHeader.empty() ){
+    return;
+  }
+
+  mRecordData.clear();
+  Impl::StringSink stringSink(mRecordData);
+  (*mRecordWriter)(mHeader, stringSink);
+  writeData();
+}
+
+void RotatingCsvFileWriter::writeData()
+{
+  assert( isOpen() );
+
+  try{
+    mSink->write( mRecordData.data(), mRecordData.size() );
+  }catch(const FileWriteError & error){
+    throw CsvFileWriteError( error.what() );
+  }
+  mFileSize += static_cast<int64_t>( mRecordData.size() );
+  mTotalSize += static_cast<int64_t>( mRecordData.size() );
+}
+
+void RotatingCsvFileWriter::openNextSinkInBackground()
+{
+  assert( !mNextSink.valid() );
+
+  mNextSink = std::async(std::launch::async, openSink, rotatedFilePath(mFileIndex + 1), mBufferSize);
+}
+
+/*
+ * If opening the next file failed in the background,
+ * or in a previous call, it is tried again here,
+ * in the calling thread
+ */
+RotatingCsvFileWriter::Sink RotatingCsvFileWriter::takeNextSink()
+{
+  if( mNextSink.valid() ){
+    try{
+      return mNextSink.get();
+    }catch(const FileOpenError &){
+    }
+  }
+
+  return openSink(rotatedFilePath(mFileIndex + 1), mBufferSize);
+}
+
+void RotatingCsvFileWriter::waitPreviousSinkClosed()
+{
+  if( !mPreviousSinkClosed.valid() ){
+    return;
+  }
+
+  try{
+    mPreviousSinkClosed.get();
+  }catch(const FileWriteError & error){
+    throw CsvFileWriteError( error.what() );
+  }
+}
+
+/*
+ * The next file has been created in advance,
+ * but no record has been written to it
+ */
+void RotatingCsvFileWriter::discardNextSink() noexcept
+{
+  if( !mNextSink.valid() ){
+    return;
+  }
+
+  try{
+    Sink sink = mNextSink.get();
+    const std::string path = sink->path();
+    sink->close();
+    std::remove( path.c_str() );
+  }catch(...){
+  }
+}
+
+void RotatingCsvFileWriter::throwLineError() const
+{
+  const std::string what = "writing a line in file '" + currentFilePath() + "' failed";
+  throw CsvFileWriteError(what);
+}
+
+}} // namespace Mdt{ namespace PlainText{
@@ -0,0 +1,355 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_ROTATING_CSV_FILE_WRITER_H
+#define MDT_PLAIN_TEXT_ROTATING_CSV_FILE_WRITER_H
+
+#include "FileOpenError.h"
+#include "CsvFileWriteError.h"
+#include "CsvGeneratorSettings.h"
+#include "BufferedFileSink.h"
+#include "CsvValue.h"
+#include "mdt_plaintext_export.h"
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Mdt{ namespace PlainText{
+
+  namespace Impl{
+    class CsvSinkRecordWriter;
+  }
+
+  /*! \brief CSV writer that splits a export into files of limited size
+   *
+   * The records are written to a file until it reaches
+   * maxFileSize() bytes or maxRecordCount() records,
+   * then the writer rolls over to the next file.
+   * A record is never split over two files.
+   *
+   * The files are named after the path set with setFilePath(),
+   * as described in rotatedFilePath():
+   * \code
+   * Mdt::PlainText::RotatingCsvFileWriter csvWriter;
+   *
+   * csvWriter.setFilePath("/some/path/to/export.csv");
+   * csvWriter.setMaxFileSize(512 * 1024 * 1024);
+   * csvWriter.setHeader({"A","B","C"});
+   * csvWriter.open();
+   * for(const auto & record : records){
+   *   csvWriter.writeLine(record); // Written to export_0001.csv, export_0002.csv, ...
+   * }
+   * csvWriter.close();
+   * \endcode
+   *
+   * The next file is opened in the background while the current one is written,
+   * and the previous file is closed in the background,
+   * so rolling over does not wait for the file system.
+   *
+   * Each file is created, or truncated if it exists.
+   * The next file, opened in advance,
+   * is removed by close() if no record has been written to it.
+   */
+  class MDT_PLAINTEXT_EXPORT RotatingCsvFileWriter
+  {
+   public:
+
+    /*! \brief Construct a rotating CSV file writer
+     */
+    RotatingCsvFileWriter();
+
+    /*! \brief Close this CSV file writer
+     *
+     * Pending data are written to the file,
+     * but errors are ignored.
+     * Call close() explicitly to get them reported.
+     */
+    ~RotatingCsvFileWriter() noexcept;
+
+    RotatingCsvFileWriter(const RotatingCsvFileWriter &) = delete;
+    RotatingCsvFileWriter & operator=(const RotatingCsvFileWriter &) = delete;
+    RotatingCsvFileWriter(RotatingCsvFileWriter &&) = delete;
+    RotatingCsvFileWriter & operator=(RotatingCsvFileWriter &&) = delete;
+
+    /*! \brief Set the path from which the file names are built
+     *
+     * \pre \a filePath must not be empty
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     * \sa rotatedFilePath()
+     */
+    void setFilePath(const std::string & filePath);
+
+    /*! \brief Get the path from which the file names are built
+     */
+    const std::string & filePath() const noexcept
+    {
+      return mFilePath;
+    }
+
+    /*! \brief Get the path of the file of \a index
+     *
+     * The index, starting from 1, is written on at least 4 digits,
+     * and inserted before the extension of filePath().
+     * For example, with \c /path/export.csv ,
+     * the first file is \c /path/export_0001.csv .
+     *
+     * \pre \a index must be >= 1
+     */
+    std::string rotatedFilePath(int index) const;
+
+    /*! \brief Set CSV settings
+     *
+     * \pre \a settings must be valid
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setCsvSettings(const CsvGeneratorSettings & settings) noexcept;
+
+    /*! \brief Get CSV settings
+     */
+    const CsvGeneratorSettings & csvSettings() const noexcept
+    {
+      return mCsvSettings;
+    }
+
+    /*! \brief Set the header
+     *
+     * If \a header is not empty,
+     * it is written at the beginning of each file.
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setHeader(const std::vector<std::string> & header);
+
+    /*! \brief Get the header
+     */
+    const std::vector<std::string> & header() const noexcept
+    {
+      return mHeader;
+    }
+
+    /*! \brief Set the maximum size of a file, in bytes
+     *
+     * The size includes the header.
+     * A file can only be larger if a single record does not fit in it.
+     *
+     * The default is 0, which means no limit.
+     *
+     * \pre \a size must be >= 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setMaxFileSize(int64_t size) noexcept;
+
+    /*! \brief Get the maximum size of a file
+     */
+    int64_t maxFileSize() const noexcept
+    {
+      return mMaxFileSize;
+    }
+
+    /*! \brief Set the maximum count of records in a file
+     *
+     * The header is not counted.
+     *
+     * The default is 0, which means no limit.
+     *
+     * \pre \a count must be >= 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setMaxRecordCount(int64_t count) noexcept;
+
+    /*! \brief Get the maximum count of records in a file
+     */
+    int64_t maxRecordCount() const noexcept
+    {
+      return mMaxRecordCount;
+    }
+
+    /*! \brief Set the size of the write buffer
+     *
+     * The default is BufferedFileSink::defaultBufferSize
+     *
+     * \pre \a size must be > 0
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setBufferSize(std::size_t size) noexcept;
+
+    /*! \brief Get the size of the write buffer
+     */
+    std::size_t bufferSize() const noexcept
+    {
+      return mBufferSize;
+    }
+
+    /*! \brief Open this CSV file writer
+     *
+     * If this file writer is allready open,
+     * it will be closed first.
+     *
+     * The first file is opened here,
+     * and the header is written to it.
+     *
+     * \exception FileOpenError
+     * \exception CsvFileWriteError
+     * \pre A path to a file must have been set
+     * \sa setFilePath()
+     * \sa close()
+     */
+    void open();
+
+    /*! \brief Check if this file writer is open
+     *
+     * \sa open()
+     */
+    bool isOpen() const noexcept
+    {
+      return mSink.get() != nullptr;
+    }
+
+    /*! \brief Write a line
+     *
+     * If \a record does not fit in the current file,
+     * the writer rolls over to the next file first.
+     * The next file is opened in advance, in the background.
+     * If this failed, opening it is tried again here.
+     *
+     * \exception FileOpenError Thrown if the next file could not be opened at roll over.
+     *   \a record is then not written, and this writer stays on the current file.
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLine(const std::vector<std::string> & record);
+
+    /*! \brief Write a line of typed values
+     *
+     * Values are formatted as described in CsvFileWriter::writeTypedLine(),
+     * otherwise this function works like writeLine().
+     *
+     * \exception FileOpenError
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeTypedLine(const std::vector<CsvValue> & record);
+
+    /*! \brief Write the records in the range [\a first, \a last)
+     *
+     * Like CsvFileWriter::writeLines(), empty records are skipped,
+     * but at least one record must be written.
+     * If the range is empty, nothing is written.
+     *
+     * \exception FileOpenError
+     * \exception CsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLines(std::vector< std::vector<std::string> >::const_iterator first,
+                    std::vector< std::vector<std::string> >::const_iterator last);
+
+    /*! \brief Get the index of the current file
+     *
+     * \sa rotatedFilePath()
+     */
+    int fileIndex() const noexcept
+    {
+      return mFileIndex;
+    }
+
+    /*! \brief Get the path of the current file
+     *
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    std::string currentFilePath() const
+    {
+      return rotatedFilePath(mFileIndex);
+    }
+
+    /*! \brief Get the count of bytes written to the current file
+     *
+     * Data that are still in the buffer are included.
+     */
+    int64_t fileSize() const noexcept
+    {
+      return mFileSize;
+    }
+
+    /*! \brief Get the count of records written to the current file
+     */
+    int64_t fileRecordCount() const noexcept
+    {
+      return mFileRecordCount;
+    }
+
+    /*! \brief Get the count of bytes written since open()
+     */
+    int64_t totalSize() const noexcept
+    {
+      return mTotalSize;
+    }
+
+    /*! \brief Get the count of records written since open()
+     */
+    int64_t totalRecordCount() const noexcept
+    {
+      return mTotalRecordCount;
+    }
+
+    /*! \brief Close this file writer
+     *
+     * Pending data are written to the current file before closing it.
+     *
+     * \exception CsvFileWriteError
+     */
+    void close();
+
+   private:
+
+    using Sink = std::unique_ptr<BufferedFileSink>;
+
+    template<typename Record>
+    bool writeRecord(const Record & record);
+
+    bool mustRollOver(std::size_t recordSize) const noexcept;
+    void rollOver();
+    void writeHeader();
+    void writeData();
+    void openNextSinkInBackground();
+    Sink takeNextSink();
+    void waitPreviousSinkClosed();
+    void discardNextSink() noexcept;
+    [[noreturn]] void throwLineError() const;
+
+    std::string mFilePath;
+    CsvGeneratorSettings mCsvSettings;
+    std::vector<std::string> mHeader;
+    int64_t mMaxFileSize = 0;
+    int64_t mMaxRecordCount = 0;
+    std::size_t mBufferSize = BufferedFileSink::defaultBufferSize;
+    std::unique_ptr<Impl::CsvSinkRecordWriter> mRecordWriter;
+    std::string mRecordData;
+    Sink mSink;
+    std::future<Sink> mNextSink;
+    std::future<void> mPreviousSinkClosed;
+    int mFileIndex = 0;
+    int64_t mFileSize = 0;
+    int64_t mFileRecordCount = 0;
+    int64_t mTotalSize = 0;
+    int64_t mTotalRecordCount = 0;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_ROTATING_CSV_FILE_WRITER_H
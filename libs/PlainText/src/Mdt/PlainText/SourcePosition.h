@@ -0,0 +1,81 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MDT_PLAIN_TEXT_SOURCE_POSITION_H
+#define MDT_PLAIN_TEXT_SOURCE_POSITION_H
+
+#include "mdt_plaintext_export.h"
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace PlainText{
+
+  /*! \brief Position in a text source
+   *
+   * The offset is the count of chars from the beginning of the source.
+   * For a CsvFileReader, a char is a byte.
+   * For a QCsvFileReader, a char is a unicode code point.
+   *
+   * Line and column numbers start at 1.
+   * A LF, a CR or a CR LF sequence ends a line.
+   *
+   * \sa PositionTrackingIterator
+   */
+  class MDT_PLAINTEXT_EXPORT SourcePosition
+  {
+   public:
+
+    /*! \brief Construct a position at the beginning of a source
+     */
+    constexpr SourcePosition() noexcept = default;
+
+    /*! \brief Construct a position
+     *
+     * \pre \a offset must be >= 0
+     * \pre \a lineNumber must be >= 1
+     * \pre \a columnNumber must be >= 1
+     */
+    constexpr SourcePosition(int64_t offset, int64_t lineNumber, int64_t columnNumber) noexcept
+     : mOffset(offset),
+       mLineNumber(lineNumber),
+       mColumnNumber(columnNumber)
+    {
+      assert( offset >= 0 );
+      assert( lineNumber >= 1 );
+      assert( columnNumber >= 1 );
+    }
+
+    /*! \brief Get the offset from the beginning of the source
+     */
+    constexpr int64_t offset() const noexcept
+    {
+      return mOffset;
+    }
+
+    /*! \brief Get the line number
+     */
+    constexpr int64_t lineNumber() const noexcept
+    {
+      return mLineNumber;
+    }
+
+    /*! \brief Get the column number
+     */
+    constexpr int64_t columnNumber() const noexcept
+    {
+      return mColumnNumber;
+    }
+
+   private:
+
+    int64_t mOffset = 0;
+    int64_t mLineNumber = 1;
+    int64_t mColumnNumber = 1;
+  };
+
+}} // namespace Mdt{ namespace PlainText{
+
+#endif // #ifndef MDT_PLAIN_TEXT_SOURCE_POSITION_H
@@ -0,0 +1,250 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "CsvFileWriterTestCommon.h"
+#include "Mdt/PlainText/AsyncCsvFileWriter"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+void setFilePathToWriter(const QString & filePath, AsyncCsvFileWriter & writer)
+{
+  writer.setFilePath( filePath.toLocal8Bit().toStdString() );
+}
+
+std::vector<std::string> splitLines(const std::string & data)
+{
+  std::vector<std::string> lines;
+  std::istringstream stream(data);
+  std::string line;
+
+  while( std::getline(stream, line) ){
+    lines.push_back(line);
+  }
+
+  return lines;
+}
+
+/*
+ * Each producer writes lineCount lines: producer,line
+ */
+void writeProducerLines(AsyncCsvFileWriter & writer, int producer, int lineCount)
+{
+  for(int line = 0; line < lineCount; ++line){
+    writer.writeLine({std::to_string(producer), std::to_string(line)});
+  }
+}
+
+/*
+ * Check that each producer wrote all its lines, in order
+ */
+bool producerLinesAreComplete(const std::vector<std::string> & lines, int producerCount, int lineCount)
+{
+  std::vector<int> nextLine(producerCount, 0);
+
+  for(const auto & line : lines){
+    const auto separator = line.find(',');
+    if(separator == std::string::npos){
+      return false;
+    }
+    const int producer = std::stoi( line.substr(0, separator) );
+    const int lineNumber = std::stoi( line.substr(separator + 1) );
+    if( (producer < 0) || (producer >= producerCount) ){
+      return false;
+    }
+    if( lineNumber != nextLine[producer] ){
+      return false;
+    }
+    ++nextLine[producer];
+  }
+
+  return std::all_of(nextLine.cbegin(), nextLine.cend(), [lineCount](int n){ return n == lineCount; });
+}
+
+TEST_CASE("defaults")
+{
+  AsyncCsvFileWriter writer;
+  REQUIRE( writer.filePath().empty() );
+  REQUIRE( writer.openMode() == FileWriteOpenMode::Append );
+  REQUIRE( writer.queueCapacity() == AsyncCsvFileWriter::defaultQueueCapacity );
+  REQUIRE( !writer.isOpen() );
+}
+
+TEST_CASE("set_get")
+{
+  AsyncCsvFileWriter writer;
+
+  writer.setFilePath("file.csv");
+  REQUIRE( writer.filePath() == "file.csv" );
+
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  REQUIRE( writer.openMode() == FileWriteOpenMode::Truncate );
+
+  writer.setQueueCapacity(1024);
+  REQUIRE( writer.queueCapacity() == 1024 );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setFieldSeparator(';');
+  writer.setCsvSettings(csvSettings);
+  REQUIRE( writer.csvSettings().fieldSeparator() == ';' );
+}
+
+TEST_CASE("open_close")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  AsyncCsvFileWriter writer;
+  setFilePathToWriter(filePathFromDirAndFileName(dir, "file.csv"), writer);
+
+  writer.open();
+  REQUIRE( writer.isOpen() );
+  writer.open();
+  REQUIRE( writer.isOpen() );
+  writer.close();
+  REQUIRE( !writer.isOpen() );
+  writer.close();
+  REQUIRE( !writer.isOpen() );
+}
+
+TEST_CASE("open_error")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  AsyncCsvFileWriter writer;
+  setFilePathToWriter(dir.path(), writer);
+  REQUIRE_THROWS_AS( writer.open(), FileOpenError );
+  REQUIRE( !writer.isOpen() );
+}
+
+TEST_CASE("write")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  AsyncCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  setFilePathToWriter(filePath, writer);
+  writer.open();
+
+  SECTION("writeLine")
+  {
+    writer.writeLine({"A","b,c"});
+    writer.writeLine({"1"});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A,\"b,c\"\n1\n" );
+  }
+
+  SECTION("writeTypedLine")
+  {
+    writer.writeTypedLine({"A", 2, 0.5, true});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A,2,0.5,true\n" );
+  }
+
+  SECTION("writeLines")
+  {
+    const std::vector< std::vector<std::string> > table{{"A","B"},{},{"1","2"}};
+    writer.writeLines( table.cbegin(), table.cbegin() );
+    writer.writeLines( table.cbegin(), table.cend() );
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A,B\n1,2\n" );
+  }
+
+  SECTION("flush")
+  {
+    writer.writeLine({"A"});
+    writer.flush();
+    REQUIRE( readBinaryFile(filePath) == "A\n" );
+    writer.writeLine({"B"});
+    writer.flush();
+    REQUIRE( readBinaryFile(filePath) == "A\nB\n" );
+    writer.flush();
+    REQUIRE( readBinaryFile(filePath) == "A\nB\n" );
+    writer.close();
+  }
+
+  SECTION("empty record")
+  {
+    REQUIRE_THROWS_AS( writer.writeLine({}), CsvFileWriteError );
+    const std::vector< std::vector<std::string> > table{{},{}};
+    REQUIRE_THROWS_AS( writer.writeLines( table.cbegin(), table.cend() ), CsvFileWriteError );
+    writer.close();
+    REQUIRE( readBinaryFile(filePath).empty() );
+  }
+}
+
+TEST_CASE("multipleProducers")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const int producerCount = 4;
+  const int lineCount = 2000;
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  AsyncCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  setFilePathToWriter(filePath, writer);
+
+  SECTION("default queue capacity")
+  {
+  }
+
+  SECTION("small queue capacity")
+  {
+    writer.setQueueCapacity(16);
+  }
+
+  writer.open();
+
+  std::vector<std::thread> producers;
+  for(int producer = 0; producer < producerCount; ++producer){
+    producers.emplace_back(writeProducerLines, std::ref(writer), producer, lineCount);
+  }
+  for(auto & producer : producers){
+    producer.join();
+  }
+  writer.close();
+
+  const auto lines = splitLines( readBinaryFile(filePath) );
+  REQUIRE( lines.size() == static_cast<std::size_t>(producerCount * lineCount) );
+  REQUIRE( producerLinesAreComplete(lines, producerCount, lineCount) );
+}
+
+#if defined(__linux__)
+TEST_CASE("writeError")
+{
+  AsyncCsvFileWriter writer;
+  writer.setFilePath("/dev/full");
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.open();
+
+  writer.writeLine({"A"});
+
+  SECTION("flush")
+  {
+    REQUIRE_THROWS_AS( writer.flush(), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({"B"}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.close(), CsvFileWriteError );
+  }
+
+  SECTION("close")
+  {
+    REQUIRE_THROWS_AS( writer.close(), CsvFileWriteError );
+  }
+
+  REQUIRE( !writer.isOpen() );
+}
+#endif // #if defined(__linux__)
@@ -0,0 +1,314 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/BufferedFileSink.h"
+#include "Mdt/PlainText/TestLib/TextFileUtils.h"
+#include <QTemporaryDir>
+#include <QDir>
+#include <QString>
+#include <QLatin1String>
+#include <QLatin1Char>
+#include <string>
+#include <cassert>
+
+using namespace Mdt::PlainText;
+
+std::string filePathFromDirAndFileName(const QTemporaryDir & dir, const char *fileName)
+{
+  assert( dir.isValid() );
+
+  return QDir::cleanPath( dir.path() + QLatin1Char('/') + QLatin1String(fileName) ).toLocal8Bit().toStdString();
+}
+
+QString readTextFile(const std::string & filePath)
+{
+  return Mdt::PlainText::TestLib::readTextFileUtf8( QString::fromLocal8Bit( filePath.c_str() ) );
+}
+
+bool writeTextFile(const std::string & filePath, const QString & content)
+{
+  return Mdt::PlainText::TestLib::writeTextFileUtf8(QString::fromLocal8Bit( filePath.c_str() ), content);
+}
+
+void putString(const std::string & str, BufferedFileSink & sink)
+{
+  auto it = sink.outputIterator();
+
+  for(char c : str){
+    *it = c;
+    ++it;
+  }
+}
+
+
+TEST_CASE("bufferSize")
+{
+  BufferedFileSink sink;
+
+  SECTION("default")
+  {
+    REQUIRE( sink.bufferSize() == BufferedFileSink::defaultBufferSize );
+  }
+
+  SECTION("set and get")
+  {
+    sink.setBufferSize(16);
+    REQUIRE( sink.bufferSize() == 16 );
+  }
+}
+
+TEST_CASE("preallocatedSize")
+{
+  BufferedFileSink sink;
+
+  SECTION("default")
+  {
+    REQUIRE( sink.preallocatedSize() == 0 );
+  }
+
+  SECTION("set and get")
+  {
+    sink.setPreallocatedSize(1024);
+    REQUIRE( sink.preallocatedSize() == 1024 );
+  }
+}
+
+TEST_CASE("open_close")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  BufferedFileSink sink;
+  REQUIRE( !sink.isOpen() );
+
+  SECTION("Append to existing file")
+  {
+    const std::string filePath = filePathFromDirAndFileName(dir, "existing.csv");
+    REQUIRE( writeTextFile(filePath, QLatin1String("ABC")) );
+
+    sink.open(filePath, FileWriteOpenMode::Append);
+    REQUIRE( sink.isOpen() );
+    REQUIRE( sink.path() == filePath );
+    REQUIRE( sink.fileSizeAtOpen() == 3 );
+    putString("DE", sink);
+    sink.close();
+    REQUIRE( !sink.isOpen() );
+    REQUIRE( readTextFile(filePath) == QLatin1String("ABCDE") );
+  }
+
+  SECTION("Truncate existing file")
+  {
+    const std::string filePath = filePathFromDirAndFileName(dir, "existing.csv");
+    REQUIRE( writeTextFile(filePath, QLatin1String("ABC")) );
+
+    sink.open(filePath, FileWriteOpenMode::Truncate);
+    REQUIRE( sink.fileSizeAtOpen() == 0 );
+    putString("DE", sink);
+    sink.close();
+    REQUIRE( readTextFile(filePath) == QLatin1String("DE") );
+  }
+
+  SECTION("Open a other file after close")
+  {
+    const std::string filePath1 = filePathFromDirAndFileName(dir, "file1.csv");
+    const std::string filePath2 = filePathFromDirAndFileName(dir, "file2.csv");
+
+    sink.open(filePath1, FileWriteOpenMode::Append);
+    REQUIRE( sink.fileSizeAtOpen() == 0 );
+    putString("AB", sink);
+    sink.close();
+    sink.open(filePath2, FileWriteOpenMode::Append);
+    putString("C", sink);
+    sink.close();
+    sink.open(filePath1, FileWriteOpenMode::Append);
+    REQUIRE( sink.fileSizeAtOpen() == 2 );
+    putString("D", sink);
+    sink.close();
+    REQUIRE( readTextFile(filePath1) == QLatin1String("ABD") );
+    REQUIRE( readTextFile(filePath2) == QLatin1String("C") );
+  }
+
+  SECTION("Path refers to a directory")
+  {
+    const std::string dirPath = dir.path().toLocal8Bit().toStdString();
+
+    REQUIRE_THROWS_AS( sink.open(dirPath, FileWriteOpenMode::Append), FileOpenError );
+    REQUIRE( !sink.isOpen() );
+  }
+}
+
+TEST_CASE("openTemporaryFile")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const std::string filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  SECTION("Existing files are not touched")
+  {
+    REQUIRE( writeTextFile(filePath, QLatin1String("ABC")) );
+    REQUIRE( writeTextFile(filePath + ".tmp", QLatin1String("DEF")) );
+
+    BufferedFileSink sink;
+    sink.openTemporaryFile(filePath);
+    REQUIRE( sink.isOpen() );
+    REQUIRE( sink.path().compare(0, filePath.size() + 1, filePath + '.') == 0 );
+    REQUIRE( sink.path().size() > filePath.size() + 1 );
+    REQUIRE( sink.fileSizeAtOpen() == 0 );
+    putString("GH", sink);
+    sink.close();
+    REQUIRE( readTextFile(sink.path()) == QLatin1String("GH") );
+    REQUIRE( readTextFile(filePath) == QLatin1String("ABC") );
+    REQUIRE( readTextFile(filePath + ".tmp") == QLatin1String("DEF") );
+  }
+
+  SECTION("Each sink has its own file")
+  {
+    BufferedFileSink sink1;
+    BufferedFileSink sink2;
+    sink1.openTemporaryFile(filePath);
+    sink2.openTemporaryFile(filePath);
+    REQUIRE( sink1.path() != sink2.path() );
+    putString("A", sink1);
+    putString("B", sink2);
+    sink1.close();
+    sink2.close();
+    REQUIRE( readTextFile(sink1.path()) == QLatin1String("A") );
+    REQUIRE( readTextFile(sink2.path()) == QLatin1String("B") );
+  }
+
+  SECTION("Directory does not exist")
+  {
+    BufferedFileSink sink;
+    const std::string notExistingFilePath = filePathFromDirAndFileName(dir, "NotExisting/file.csv");
+
+    REQUIRE_THROWS_AS( sink.openTemporaryFile(notExistingFilePath), FileOpenError );
+    REQUIRE( !sink.isOpen() );
+  }
+}
+
+TEST_CASE("put")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const std::string filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  BufferedFileSink sink;
+
+  SECTION("fits in the buffer")
+  {
+    sink.open(filePath, FileWriteOpenMode::Truncate);
+    putString("A,B\n", sink);
+    sink.close();
+    REQUIRE( readTextFile(filePath) == QLatin1String("A,B\n") );
+  }
+
+  SECTION("larger than the buffer")
+  {
+    sink.setBufferSize(3);
+    sink.open(filePath, FileWriteOpenMode::Truncate);
+    putString("ABCDEFGHIJ\n", sink);
+    sink.close();
+    REQUIRE( readTextFile(filePath) == QLatin1String("ABCDEFGHIJ\n") );
+  }
+}
+
+TEST_CASE("write")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const std::string filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  BufferedFileSink sink;
+  sink.setBufferSize(4);
+  sink.open(filePath, FileWriteOpenMode::Truncate);
+
+  SECTION("fits in the buffer")
+  {
+    sink.write("AB", 2);
+    sink.write("CD", 2);
+    sink.close();
+    REQUIRE( readTextFile(filePath) == QLatin1String("ABCD") );
+  }
+
+  SECTION("larger than the buffer")
+  {
+    sink.write("AB", 2);
+    sink.write("CDEFGHIJ", 8);
+    sink.write("K", 1);
+    sink.close();
+    REQUIRE( readTextFile(filePath) == QLatin1String("ABCDEFGHIJK") );
+  }
+
+  SECTION("mixed with put")
+  {
+    putString("ABC", sink);
+    sink.write("DEF", 3);
+    putString("GH", sink);
+    sink.close();
+    REQUIRE( readTextFile(filePath) == QLatin1String("ABCDEFGH") );
+  }
+}
+
+TEST_CASE("flush")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const std::string filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  BufferedFileSink sink;
+  sink.open(filePath, FileWriteOpenMode::Truncate);
+  putString("ABC", sink);
+  REQUIRE( readTextFile(filePath).isEmpty() );
+
+  sink.flush();
+  REQUIRE( readTextFile(filePath) == QLatin1String("ABC") );
+
+  sink.close();
+  REQUIRE( readTextFile(filePath) == QLatin1String("ABC") );
+}
+
+TEST_CASE("sync")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const std::string filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  BufferedFileSink sink;
+  sink.open(filePath, FileWriteOpenMode::Truncate);
+  putString("ABC", sink);
+
+  sink.sync();
+  REQUIRE( readTextFile(filePath) == QLatin1String("ABC") );
+
+  putString("D", sink);
+  sink.syncWrittenData();
+  REQUIRE( readTextFile(filePath) == QLatin1String("ABC") );
+
+  sink.close();
+  REQUIRE( readTextFile(filePath) == QLatin1String("ABCD") );
+}
+
+TEST_CASE("preallocate")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const std::string filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  BufferedFileSink sink;
+  sink.setPreallocatedSize(1024*1024);
+  sink.open(filePath, FileWriteOpenMode::Truncate);
+  putString("ABC", sink);
+  sink.close();
+
+  REQUIRE( readTextFile(filePath) == QLatin1String("ABC") );
+}
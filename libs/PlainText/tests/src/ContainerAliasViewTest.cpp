@@ -33,6 +33,15 @@ TEST_CASE("construct")
   REQUIRE( view.size() == 1 );
 }
 
+TEST_CASE("construct_range")
+{
+  IntList list{1,2,3,4};
+  IntListAsDoubleListView view(list.cbegin() + 1, list.cbegin() + 3);
+  REQUIRE( view.size() == 2 );
+  REQUIRE( doubleAreEqual(view.at(0), 2.0) );
+  REQUIRE( doubleAreEqual(view.at(1), 3.0) );
+}
+
 TEST_CASE("size")
 {
   IntList list;
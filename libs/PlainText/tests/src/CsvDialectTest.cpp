@@ -0,0 +1,130 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/CsvDialect"
+#include <string>
+
+using namespace Mdt::PlainText;
+
+/*
+ * Used to check which dialect visitCsvDialect() selects
+ */
+template<typename Dialect>
+struct DialectName
+{
+  static std::string name()
+  {
+    return "runtime";
+  }
+};
+
+template<bool ParseExp>
+struct DialectName< CommaCsvDialect<ParseExp> >
+{
+  static std::string name()
+  {
+    return ParseExp ? "comma" : "comma no EXP";
+  }
+};
+
+template<bool ParseExp>
+struct DialectName< SemicolonCsvDialect<ParseExp> >
+{
+  static std::string name()
+  {
+    return ParseExp ? "semicolon" : "semicolon no EXP";
+  }
+};
+
+template<bool ParseExp>
+struct DialectName< TabCsvDialect<ParseExp> >
+{
+  static std::string name()
+  {
+    return ParseExp ? "tab" : "tab no EXP";
+  }
+};
+
+std::string visitedDialectName(const CsvParserSettings & settings)
+{
+  return visitCsvDialect(settings, [](auto dialect){
+    return DialectName<decltype(dialect)>::name();
+  });
+}
+
+
+TEST_CASE("CsvDialect")
+{
+  using Dialect = CsvDialect<';', '\'', false>;
+
+  static_assert( Dialect::fieldSeparator() == ';', "" );
+  static_assert( Dialect::fieldProtection() == '\'', "" );
+  static_assert( !Dialect::parseExp(), "" );
+
+  constexpr CsvParserSettings settings = Dialect::parserSettings();
+  static_assert( settings.isValid(), "" );
+  static_assert( Dialect::isCompatibleWith(settings), "" );
+  static_assert( !CommaCsvDialect<true>::isCompatibleWith(settings), "" );
+
+  REQUIRE( CommaCsvDialect<true>::isCompatibleWith( CsvParserSettings() ) );
+  REQUIRE( !CommaCsvDialect<false>::isCompatibleWith( CsvParserSettings() ) );
+}
+
+TEST_CASE("RuntimeCsvDialect")
+{
+  CsvParserSettings settings;
+  settings.setFieldSeparator('|');
+  settings.setFieldProtection('\'');
+  settings.setParseExp(false);
+
+  const RuntimeCsvDialect dialect(settings);
+  REQUIRE( dialect.fieldSeparator() == '|' );
+  REQUIRE( dialect.fieldProtection() == '\'' );
+  REQUIRE( !dialect.parseExp() );
+  REQUIRE( RuntimeCsvDialect::isCompatibleWith(settings) );
+}
+
+TEST_CASE("visitCsvDialect")
+{
+  CsvParserSettings settings;
+
+  SECTION("default")
+  {
+    REQUIRE( visitedDialectName(settings) == "comma" );
+  }
+
+  SECTION("comma no EXP")
+  {
+    settings.setParseExp(false);
+    REQUIRE( visitedDialectName(settings) == "comma no EXP" );
+  }
+
+  SECTION("semicolon")
+  {
+    settings.setFieldSeparator(';');
+    REQUIRE( visitedDialectName(settings) == "semicolon" );
+  }
+
+  SECTION("tab no EXP")
+  {
+    settings.setFieldSeparator('\t');
+    settings.setParseExp(false);
+    REQUIRE( visitedDialectName(settings) == "tab no EXP" );
+  }
+
+  SECTION("pipe")
+  {
+    settings.setFieldSeparator('|');
+    REQUIRE( visitedDialectName(settings) == "runtime" );
+  }
+
+  SECTION("comma, single quote")
+  {
+    settings.setFieldProtection('\'');
+    REQUIRE( visitedDialectName(settings) == "runtime" );
+  }
+}
@@ -166,6 +166,288 @@ TEST_CASE("readAll")
   }
 }
 
+TEST_CASE("position")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+  REQUIRE( writeTextFile(file, QLatin1String("A,B\r\n\"c\nd\",e\nf,g")) );
+  file.close();
+
+  CsvFileReader reader;
+  setFilePathToReader(file, reader);
+  reader.open();
+
+  REQUIRE( reader.position().offset() == 0 );
+  REQUIRE( reader.position().lineNumber() == 1 );
+
+  reader.readLine();
+  REQUIRE( reader.position().offset() == 5 );
+  REQUIRE( reader.position().lineNumber() == 2 );
+  REQUIRE( reader.position().columnNumber() == 1 );
+
+  reader.readLine();
+  REQUIRE( reader.position().offset() == 13 );
+  REQUIRE( reader.position().lineNumber() == 4 );
+  REQUIRE( reader.position().columnNumber() == 1 );
+}
+
+TEST_CASE("readAll_error")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+  REQUIRE( writeTextFile(file, QLatin1String("A,B\nc,d\n\"e\"f,g\nh,i")) );
+  file.close();
+
+  CsvFileReader reader;
+  setFilePathToReader(file, reader);
+  reader.open();
+
+  try{
+    reader.readAll();
+    FAIL("readAll() did not throw");
+  }catch(const CsvFileReadError & error){
+    REQUIRE( error.position().lineNumber() == 3 );
+    REQUIRE( error.position().columnNumber() == 4 );
+    REQUIRE( error.position().offset() == 11 );
+  }
+}
+
+TEST_CASE("validateUtf8")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+
+  CsvFileReader reader;
+  setFilePathToReader(file, reader);
+
+  CsvParserSettings settings;
+  settings.setValidateUtf8(true);
+  reader.setCsvSettings(settings);
+
+  SECTION("valid")
+  {
+    REQUIRE( file.write("A,B\nc,\xc3\xa9\n") > 0 );
+    file.close();
+
+    reader.open();
+    REQUIRE( reader.isOpen() );
+    const auto table = reader.readAll();
+    REQUIRE( table.size() == 2 );
+    REQUIRE( table[1][1] == "\xc3\xa9" );
+  }
+
+  SECTION("invalid")
+  {
+    REQUIRE( file.write("A,B\nc,\xc3\n") > 0 );
+    file.close();
+
+    reader.open();
+    try{
+      reader.readAll();
+      FAIL("readAll() did not throw");
+    }catch(const CsvFileReadError & error){
+      REQUIRE( error.position().lineNumber() == 2 );
+      REQUIRE( error.position().columnNumber() == 3 );
+      REQUIRE( error.position().offset() == 6 );
+    }
+  }
+
+  SECTION("the lines before the invalid sequence are read")
+  {
+    REQUIRE( file.write("A,B\r\nc,d\r\ne\xff,f\r\n") > 0 );
+    file.close();
+
+    reader.open();
+    REQUIRE( reader.readLine() == std::vector<std::string>{"A","B"} );
+    REQUIRE( reader.readLine() == std::vector<std::string>{"c","d"} );
+    REQUIRE( !reader.atEnd() );
+    try{
+      reader.readLine();
+      FAIL("readLine() did not throw");
+    }catch(const CsvFileReadError & error){
+      REQUIRE( error.position().lineNumber() == 3 );
+      REQUIRE( error.position().columnNumber() == 2 );
+      REQUIRE( error.position().offset() == 11 );
+    }
+  }
+
+  SECTION("skipping malformed records")
+  {
+    REQUIRE( file.write("A,B\n\"c\nd,\xc3\n") > 0 );
+    file.close();
+
+    std::vector<CsvMalformedRecord> malformedRecords;
+    reader.open();
+    REQUIRE_THROWS_AS( reader.readAll(malformedRecords), CsvFileReadError );
+  }
+}
+
+TEST_CASE("readAll_limits")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+
+  CsvParserSettings csvSettings;
+  CsvFileReader reader;
+  setFilePathToReader(file, reader);
+
+  SECTION("unterminated protected field")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\n\"c,d\ne,f\ng,h")) );
+    file.close();
+
+    csvSettings.setMaximumFieldLength(4);
+    reader.setCsvSettings(csvSettings);
+    reader.open();
+
+    try{
+      reader.readAll();
+      FAIL("readAll() did not throw");
+    }catch(const CsvFileReadError & error){
+      REQUIRE( error.position().lineNumber() == 2 );
+    }
+  }
+
+  SECTION("maximum record length")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\nc,d\r\nef,g")) );
+    file.close();
+
+    csvSettings.setMaximumRecordLength(3);
+    reader.setCsvSettings(csvSettings);
+    reader.open();
+
+    try{
+      reader.readAll();
+      FAIL("readAll() did not throw");
+    }catch(const CsvFileReadError & error){
+      REQUIRE( error.position().lineNumber() == 3 );
+    }
+  }
+
+  SECTION("maximum column count")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\nc,d,e")) );
+    file.close();
+
+    csvSettings.setMaximumColumnCount(2);
+    reader.setCsvSettings(csvSettings);
+    reader.open();
+
+    REQUIRE( reader.readLine() == std::vector<std::string>{"A","B"} );
+    REQUIRE_THROWS_AS( reader.readLine(), CsvFileReadError );
+  }
+}
+
+TEST_CASE("readAll_skipMalformedRecords")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+
+  std::vector< std::vector<std::string> > table;
+  std::vector<CsvMalformedRecord> malformedRecords;
+
+  CsvFileReader reader;
+  setFilePathToReader(file, reader);
+
+  SECTION("no malformed record")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B,C\nd,e,f")) );
+    file.close();
+
+    reader.open();
+    table = reader.readAll(malformedRecords);
+    REQUIRE( table.size() == 2 );
+    REQUIRE( malformedRecords.empty() );
+    REQUIRE( reader.atEnd() );
+  }
+
+  SECTION("malformed records")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B,C\nd,\"e,f\ng,h,i\n\"j\"k,l\nm,n,o")) );
+    file.close();
+
+    reader.open();
+    table = reader.readAll(malformedRecords);
+    REQUIRE( table.size() == 3 );
+    REQUIRE( table[0][0] == "A" );
+    REQUIRE( table[1][0] == "g" );
+    REQUIRE( table[2][0] == "m" );
+    REQUIRE( malformedRecords.size() == 2 );
+    REQUIRE( malformedRecords[0].lineNumber() == 2 );
+    REQUIRE( malformedRecords[0].byteOffset() == 6 );
+    REQUIRE( malformedRecords[0].rawData() == "d,\"e,f" );
+    REQUIRE( malformedRecords[1].lineNumber() == 4 );
+    REQUIRE( malformedRecords[1].byteOffset() == 19 );
+    REQUIRE( malformedRecords[1].rawData() == "\"j\"k,l" );
+    REQUIRE( reader.atEnd() );
+  }
+}
+
+TEST_CASE("validate")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+
+  CsvFileReader reader;
+  setFilePathToReader(file, reader);
+
+  SECTION("empty")
+  {
+    file.close();
+
+    reader.open();
+    const auto report = reader.validate();
+    REQUIRE( report.isValid() );
+    REQUIRE( report.recordCount() == 0 );
+    REQUIRE( report.columnCount() == 0 );
+  }
+
+  SECTION("2 lines")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B,C\nd,e,f\n")) );
+    file.close();
+
+    reader.open();
+    const auto report = reader.validate();
+    REQUIRE( report.isValid() );
+    REQUIRE( report.recordCount() == 2 );
+    REQUIRE( report.columnCount() == 3 );
+    REQUIRE( reader.atEnd() );
+  }
+
+  SECTION("inconsistent column count")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B,C\nd,e,f\ng,h\ni,j,k")) );
+    file.close();
+
+    reader.open();
+    const auto report = reader.validate();
+    REQUIRE( !report.isValid() );
+    REQUIRE( !report.hasMalformedRecord() );
+    REQUIRE( !report.hasConsistentColumnCount() );
+    REQUIRE( report.firstInconsistentRecordIndex() == 2 );
+    REQUIRE( report.recordCount() == 4 );
+    REQUIRE( report.columnCount() == 3 );
+  }
+
+  SECTION("malformed record")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B,C\nd,\"e,f\ng,h,i")) );
+    file.close();
+
+    reader.open();
+    const auto report = reader.validate();
+    REQUIRE( !report.isValid() );
+    REQUIRE( report.hasMalformedRecord() );
+    REQUIRE( report.firstMalformedRecordIndex() == 1 );
+    REQUIRE( report.firstMalformedRecordPosition().lineNumber() == 2 );
+    REQUIRE( report.firstMalformedRecordPosition().columnNumber() == 1 );
+    REQUIRE( report.firstMalformedRecordPosition().offset() == 6 );
+    REQUIRE( report.recordCount() == 1 );
+  }
+}
+
 TEST_CASE("Test files")
 {
   std::vector< std::vector<std::string> > table;
@@ -21,3 +21,47 @@ TEST_CASE("open")
     REQUIRE( !writer.isOpen() );
   }
 }
+
+TEST_CASE("write")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvFileWriter writer;
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  setFilePathToWriter(filePath, writer);
+  writer.open();
+
+  SECTION("empty record")
+  {
+    REQUIRE_THROWS_AS( writer.writeLine({}), CsvFileWriteError );
+  }
+
+  SECTION("empty table")
+  {
+    REQUIRE_THROWS_AS( writer.writeTable({}), CsvFileWriteError );
+  }
+
+  SECTION("table of empty records")
+  {
+    REQUIRE_THROWS_AS( writer.writeTable({{},{}}), CsvFileWriteError );
+  }
+
+  SECTION("range of empty records")
+  {
+    const std::vector< std::vector<std::string> > table{{},{}};
+    REQUIRE_THROWS_AS( writer.writeLines( table.cbegin(), table.cend() ), CsvFileWriteError );
+  }
+
+  SECTION("large table of empty records, parallel")
+  {
+    writer.close();
+    writer.setThreadCount(2);
+    writer.open();
+    const std::vector< std::vector<std::string> > table(10000);
+    REQUIRE_THROWS_AS( writer.writeTable(table), CsvFileWriteError );
+  }
+
+  writer.close();
+  REQUIRE( readTextFile(filePath).isEmpty() );
+}
@@ -56,6 +56,64 @@ TEST_CASE("openMode")
   }
 }
 
+TEST_CASE("bufferSize")
+{
+  CsvFileWriter writer;
+
+  SECTION("default")
+  {
+    REQUIRE( writer.bufferSize() == BufferedFileSink::defaultBufferSize );
+  }
+
+  SECTION("set and get")
+  {
+    writer.setBufferSize(16);
+    REQUIRE( writer.bufferSize() == 16 );
+  }
+}
+
+TEST_CASE("preallocatedSize")
+{
+  CsvFileWriter writer;
+
+  SECTION("default")
+  {
+    REQUIRE( writer.preallocatedSize() == 0 );
+  }
+
+  SECTION("set and get")
+  {
+    writer.setPreallocatedSize(1024);
+    REQUIRE( writer.preallocatedSize() == 1024 );
+  }
+}
+
+TEST_CASE("threadCount")
+{
+  CsvFileWriter writer;
+  REQUIRE( writer.threadCount() == 1 );
+
+  writer.setThreadCount(4);
+  REQUIRE( writer.threadCount() == 4 );
+}
+
+TEST_CASE("durabilityPolicy")
+{
+  CsvFileWriter writer;
+  REQUIRE( writer.durabilityPolicy().durability() == FileDurability::None );
+  REQUIRE( writer.durabilityPolicy().groupCommitRecordCount() == 0 );
+  REQUIRE( writer.durabilityPolicy().groupCommitInterval() == std::chrono::milliseconds(1000) );
+
+  FileDurabilityPolicy policy;
+  policy.setDurability(FileDurability::GroupCommit);
+  policy.setGroupCommitRecordCount(100);
+  policy.setGroupCommitInterval( std::chrono::milliseconds(10) );
+  writer.setDurabilityPolicy(policy);
+  REQUIRE( writer.durabilityPolicy().durability() == FileDurability::GroupCommit );
+  REQUIRE( writer.durabilityPolicy().groupCommitRecordCount() == 100 );
+  REQUIRE( writer.durabilityPolicy().groupCommitInterval() == std::chrono::milliseconds(10) );
+}
+
 TEST_CASE("open_close")
 {
   QTemporaryDir dir;
@@ -224,3 +282,449 @@ TEST_CASE("writeTable")
     REQUIRE( fileData == QLatin1String("Ab C,\"D,E\"\n79,3456\n") );
   }
 }
+
+TEST_CASE("writeLines")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  CsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  setFilePathToWriter(filePath, writer);
+  writer.open();
+
+  const std::vector< std::vector<std::string> > table{{"A","B"},{},{"c,d","e"},{"1","2"}};
+
+  SECTION("empty range")
+  {
+    writer.writeLines( table.cbegin(), table.cbegin() );
+    writer.close();
+    REQUIRE( readBinaryFile(filePath).empty() );
+  }
+
+  SECTION("whole table")
+  {
+    writer.writeLines( table.cbegin(), table.cend() );
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A,B\n\"c,d\",e\n1,2\n" );
+  }
+
+  SECTION("2 batches")
+  {
+    writer.writeLines( table.cbegin(), table.cbegin() + 2 );
+    writer.writeLines( table.cbegin() + 2, table.cend() );
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A,B\n\"c,d\",e\n1,2\n" );
+  }
+}
+
+TEST_CASE("writeTypedLine")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  CsvFileWriter writer;
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  setFilePathToWriter(filePath, writer);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+
+  SECTION("default")
+  {
+    writer.setCsvSettings(csvSettings);
+    writer.open();
+    writer.writeTypedLine({"A", 25, -3, 1.75, true, "b,c"});
+    writer.writeTypedLine({2.0, false, std::string("d")});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A,25,-3,1.75,true,\"b,c\"\n2.0,false,d\n" );
+  }
+
+  SECTION("precision 2, semicolon separator, comma decimal separator")
+  {
+    csvSettings.setFieldSeparator(';');
+    csvSettings.setDecimalSeparator(',');
+    csvSettings.setRealPrecision(2);
+    writer.setCsvSettings(csvSettings);
+    writer.open();
+    writer.writeTypedLine({1.0/3.0, 12, 2.5});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "0,33;12;2,5\n" );
+  }
+
+  SECTION("comma decimal separator and field separator")
+  {
+    csvSettings.setDecimalSeparator(',');
+    writer.setCsvSettings(csvSettings);
+    writer.open();
+    writer.writeTypedLine({2.5, 12, true});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "\"2,5\",12,true\n" );
+  }
+
+  SECTION("quoting policy Always, EXP")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Always);
+    csvSettings.setAddExp(true);
+    writer.setCsvSettings(csvSettings);
+    writer.open();
+    writer.writeTypedLine({"A", 25, 1.5});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "\"~A\",\"~25\",\"~1.5\"\n" );
+  }
+
+  SECTION("quoting policy per column")
+  {
+    csvSettings.setColumnQuotingPolicy(1, CsvQuotingPolicy::Always);
+    writer.setCsvSettings(csvSettings);
+    writer.open();
+    writer.writeTypedLine({1, 2, 3});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "1,\"2\",3\n" );
+  }
+
+  SECTION("small buffer")
+  {
+    writer.setCsvSettings(csvSettings);
+    writer.setBufferSize(3);
+    writer.open();
+    writer.writeTypedLine({123456789, 0.125, false});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "123456789,0.125,false\n" );
+  }
+}
+
+TEST_CASE("writeTypedTable")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  CsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  setFilePathToWriter(filePath, writer);
+  writer.open();
+
+  writer.writeTypedTable({{"Id","Value"},{1, 0.5},{2, 1e-3}});
+  writer.close();
+  REQUIRE( readBinaryFile(filePath) == "Id,Value\n1,0.5\n2,0.001\n" );
+}
+
+TEST_CASE("writeLine_smallBuffer")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  CsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  writer.setBufferSize(4);
+  writer.setPreallocatedSize(1024);
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  setFilePathToWriter(filePath, writer);
+  writer.open();
+
+  writer.writeLine({"abc","DE, F"});
+  writer.writeLine({"12","3456"});
+  writer.close();
+  REQUIRE( readTextFile(filePath) == QLatin1String("abc,\"DE, F\"\n12,3456\n") );
+}
+
+TEST_CASE("writeTable_SameResultAsKarmaCsvFile")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  const std::vector< std::vector<std::string> > table{
+    {"A"},
+    {"","B"},
+    {"",""},
+    {" a","b ","c d"},
+    {"a,b","a;b","a\"b","\"","\"\""},
+    {"line\nbreak","cr\rlf","tab\there","~"},
+    {"\xc3\xa9t\xc3\xa9","\"\xc3\xa9\""},
+  };
+
+  CsvGeneratorSettings csvSettings;
+
+  SECTION("default")
+  {
+  }
+
+  SECTION("semicolon separator, single quote protection")
+  {
+    csvSettings.setFieldSeparator(';');
+    csvSettings.setFieldProtection('\'');
+  }
+
+  SECTION("add EXP, CR LF")
+  {
+    csvSettings.setAddExp(true);
+    csvSettings.setEndOfLine(EndOfLine::CrLf);
+  }
+
+  SECTION("CR")
+  {
+    csvSettings.setEndOfLine(EndOfLine::Cr);
+  }
+
+  SECTION("quoting policy Always")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Always);
+  }
+
+  SECTION("quoting policy Never, EXP")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Never);
+    csvSettings.setAddExp(true);
+  }
+
+  SECTION("quoting policy per column")
+  {
+    csvSettings.setColumnQuotingPolicy(1, CsvQuotingPolicy::Always);
+    csvSettings.setColumnQuotingPolicy(3, CsvQuotingPolicy::Never);
+  }
+
+  std::string expectedData;
+  std::back_insert_iterator<std::string> it(expectedData);
+  const Grammar::Csv::Karma::CsvFile< std::back_insert_iterator<std::string>, std::vector< std::vector<std::string> > > rule(csvSettings);
+  REQUIRE( boost::spirit::karma::generate(it, rule, table) );
+
+  CsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  setFilePathToWriter(filePath, writer);
+
+  writer.open();
+  writer.writeTable(table);
+  writer.close();
+  REQUIRE( readBinaryFile(filePath) == expectedData );
+
+  writer.open();
+  for(const auto & record : table){
+    writer.writeLine(record);
+  }
+  writer.close();
+  REQUIRE( readBinaryFile(filePath) == expectedData );
+}
+
+TEST_CASE("writeTable_parallel")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  const QString parallelFilePath = filePathFromDirAndFileName(dir, "parallelFile.csv");
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  CsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  setFilePathToWriter(filePath, writer);
+
+  CsvFileWriter parallelWriter;
+  parallelWriter.setCsvSettings(csvSettings);
+  parallelWriter.setOpenMode(FileWriteOpenMode::Truncate);
+  parallelWriter.setThreadCount(3);
+  setFilePathToWriter(parallelFilePath, parallelWriter);
+
+  SECTION("writeTable")
+  {
+    std::vector< std::vector<std::string> > table;
+    for(int row = 0; row < 20000; ++row){
+      if( (row % 1000) == 0 ){
+        table.push_back({});
+      }else{
+        table.push_back({std::to_string(row), "a,b", "c\"d"});
+      }
+    }
+
+    writer.open();
+    writer.writeTable(table);
+    writer.close();
+
+    parallelWriter.open();
+    parallelWriter.writeTable(table);
+    parallelWriter.close();
+
+    const std::string data = readBinaryFile(filePath);
+    REQUIRE( data.size() > 0 );
+    REQUIRE( readBinaryFile(parallelFilePath) == data );
+  }
+
+  SECTION("writeTypedTable")
+  {
+    std::vector< std::vector<CsvValue> > table;
+    for(int row = 0; row < 10000; ++row){
+      table.push_back({row, row / 3.0, "a", (row % 2) == 0});
+    }
+
+    writer.open();
+    writer.writeTypedTable(table);
+    writer.close();
+
+    parallelWriter.open();
+    parallelWriter.writeTypedTable(table);
+    parallelWriter.close();
+
+    const std::string data = readBinaryFile(filePath);
+    REQUIRE( data.size() > 0 );
+    REQUIRE( readBinaryFile(parallelFilePath) == data );
+  }
+}
+
+TEST_CASE("durability")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  FileDurabilityPolicy policy;
+
+  CsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  setFilePathToWriter(filePath, writer);
+
+  SECTION("SyncOnClose")
+  {
+    policy.setDurability(FileDurability::SyncOnClose);
+    writer.setDurabilityPolicy(policy);
+    writer.open();
+    writer.writeLine({"A","B"});
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+    REQUIRE( readBinaryFile(filePath) == "A,B\n" );
+  }
+
+  SECTION("GroupCommit")
+  {
+    policy.setDurability(FileDurability::GroupCommit);
+    policy.setGroupCommitRecordCount(2);
+    policy.setGroupCommitInterval( std::chrono::milliseconds(1) );
+    writer.setDurabilityPolicy(policy);
+
+    std::string expectedData;
+    std::vector< std::vector<std::string> > table;
+    for(int row = 0; row < 100; ++row){
+      table.push_back({std::to_string(row)});
+    }
+
+    writer.open();
+    for(const auto & record : table){
+      writer.writeLine(record);
+      expectedData += record[0] + "\n";
+    }
+    writer.writeTable(table);
+    writer.writeLines( table.cbegin(), table.cend() );
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+    for(const auto & record : table){
+      expectedData += record[0] + "\n";
+    }
+    for(const auto & record : table){
+      expectedData += record[0] + "\n";
+    }
+    REQUIRE( readBinaryFile(filePath) == expectedData );
+  }
+
+  SECTION("AtomicReplace")
+  {
+    REQUIRE( writeTextFile(filePath, QLatin1String("old")) );
+    policy.setDurability(FileDurability::AtomicReplace);
+    writer.setDurabilityPolicy(policy);
+    writer.setOpenMode(FileWriteOpenMode::Append);
+
+    writer.open();
+    writer.writeLine({"A","B"});
+    const QString temporaryFilePath = QString::fromLocal8Bit( writer.temporaryFilePath().c_str() );
+    REQUIRE( !temporaryFilePath.isEmpty() );
+    REQUIRE( temporaryFilePath != filePath );
+    REQUIRE( fileExists(temporaryFilePath) );
+    REQUIRE( readBinaryFile(filePath) == "old" );
+    writer.close();
+    REQUIRE( writer.temporaryFilePath().empty() );
+    REQUIRE( readBinaryFile(filePath) == "A,B\n" );
+    REQUIRE( !fileExists(temporaryFilePath) );
+  }
+
+  SECTION("AtomicReplace does not touch a existing .tmp file")
+  {
+    const QString otherFilePath = filePathFromDirAndFileName(dir, "file.csv.tmp");
+    REQUIRE( writeTextFile(otherFilePath, QLatin1String("other")) );
+    policy.setDurability(FileDurability::AtomicReplace);
+    writer.setDurabilityPolicy(policy);
+    writer.open();
+    writer.writeLine({"A"});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A\n" );
+    REQUIRE( readBinaryFile(otherFilePath) == "other" );
+  }
+
+  SECTION("AtomicReplace with 2 writers")
+  {
+    policy.setDurability(FileDurability::AtomicReplace);
+    writer.setDurabilityPolicy(policy);
+    CsvFileWriter otherWriter;
+    otherWriter.setCsvSettings(csvSettings);
+    otherWriter.setDurabilityPolicy(policy);
+    setFilePathToWriter(filePath, otherWriter);
+
+    writer.open();
+    otherWriter.open();
+    REQUIRE( writer.temporaryFilePath() != otherWriter.temporaryFilePath() );
+    writer.writeLine({"A"});
+    otherWriter.writeLine({"B"});
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A\n" );
+    otherWriter.writeLine({"C"});
+    otherWriter.close();
+    REQUIRE( readBinaryFile(filePath) == "B\nC\n" );
+  }
+
+  SECTION("AtomicReplace new file")
+  {
+    policy.setDurability(FileDurability::AtomicReplace);
+    writer.setDurabilityPolicy(policy);
+    writer.open();
+    writer.writeLine({"A"});
+    REQUIRE( !fileExists(filePath) );
+    writer.close();
+    REQUIRE( readBinaryFile(filePath) == "A\n" );
+  }
+
+  SECTION("AtomicReplace without close")
+  {
+    QString temporaryFilePath;
+    REQUIRE( writeTextFile(filePath, QLatin1String("old")) );
+    policy.setDurability(FileDurability::AtomicReplace);
+    {
+      CsvFileWriter otherWriter;
+      otherWriter.setDurabilityPolicy(policy);
+      setFilePathToWriter(filePath, otherWriter);
+      otherWriter.open();
+      otherWriter.writeLine({"A","B"});
+      temporaryFilePath = QString::fromLocal8Bit( otherWriter.temporaryFilePath().c_str() );
+    }
+    REQUIRE( readBinaryFile(filePath) == "old" );
+    REQUIRE( !fileExists(temporaryFilePath) );
+  }
+}
@@ -6,6 +6,14 @@
  */
 #include "catch2/catch.hpp"
 #include "Mdt/PlainText/CsvFileWriter"
+#include "Mdt/PlainText/BufferedFileSink.h"
+#include "Mdt/PlainText/Grammar/Csv/Karma/CsvFile.h"
+#include <boost/spirit/include/karma.hpp>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
 #include "Mdt/PlainText/TestLib/TextFileUtils.h"
 #include <QTemporaryDir>
 #include <QDir>
@@ -50,3 +58,16 @@ QString readTextFile(const QString & filePath)
 {
   return Mdt::PlainText::TestLib::readTextFileUtf8(filePath);
 }
+
+/*
+ * Unlike readTextFile(), end of lines are not converted
+ */
+std::string readBinaryFile(const QString & filePath)
+{
+  std::ifstream file(filePath.toLocal8Bit().toStdString(), std::ios_base::in | std::ios_base::binary);
+  std::ostringstream data;
+
+  data << file.rdbuf();
+
+  return data.str();
+}
@@ -16,6 +16,11 @@ TEST_CASE("default")
   REQUIRE( settings.fieldProtection() == '"' );
   REQUIRE( !settings.addExp() );
   REQUIRE( settings.endOfLine() == EndOfLine::Native );
+  REQUIRE( settings.quotingPolicy() == CsvQuotingPolicy::Minimal );
+  REQUIRE( settings.columnQuotingPolicyCount() == 0 );
+  REQUIRE( settings.columnQuotingPolicy(0) == CsvQuotingPolicy::Minimal );
+  REQUIRE( settings.realPrecision() == 6 );
+  REQUIRE( settings.decimalSeparator() == '.' );
 }
 
 TEST_CASE("set_get")
@@ -33,6 +38,74 @@ TEST_CASE("set_get")
 
   settings.setEndOfLine(EndOfLine::Lf);
   REQUIRE( settings.endOfLine() == EndOfLine::Lf );
+
+  settings.setQuotingPolicy(CsvQuotingPolicy::Always);
+  REQUIRE( settings.quotingPolicy() == CsvQuotingPolicy::Always );
+
+  settings.setRealPrecision(2);
+  REQUIRE( settings.realPrecision() == 2 );
+
+  settings.setDecimalSeparator(',');
+  REQUIRE( settings.decimalSeparator() == ',' );
+}
+
+TEST_CASE("columnQuotingPolicy")
+{
+  CsvGeneratorSettings settings;
+  settings.setQuotingPolicy(CsvQuotingPolicy::Always);
+
+  settings.setColumnQuotingPolicy(2, CsvQuotingPolicy::Never);
+  REQUIRE( settings.columnQuotingPolicyCount() == 3 );
+  REQUIRE( settings.columnQuotingPolicy(0) == CsvQuotingPolicy::Always );
+  REQUIRE( settings.columnQuotingPolicy(1) == CsvQuotingPolicy::Always );
+  REQUIRE( settings.columnQuotingPolicy(2) == CsvQuotingPolicy::Never );
+  REQUIRE( settings.columnQuotingPolicy(3) == CsvQuotingPolicy::Always );
+
+  settings.setColumnQuotingPolicy(0, CsvQuotingPolicy::Minimal);
+  REQUIRE( settings.columnQuotingPolicyCount() == 3 );
+  REQUIRE( settings.columnQuotingPolicy(0) == CsvQuotingPolicy::Minimal );
+  REQUIRE( settings.columnQuotingPolicy(1) == CsvQuotingPolicy::Always );
+
+  settings.setQuotingPolicy(CsvQuotingPolicy::Never);
+  REQUIRE( settings.columnQuotingPolicy(1) == CsvQuotingPolicy::Never );
+  REQUIRE( settings.columnQuotingPolicy(2) == CsvQuotingPolicy::Never );
+
+  const CsvGeneratorSettings copy = settings;
+  REQUIRE( copy.columnQuotingPolicy(0) == CsvQuotingPolicy::Minimal );
+
+  settings.clearColumnQuotingPolicies();
+  REQUIRE( settings.columnQuotingPolicyCount() == 0 );
+  REQUIRE( settings.columnQuotingPolicy(0) == CsvQuotingPolicy::Never );
+
+  settings.setColumnQuotingPolicy(1, CsvQuotingPolicy::Always);
+  REQUIRE( settings.columnQuotingPolicyCount() == 2 );
+  REQUIRE( settings.columnQuotingPolicy(0) == CsvQuotingPolicy::Never );
+  REQUIRE( settings.columnQuotingPolicy(1) == CsvQuotingPolicy::Always );
+
+  const int lastColumn = CsvGeneratorSettings::maximumColumnQuotingPolicyCount - 1;
+  settings.setColumnQuotingPolicy(lastColumn, CsvQuotingPolicy::Minimal);
+  REQUIRE( settings.columnQuotingPolicyCount() == CsvGeneratorSettings::maximumColumnQuotingPolicyCount );
+  REQUIRE( settings.columnQuotingPolicy(lastColumn - 1) == CsvQuotingPolicy::Never );
+  REQUIRE( settings.columnQuotingPolicy(lastColumn) == CsvQuotingPolicy::Minimal );
+}
+
+constexpr CsvGeneratorSettings numericFirstColumnSettings() noexcept
+{
+  CsvGeneratorSettings settings;
+  settings.setFieldSeparator(';');
+  settings.setColumnQuotingPolicy(0, CsvQuotingPolicy::Never);
+
+  return settings;
+}
+
+TEST_CASE("constexpr")
+{
+  constexpr CsvGeneratorSettings settings = numericFirstColumnSettings();
+
+  static_assert( settings.fieldSeparator() == ';', "" );
+  static_assert( settings.columnQuotingPolicy(0) == CsvQuotingPolicy::Never, "" );
+  static_assert( settings.columnQuotingPolicy(1) == CsvQuotingPolicy::Minimal, "" );
+  static_assert( settings.isValid(), "" );
 }
 
 TEST_CASE("isEndOfLine")
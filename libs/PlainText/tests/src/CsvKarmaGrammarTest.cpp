@@ -28,6 +28,41 @@ TEST_CASE("SafeChar")
   }
 }
 
+TEST_CASE("ValidateStringForUnprotectedField")
+{
+  using Grammar::Csv::Karma::ValidateStringForUnprotectedField;
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setFieldSeparator(';');
+  csvSettings.setFieldProtection('\'');
+  const ValidateStringForUnprotectedField validate(csvSettings);
+
+  SECTION("std::string")
+  {
+    REQUIRE( validate(std::string()) );
+    REQUIRE( validate(std::string("A")) );
+    REQUIRE( validate(std::string("A,B")) );
+    REQUIRE( validate(std::string("A\"B")) );
+    REQUIRE( validate(std::string("A B")) );
+    REQUIRE( validate(std::string("\xc3\xa9")) );
+    REQUIRE( !validate(std::string(" ")) );
+    REQUIRE( !validate(std::string(" A")) );
+    REQUIRE( !validate(std::string("A ")) );
+    REQUIRE( !validate(std::string("A;B")) );
+    REQUIRE( !validate(std::string("A'B")) );
+    REQUIRE( !validate(std::string("A\nB")) );
+    REQUIRE( !validate(std::string("A\rB")) );
+    REQUIRE( !validate(std::string("A\tB")) );
+  }
+
+  SECTION("std::u32string")
+  {
+    REQUIRE( validate(std::u32string(U"A\u00e9\u2028B")) );
+    REQUIRE( !validate(std::u32string(U"A;B")) );
+    REQUIRE( !validate(std::u32string(U" A")) );
+  }
+}
+
 TEST_CASE("UnprotectedField")
 {
   std::string result;
@@ -418,6 +453,29 @@ TEST_CASE("FieldColumn")
   }
 }
 
+TEST_CASE("FieldColumn_SameResultAsUnprotectedOrProtectedField")
+{
+  using Rule = boost::spirit::karma::rule<std::back_insert_iterator<std::string>, std::string()>;
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setFieldSeparator( GENERATE(',', ';') );
+  csvSettings.setFieldProtection( GENERATE('"', '\'') );
+  csvSettings.setAddExp( GENERATE(false, true) );
+
+  const std::string data = GENERATE( as<std::string>(),
+    "", "A", "AB", "A B", " ", " A", "A ", ",", ";", "\"", "'", "A\"\"B", "A''B", "A\nB", "A\r\nB", "A\tB", "~", "\xc3\xa9"
+  );
+
+  const UnprotectedField unprotectedField(csvSettings);
+  const ProtectedField protectedField(csvSettings);
+  const Rule alternative = unprotectedField | protectedField;
+
+  std::string expected;
+  REQUIRE( boost::spirit::karma::generate(std::back_inserter(expected), alternative, data) );
+
+  REQUIRE( generateFieldColumn(data, csvSettings) == expected );
+}
+
 TEST_CASE("CsvRecord")
 {
   std::string result;
@@ -508,6 +566,61 @@ TEST_CASE("CsvRecord")
   }
 }
 
+TEST_CASE("CsvRecord_QuotingPolicy")
+{
+  std::string result;
+  const StringRecord record{"12","a b","c,d","e\"f"};
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  SECTION("Minimal")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Minimal);
+    result = generateCsvRecord(record, csvSettings);
+    REQUIRE( result == "12,a b,\"c,d\",\"e\"\"f\"\n" );
+  }
+
+  SECTION("Always")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Always);
+    result = generateCsvRecord(record, csvSettings);
+    REQUIRE( result == "\"12\",\"a b\",\"c,d\",\"e\"\"f\"\n" );
+  }
+
+  SECTION("Always, EXP")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Always);
+    csvSettings.setAddExp(true);
+    result = generateCsvRecord({"12"}, csvSettings);
+    REQUIRE( result == "\"~12\"\n" );
+  }
+
+  SECTION("Never")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Never);
+    result = generateCsvRecord(record, csvSettings);
+    REQUIRE( result == "12,a b,c,d,e\"f\n" );
+  }
+
+  SECTION("Per column")
+  {
+    csvSettings.setColumnQuotingPolicy(0, CsvQuotingPolicy::Never);
+    csvSettings.setColumnQuotingPolicy(1, CsvQuotingPolicy::Always);
+    result = generateCsvRecord(record, csvSettings);
+    REQUIRE( result == "12,\"a b\",\"c,d\",\"e\"\"f\"\n" );
+  }
+
+  SECTION("Per column, Always by default")
+  {
+    csvSettings.setQuotingPolicy(CsvQuotingPolicy::Always);
+    csvSettings.setColumnQuotingPolicy(2, CsvQuotingPolicy::Minimal);
+    result = generateCsvRecord(record, csvSettings);
+    REQUIRE( result == "\"12\",\"a b\",\"c,d\",\"e\"\"f\"\n" );
+    result = generateCsvRecord({"1","2","3"}, csvSettings);
+    REQUIRE( result == "\"1\",\"2\",3\n" );
+  }
+}
+
 TEST_CASE("CsvFile")
 {
   std::string result;
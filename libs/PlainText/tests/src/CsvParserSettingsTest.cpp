@@ -15,6 +15,10 @@ TEST_CASE("default")
   REQUIRE( settings.fieldSeparator() == ',' );
   REQUIRE( settings.fieldProtection() == '"' );
   REQUIRE( settings.parseExp() );
+  REQUIRE( settings.maximumFieldLength() == 0 );
+  REQUIRE( settings.maximumRecordLength() == 0 );
+  REQUIRE( settings.maximumColumnCount() == 0 );
+  REQUIRE( !settings.validateUtf8() );
 }
 
 TEST_CASE("set_get")
@@ -29,6 +33,18 @@ TEST_CASE("set_get")
 
   settings.setParseExp(false);
   REQUIRE( !settings.parseExp() );
+
+  settings.setMaximumFieldLength(100);
+  REQUIRE( settings.maximumFieldLength() == 100 );
+
+  settings.setMaximumRecordLength(1000);
+  REQUIRE( settings.maximumRecordLength() == 1000 );
+
+  settings.setMaximumColumnCount(10);
+  REQUIRE( settings.maximumColumnCount() == 10 );
+
+  settings.setValidateUtf8(true);
+  REQUIRE( settings.validateUtf8() );
 }
 
 TEST_CASE("isEndOfLine")
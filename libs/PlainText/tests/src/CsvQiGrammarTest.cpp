@@ -621,6 +621,146 @@ TEST_CASE("CsvRecord")
     record = parseCsvRecord("A B,C", csvSettings);
     REQUIRE( record == StringRecord{"A B", "C"} );
   }
+
+  SECTION("\"\"")
+  {
+    record = parseCsvRecord("\"\"", csvSettings);
+    REQUIRE( record == StringRecord{""} );
+  }
+
+  SECTION(",")
+  {
+    record = parseCsvRecord(",", csvSettings);
+    REQUIRE( record == StringRecord{"", ""} );
+  }
+
+  SECTION(",,C")
+  {
+    record = parseCsvRecord(",,C", csvSettings);
+    REQUIRE( record == StringRecord{"", "", "C"} );
+  }
+
+  SECTION("~")
+  {
+    REQUIRE( parseCsvRecordFails("~", csvSettings) );
+  }
+
+  SECTION("~,B")
+  {
+    record = parseCsvRecord("~,B", csvSettings);
+    REQUIRE( record == StringRecord{"", "B"} );
+  }
+
+  SECTION("~A,B")
+  {
+    record = parseCsvRecord("~A,B", csvSettings);
+    REQUIRE( record == StringRecord{"A", "B"} );
+  }
+
+  SECTION("~,B (no EXP)")
+  {
+    csvSettings.setParseExp(false);
+    record = parseCsvRecord("~,B", csvSettings);
+    REQUIRE( record == StringRecord{"~", "B"} );
+  }
+}
+
+TEST_CASE("CsvRecord_FieldCount")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("A")
+  {
+    REQUIRE( parseCsvRecordFieldCount("A", csvSettings) == 1 );
+  }
+
+  SECTION("A,")
+  {
+    REQUIRE( parseCsvRecordFieldCount("A,", csvSettings) == 2 );
+  }
+
+  SECTION(",B")
+  {
+    REQUIRE( parseCsvRecordFieldCount(",B", csvSettings) == 2 );
+  }
+
+  SECTION("A,BC,D,EFG\\n")
+  {
+    REQUIRE( parseCsvRecordFieldCount("A,BC,D,EFG\n", csvSettings) == 4 );
+  }
+
+  SECTION("\"A,B\",CD")
+  {
+    REQUIRE( parseCsvRecordFieldCount("\"A,B\",CD", csvSettings) == 2 );
+  }
+}
+
+TEST_CASE("MaximumFieldLength")
+{
+  CsvParserSettings csvSettings;
+  csvSettings.setMaximumFieldLength(3);
+
+  SECTION("UnprotectedField")
+  {
+    REQUIRE( parseUnprotectedField("ABC", csvSettings) == "ABC" );
+    REQUIRE( parseUnprotectedField("ABCD", csvSettings) == "ABC" );
+    REQUIRE( parseUnprotectedField("~ABC", csvSettings) == "ABC" );
+  }
+
+  SECTION("NonEmptyUnprotectedField")
+  {
+    REQUIRE( parseNonEmptyUnprotectedField("ABC", csvSettings) == "ABC" );
+    REQUIRE( parseNonEmptyUnprotectedField("ABCD", csvSettings) == "ABC" );
+  }
+
+  SECTION("ProtectedField")
+  {
+    REQUIRE( parseProtectedField("\"ABC\"", csvSettings) == "ABC" );
+    REQUIRE( parseProtectedField("\"A\"\"B\"", csvSettings) == "A\"B" );
+    REQUIRE( parseProtectedFieldFails("\"ABCD\"", csvSettings) );
+    REQUIRE( parseProtectedFieldFails("\"ABCDEFGH", csvSettings) );
+  }
+
+  SECTION("CsvRecord")
+  {
+    REQUIRE( parseCsvRecord("ABC,\"DEF\"", csvSettings) == StringRecord{"ABC","DEF"} );
+  }
+}
+
+TEST_CASE("MaximumColumnCount")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("1")
+  {
+    csvSettings.setMaximumColumnCount(1);
+    REQUIRE( parseCsvRecord("A", csvSettings) == StringRecord{"A"} );
+    REQUIRE( parseCsvRecord("A,B", csvSettings) == StringRecord{"A"} );
+  }
+
+  SECTION("2")
+  {
+    csvSettings.setMaximumColumnCount(2);
+    REQUIRE( parseCsvRecord("A", csvSettings) == StringRecord{"A"} );
+    REQUIRE( parseCsvRecord("A,B", csvSettings) == StringRecord{"A","B"} );
+    REQUIRE( parseCsvRecord("A,B,C", csvSettings) == StringRecord{"A","B"} );
+  }
+
+  SECTION("3")
+  {
+    csvSettings.setMaximumColumnCount(3);
+    REQUIRE( parseCsvRecord("A,B", csvSettings) == StringRecord{"A","B"} );
+    REQUIRE( parseCsvRecord("A,B,C", csvSettings) == StringRecord{"A","B","C"} );
+    REQUIRE( parseCsvRecord(",,", csvSettings) == StringRecord{"","",""} );
+    REQUIRE( parseCsvRecord("A,B,C,D", csvSettings) == StringRecord{"A","B","C"} );
+  }
+
+  SECTION("3 field count")
+  {
+    csvSettings.setMaximumColumnCount(3);
+    REQUIRE( parseCsvRecordFieldCount("A,B,C", csvSettings) == 3 );
+    REQUIRE( parseCsvRecordFieldCount("A,B,C,D", csvSettings) == 3 );
+  }
 }
 
 TEST_CASE("CsvFileLine")
@@ -692,3 +832,85 @@ TEST_CASE("CsvFile")
     REQUIRE( table == StringTable{{"A"},{"B"}} );
   }
 }
+
+TEST_CASE("CsvFile_MultiPass")
+{
+  CsvParserSettings csvSettings;
+
+  const std::string source = "A,B\n\"c\nd\",e\r\n\"f,g\"\nABC\nh,\"i\"\"j\"\n";
+  const StringTable expectedTable = {{"A","B"},{"c\nd","e"},{"f,g"},{"ABC"},{"h","i\"j"}};
+
+  SECTION("multi_pass")
+  {
+    REQUIRE( parseCsvFileMultiPass(source, csvSettings) == expectedTable );
+  }
+
+  SECTION("PositionTrackingIterator<multi_pass>")
+  {
+    REQUIRE( parseCsvFilePositionTrackingMultiPass(source, csvSettings) == expectedTable );
+  }
+
+  SECTION("malformed record after a flushed record")
+  {
+    const auto result = parseCsvFilePrefixPositionTrackingMultiPass("A,B\nc,d\n\"e,f\ng,h\n", csvSettings);
+    REQUIRE( result.table == StringTable{{"A","B"},{"c","d"}} );
+    REQUIRE( result.stopOffset == 8 );
+    REQUIRE( result.remainingInput == "\"e,f\ng,h\n" );
+  }
+
+  SECTION("malformed second record")
+  {
+    const auto result = parseCsvFilePrefixPositionTrackingMultiPass("A,B\n\"c,d\ne,f\n", csvSettings);
+    REQUIRE( result.table == StringTable{{"A","B"}} );
+    REQUIRE( result.stopOffset == 4 );
+    REQUIRE( result.remainingInput == "\"c,d\ne,f\n" );
+  }
+}
+
+TEST_CASE("CharClassParser_SameResultAsUnicodeCharSets")
+{
+  using Utf32Iterator = std::u32string::const_iterator;
+  using Utf32Char = Grammar::Csv::Qi::Char<Utf32Iterator, uint32_t>;
+  using Utf32SafeChar = Grammar::Csv::Qi::SafeChar<Utf32Iterator, uint32_t>;
+  using Utf32ProtectedField = Grammar::Csv::Qi::ProtectedField<Utf32Iterator, std::u32string>;
+  using Char = Grammar::Csv::Qi::Char<std::string::const_iterator, uint32_t>;
+
+  CsvParserSettings csvSettings;
+  csvSettings.setFieldSeparator( GENERATE(',', ';', '\t') );
+  csvSettings.setFieldProtection( GENERATE('"', '\'') );
+
+  const SafeChar safeChar(csvSettings);
+  const Char charRule(csvSettings);
+  const ProtectedField protectedField(csvSettings);
+  const Utf32SafeChar utf32SafeChar(csvSettings);
+  const Utf32Char utf32CharRule(csvSettings);
+  const Utf32ProtectedField utf32ProtectedField(csvSettings);
+
+  const char fieldQuote = csvSettings.fieldProtection();
+
+  for(int i = 0; i < 128; ++i){
+    const char c = static_cast<char>(i);
+    const std::string source(1, c);
+    const std::u32string utf32Source(1, static_cast<char32_t>(c));
+    const std::string protectedSource = std::string(1, fieldQuote) + c + fieldQuote;
+    const std::u32string utf32ProtectedSource = std::u32string(1, fieldQuote) + static_cast<char32_t>(c) + static_cast<char32_t>(fieldQuote);
+
+    uint32_t result = 0;
+    uint32_t utf32Result = 0;
+    REQUIRE( boost::spirit::qi::parse(source.cbegin(), source.cend(), safeChar, result)
+             == boost::spirit::qi::parse(utf32Source.cbegin(), utf32Source.cend(), utf32SafeChar, utf32Result) );
+    REQUIRE( result == utf32Result );
+
+    result = 0;
+    utf32Result = 0;
+    REQUIRE( boost::spirit::qi::parse(source.cbegin(), source.cend(), charRule, result)
+             == boost::spirit::qi::parse(utf32Source.cbegin(), utf32Source.cend(), utf32CharRule, utf32Result) );
+    REQUIRE( result == utf32Result );
+
+    std::string field;
+    std::u32string utf32Field;
+    REQUIRE( boost::spirit::qi::parse(protectedSource.cbegin(), protectedSource.cend(), protectedField, field)
+             == boost::spirit::qi::parse(utf32ProtectedSource.cbegin(), utf32ProtectedSource.cend(), utf32ProtectedField, utf32Field) );
+    REQUIRE( std::u32string(field.cbegin(), field.cend()) == utf32Field );
+  }
+}
@@ -14,13 +14,19 @@
 #include "Mdt/PlainText/Grammar/Csv/Qi/CsvRecord.h"
 #include "Mdt/PlainText/Grammar/Csv/Qi/CsvFileLine.h"
 #include "Mdt/PlainText/Grammar/Csv/Qi/CsvFile.h"
+#include "Mdt/PlainText/Impl/CsvFieldCountRecord.h"
 #include "Mdt/PlainText/CsvParserSettings"
+#include "Mdt/PlainText/PositionTrackingIterator.h"
+#include <boost/spirit/include/support_multi_pass.hpp>
+#include <sstream>
+#include <iterator>
 #include <boost/spirit/include/qi.hpp>
 #include <string>
 #include <utility>
 #include <vector>
 #include <stdexcept>
 #include <cassert>
+#include <cstdint>
 
 using namespace Mdt::PlainText;
 
@@ -34,6 +40,7 @@ using ProtectedField = Grammar::Csv::Qi::ProtectedField<std::string::const_itera
 using FieldColumn = Grammar::Csv::Qi::FieldColumn<std::string::const_iterator, std::string>;
 using NonEmptyFieldColumn = Grammar::Csv::Qi::NonEmptyFieldColumn<std::string::const_iterator, std::string>;
 using CsvRecord = Grammar::Csv::Qi::CsvRecord<std::string::const_iterator, StringRecord>;
+using CsvFieldCountRecord = Grammar::Csv::Qi::CsvRecord<std::string::const_iterator, Impl::CsvFieldCountRecord>;
 using CsvFileLine = Grammar::Csv::Qi::CsvFileLine<std::string::const_iterator, StringRecord>;
 using CsvFile = Grammar::Csv::Qi::CsvFile<std::string::const_iterator, StringTable>;
 
@@ -192,6 +199,22 @@ StringRecord parseCsvRecord(const std::string & sourceString, const CsvParserSet
   return parseToStringRecordRule<CsvRecord>(sourceString, settings);
 }
 
+int parseCsvRecordFieldCount(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  assert( settings.isValid() );
+
+  Impl::CsvFieldCountRecord record;
+  CsvFieldCountRecord rule(settings);
+
+  const bool ok = boost::spirit::qi::parse(sourceString.cbegin(), sourceString.cend(), rule, record);
+  if(!ok){
+    const std::string what = "Rule '" + rule.name() + "' failed to parse '" + sourceString + "'";
+    throw std::runtime_error(what);
+  }
+
+  return record.size();
+}
+
 bool parseCsvFileLineStringFails(const std::string & sourceString, const CsvParserSettings & settings)
 {
   assert( settings.isValid() );
@@ -226,3 +249,74 @@ StringTable parseCsvFileString(const std::string & sourceString, const CsvParser
 
   return table;
 }
+
+template<typename SourceIterator>
+StringTable parseCsvFileStream(std::istream & stream, const CsvParserSettings & settings)
+{
+  StringTable table;
+  Mdt::PlainText::Grammar::Csv::Qi::CsvFile<SourceIterator, StringTable> rule(settings);
+
+  SourceIterator first( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>(stream) ) );
+  const SourceIterator last( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>() ) );
+
+  const bool ok = boost::spirit::qi::parse(first, last, rule, table);
+  if( !ok || (first != last) ){
+    throw std::runtime_error("Failed to parse table from stream");
+  }
+
+  return table;
+}
+
+StringTable parseCsvFileMultiPass(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  using SourceIterator = boost::spirit::multi_pass< std::istreambuf_iterator<char> >;
+
+  std::istringstream stream(sourceString);
+
+  return parseCsvFileStream<SourceIterator>(stream, settings);
+}
+
+StringTable parseCsvFilePositionTrackingMultiPass(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  using SourceIterator = PositionTrackingIterator< boost::spirit::multi_pass< std::istreambuf_iterator<char> > >;
+
+  std::istringstream stream(sourceString);
+
+  return parseCsvFileStream<SourceIterator>(stream, settings);
+}
+
+/*
+ * Result of parsing a source up to the first record that can not be parsed
+ */
+struct CsvFilePrefixParseResult
+{
+  StringTable table;
+  int64_t stopOffset = -1;
+  std::string remainingInput;
+};
+
+/*
+ * Parse the source with CsvFile through a PositionTrackingIterator<multi_pass>,
+ * which stops before the first record that can not be parsed.
+ * The remaining input is then read back from the iterator at which the parsing stopped,
+ * so it is only correct if no released input was used.
+ */
+CsvFilePrefixParseResult parseCsvFilePrefixPositionTrackingMultiPass(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  using SourceIterator = PositionTrackingIterator< boost::spirit::multi_pass< std::istreambuf_iterator<char> > >;
+
+  CsvFilePrefixParseResult result;
+  Mdt::PlainText::Grammar::Csv::Qi::CsvFile<SourceIterator, StringTable> rule(settings);
+
+  std::istringstream stream(sourceString);
+  SourceIterator first( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>(stream) ) );
+  const SourceIterator last( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>() ) );
+
+  if( !boost::spirit::qi::parse(first, last, rule, result.table) ){
+    throw std::runtime_error("Failed to parse the first record from stream");
+  }
+  result.stopOffset = first.position().offset();
+  result.remainingInput.assign(first, last);
+
+  return result;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/CsvRawField"
+#include <string>
+
+using namespace Mdt::PlainText;
+
+using RawField = CsvRawField<std::string::const_iterator>;
+
+TEST_CASE("Construct")
+{
+  SECTION("Default")
+  {
+    const RawField field;
+    REQUIRE( field.isEmpty() );
+    REQUIRE( !field.needsUnescape() );
+    REQUIRE( field.toString().empty() );
+  }
+
+  SECTION("Slice")
+  {
+    const std::string source = "A,BC";
+    const RawField field(source.cbegin() + 2, source.cend(), '"', false);
+    REQUIRE( !field.isEmpty() );
+    REQUIRE( field.begin() == source.cbegin() + 2 );
+    REQUIRE( field.end() == source.cend() );
+    REQUIRE( field.toString() == "BC" );
+  }
+}
+
+TEST_CASE("Unescape")
+{
+  SECTION("A\"\"B")
+  {
+    const std::string source = "A\"\"B";
+    const RawField field(source.cbegin(), source.cend(), '"', true);
+    REQUIRE( field.needsUnescape() );
+    REQUIRE( field.toString() == "A\"B" );
+  }
+
+  SECTION("''''")
+  {
+    const std::string source = "''''";
+    const RawField field(source.cbegin(), source.cend(), '\'', true);
+    REQUIRE( field.toString() == "''" );
+  }
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/CsvValue"
+#include "Mdt/PlainText/Impl/CsvValueFormatter.h"
+#include "Mdt/PlainText/CsvGeneratorSettings.h"
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+
+using namespace Mdt::PlainText;
+using Impl::CsvValueFormatter;
+
+std::string formatInteger(int64_t value, const CsvGeneratorSettings & settings = CsvGeneratorSettings())
+{
+  std::string str;
+  auto it = std::back_inserter(str);
+  const CsvValueFormatter formatter(settings);
+
+  REQUIRE( formatter.generateInteger(it, value) );
+
+  return str;
+}
+
+std::string formatUnsignedInteger(uint64_t value)
+{
+  std::string str;
+  auto it = std::back_inserter(str);
+  const CsvValueFormatter formatter{CsvGeneratorSettings()};
+
+  REQUIRE( formatter.generateUnsignedInteger(it, value) );
+
+  return str;
+}
+
+std::string formatReal(double value, const CsvGeneratorSettings & settings = CsvGeneratorSettings())
+{
+  std::string str;
+  auto it = std::back_inserter(str);
+  const CsvValueFormatter formatter(settings);
+
+  REQUIRE( formatter.generateReal(it, value) );
+
+  return str;
+}
+
+TEST_CASE("Construct")
+{
+  SECTION("Default")
+  {
+    const CsvValue value;
+    REQUIRE( value.type() == CsvValueType::String );
+    REQUIRE( value.toString().empty() );
+  }
+
+  SECTION("int")
+  {
+    const CsvValue value(-25);
+    REQUIRE( value.type() == CsvValueType::Integer );
+    REQUIRE( value.toInteger() == -25 );
+  }
+
+  SECTION("long long")
+  {
+    const CsvValue value( std::numeric_limits<long long>::min() );
+    REQUIRE( value.type() == CsvValueType::Integer );
+    REQUIRE( value.toInteger() == std::numeric_limits<int64_t>::min() );
+  }
+
+  SECTION("unsigned long long")
+  {
+    const CsvValue value( std::numeric_limits<unsigned long long>::max() );
+    REQUIRE( value.type() == CsvValueType::UnsignedInteger );
+    REQUIRE( value.toUnsignedInteger() == std::numeric_limits<uint64_t>::max() );
+  }
+
+  SECTION("double")
+  {
+    const CsvValue value(1.5);
+    REQUIRE( value.type() == CsvValueType::Real );
+    REQUIRE( value.toReal() == 1.5 );
+  }
+
+  SECTION("float")
+  {
+    const CsvValue value(0.5f);
+    REQUIRE( value.type() == CsvValueType::Real );
+    REQUIRE( value.toReal() == 0.5 );
+  }
+
+  SECTION("bool")
+  {
+    const CsvValue value(true);
+    REQUIRE( value.type() == CsvValueType::Boolean );
+    REQUIRE( value.toBoolean() );
+  }
+
+  SECTION("string literal")
+  {
+    const CsvValue value("abc");
+    REQUIRE( value.type() == CsvValueType::String );
+    REQUIRE( value.toString() == "abc" );
+  }
+
+  SECTION("std::string")
+  {
+    const CsvValue value( std::string("abc") );
+    REQUIRE( value.type() == CsvValueType::String );
+    REQUIRE( value.toString() == "abc" );
+  }
+
+  SECTION("record")
+  {
+    const CsvValueRecord record = {"A", 1, 2.5, false};
+    REQUIRE( record.size() == 4 );
+    REQUIRE( record[0].type() == CsvValueType::String );
+    REQUIRE( record[1].type() == CsvValueType::Integer );
+    REQUIRE( record[2].type() == CsvValueType::Real );
+    REQUIRE( record[3].type() == CsvValueType::Boolean );
+  }
+}
+
+TEST_CASE("formatInteger")
+{
+  REQUIRE( formatInteger(0) == "0" );
+  REQUIRE( formatInteger(123) == "123" );
+  REQUIRE( formatInteger(-45) == "-45" );
+  REQUIRE( formatInteger( std::numeric_limits<int64_t>::max() ) == "9223372036854775807" );
+  REQUIRE( formatInteger( std::numeric_limits<int64_t>::min() ) == "-9223372036854775808" );
+  REQUIRE( formatUnsignedInteger( std::numeric_limits<uint64_t>::max() ) == "18446744073709551615" );
+}
+
+TEST_CASE("formatReal")
+{
+  CsvGeneratorSettings settings;
+
+  SECTION("Default")
+  {
+    REQUIRE( formatReal(0.0) == "0.0" );
+    REQUIRE( formatReal(3.0) == "3.0" );
+    REQUIRE( formatReal(2.5) == "2.5" );
+    REQUIRE( formatReal(-1.125) == "-1.125" );
+    REQUIRE( formatReal(1.0/3.0) == "0.333333" );
+    REQUIRE( formatReal(0.1+0.2) == "0.3" );
+    REQUIRE( formatReal(123456789.5) == "123456789.5" );
+    REQUIRE( formatReal(1e20) == "1.0e20" );
+    REQUIRE( formatReal( std::numeric_limits<double>::quiet_NaN() ) == "nan" );
+    REQUIRE( formatReal( std::numeric_limits<double>::infinity() ) == "inf" );
+  }
+
+  SECTION("precision 2")
+  {
+    settings.setRealPrecision(2);
+    REQUIRE( formatReal(2.5, settings) == "2.5" );
+    REQUIRE( formatReal(1.0/3.0, settings) == "0.33" );
+    REQUIRE( formatReal(2.999, settings) == "3.0" );
+  }
+
+  SECTION("precision 0")
+  {
+    settings.setRealPrecision(0);
+    REQUIRE( formatReal(3.0, settings) == "3" );
+    REQUIRE( formatReal(-1.125, settings) == "-1" );
+    REQUIRE( formatReal(1e20, settings) == "1e20" );
+  }
+
+  SECTION("decimal separator ,")
+  {
+    settings.setDecimalSeparator(',');
+    REQUIRE( formatReal(2.5, settings) == "2,5" );
+    REQUIRE( formatReal(1e20, settings) == "1,0e20" );
+  }
+}
+
+TEST_CASE("booleanText")
+{
+  REQUIRE( std::string( CsvValueFormatter::booleanText(true) ) == "true" );
+  REQUIRE( std::string( CsvValueFormatter::booleanText(false) ) == "false" );
+}
@@ -0,0 +1,513 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "CsvX3GrammarTestCommon.h"
+#include "Mdt/PlainText/Grammar/Csv/Qi/CsvFile.h"
+#include <boost/spirit/include/qi.hpp>
+
+TEST_CASE("SafeChar")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("A")
+  {
+    REQUIRE( parseAll<SafeChar>("A", csvSettings) == 'A' );
+  }
+
+  SECTION(",")
+  {
+    REQUIRE( parseFails<SafeChar>(",", csvSettings) );
+  }
+
+  SECTION("space")
+  {
+    REQUIRE( parseFails<SafeChar>(" ", csvSettings) );
+  }
+
+  SECTION("\"")
+  {
+    REQUIRE( parseFails<SafeChar>("\"", csvSettings) );
+  }
+}
+
+TEST_CASE("UnprotectedField")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("empty")
+  {
+    REQUIRE( parseAll<UnprotectedField>("", csvSettings) == "" );
+  }
+
+  SECTION("A,B")
+  {
+    REQUIRE( parse<UnprotectedField>("A,B", csvSettings) == "A" );
+  }
+
+  SECTION("A B")
+  {
+    REQUIRE( parseAll<UnprotectedField>("A B", csvSettings) == "A B" );
+  }
+
+  SECTION("\"")
+  {
+    REQUIRE( parse<UnprotectedField>("\"", csvSettings) == "" );
+  }
+
+  SECTION("~A")
+  {
+    REQUIRE( parseAll<UnprotectedField>("~A", csvSettings) == "A" );
+  }
+
+  SECTION("~A (no EXP)")
+  {
+    csvSettings.setParseExp(false);
+    REQUIRE( parseAll<UnprotectedField>("~A", csvSettings) == "~A" );
+  }
+}
+
+TEST_CASE("NonEmptyUnprotectedField")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("empty")
+  {
+    REQUIRE( parseFails<NonEmptyUnprotectedField>("", csvSettings) );
+  }
+
+  SECTION(",A")
+  {
+    REQUIRE( parseFails<NonEmptyUnprotectedField>(",A", csvSettings) );
+  }
+
+  SECTION("A,B")
+  {
+    REQUIRE( parse<NonEmptyUnprotectedField>("A,B", csvSettings) == "A" );
+  }
+
+  SECTION("~")
+  {
+    REQUIRE( parseFails<NonEmptyUnprotectedField>("~", csvSettings) );
+  }
+
+  SECTION("~ (no EXP)")
+  {
+    csvSettings.setParseExp(false);
+    REQUIRE( parseAll<NonEmptyUnprotectedField>("~", csvSettings) == "~" );
+  }
+}
+
+TEST_CASE("ProtectedField")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("\"\"")
+  {
+    REQUIRE( parseAll<ProtectedField>("\"\"", csvSettings) == "" );
+  }
+
+  SECTION("\"A,B\"")
+  {
+    REQUIRE( parseAll<ProtectedField>("\"A,B\"", csvSettings) == "A,B" );
+  }
+
+  SECTION("\"A\"\"B\"")
+  {
+    REQUIRE( parseAll<ProtectedField>("\"A\"\"B\"", csvSettings) == "A\"B" );
+  }
+
+  SECTION("\"A\\r\\nB\"")
+  {
+    REQUIRE( parseAll<ProtectedField>("\"A\r\nB\"", csvSettings) == "A\r\nB" );
+  }
+
+  SECTION("\"A")
+  {
+    REQUIRE( parseFails<ProtectedField>("\"A", csvSettings) );
+  }
+
+  SECTION("A")
+  {
+    REQUIRE( parseFails<ProtectedField>("A", csvSettings) );
+  }
+
+  SECTION("\"~A\"")
+  {
+    REQUIRE( parseAll<ProtectedField>("\"~A\"", csvSettings) == "A" );
+  }
+}
+
+TEST_CASE("FieldColumn")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("empty")
+  {
+    REQUIRE( parseAll<FieldColumn>("", csvSettings) == "" );
+    REQUIRE( parseFails<NonEmptyFieldColumn>("", csvSettings) );
+  }
+
+  SECTION("A")
+  {
+    REQUIRE( parseAll<FieldColumn>("A", csvSettings) == "A" );
+    REQUIRE( parseAll<NonEmptyFieldColumn>("A", csvSettings) == "A" );
+  }
+
+  SECTION("\"A\"")
+  {
+    REQUIRE( parseAll<FieldColumn>("\"A\"", csvSettings) == "A" );
+    REQUIRE( parseAll<NonEmptyFieldColumn>("\"A\"", csvSettings) == "A" );
+  }
+
+  SECTION("\"A (unterminated protected field)")
+  {
+    REQUIRE( parse<FieldColumn>("\"A", csvSettings) == "" );
+  }
+}
+
+TEST_CASE("CsvRecord")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("empty")
+  {
+    REQUIRE( parseFails<CsvRecord>("", csvSettings) );
+  }
+
+  SECTION("A")
+  {
+    REQUIRE( parseAll<CsvRecord>("A", csvSettings) == StringRecord{"A"} );
+  }
+
+  SECTION(",")
+  {
+    REQUIRE( parseAll<CsvRecord>(",", csvSettings) == StringRecord{"",""} );
+  }
+
+  SECTION(",,C")
+  {
+    REQUIRE( parseAll<CsvRecord>(",,C", csvSettings) == StringRecord{"","","C"} );
+  }
+
+  SECTION("A,\"B,C\",D")
+  {
+    REQUIRE( parseAll<CsvRecord>("A,\"B,C\",D", csvSettings) == StringRecord{"A","B,C","D"} );
+  }
+
+  SECTION("~,B")
+  {
+    REQUIRE( parseAll<CsvRecord>("~,B", csvSettings) == StringRecord{"","B"} );
+  }
+
+  SECTION("field count")
+  {
+    REQUIRE( parseCsvRecordFieldCount("A", csvSettings) == 1 );
+    REQUIRE( parseCsvRecordFieldCount(",", csvSettings) == 2 );
+    REQUIRE( parseCsvRecordFieldCount("A,\"B\",C", csvSettings) == 3 );
+  }
+}
+
+TEST_CASE("Limits")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("maximum field length")
+  {
+    csvSettings.setMaximumFieldLength(2);
+    REQUIRE( parseAll<CsvRecord>("AB,\"CD\"", csvSettings) == StringRecord{"AB","CD"} );
+    REQUIRE( parse<CsvRecord>("ABC", csvSettings) == StringRecord{"AB"} );
+    REQUIRE( parseFails<ProtectedField>("\"ABC\"", csvSettings) );
+  }
+
+  SECTION("maximum column count 1")
+  {
+    csvSettings.setMaximumColumnCount(1);
+    REQUIRE( parseAll<CsvRecord>("A", csvSettings) == StringRecord{"A"} );
+    REQUIRE( parse<CsvRecord>("A,B", csvSettings) == StringRecord{"A"} );
+    REQUIRE( parseFails<CsvRecord>(",B", csvSettings) );
+  }
+
+  SECTION("maximum column count 2")
+  {
+    csvSettings.setMaximumColumnCount(2);
+    REQUIRE( parseAll<CsvRecord>(",B", csvSettings) == StringRecord{"","B"} );
+    REQUIRE( parse<CsvRecord>("A,B,C", csvSettings) == StringRecord{"A","B"} );
+  }
+}
+
+TEST_CASE("CsvFile")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("empty")
+  {
+    REQUIRE( parseFails<CsvFile>("", csvSettings) );
+  }
+
+  SECTION("A\\nB\\n")
+  {
+    REQUIRE( parseAll<CsvFile>("A\nB\n", csvSettings) == StringTable{{"A"},{"B"}} );
+  }
+
+  SECTION("PositionTrackingIterator<multi_pass>")
+  {
+    const std::string source = "A,B\n\"c\nd\",e\r\n\"f,g\"\nABC\nh,\"i\"\"j\"\n";
+    const StringTable expectedTable = {{"A","B"},{"c\nd","e"},{"f,g"},{"ABC"},{"h","i\"j"}};
+
+    REQUIRE( parseCsvFilePositionTrackingMultiPass(source, csvSettings) == expectedTable );
+  }
+
+  SECTION("malformed record after a flushed record")
+  {
+    const auto result = parseCsvFilePrefixPositionTrackingMultiPass("A,B\nc,d\n\"e,f\ng,h\n", csvSettings);
+    REQUIRE( result.table == StringTable{{"A","B"},{"c","d"}} );
+    REQUIRE( result.stopOffset == 8 );
+    REQUIRE( result.remainingInput == "\"e,f\ng,h\n" );
+  }
+
+  SECTION("malformed second record")
+  {
+    const auto result = parseCsvFilePrefixPositionTrackingMultiPass("A,B\n\"c,d\ne,f\n", csvSettings);
+    REQUIRE( result.table == StringTable{{"A","B"}} );
+    REQUIRE( result.stopOffset == 4 );
+    REQUIRE( result.remainingInput == "\"c,d\ne,f\n" );
+  }
+}
+
+TEST_CASE("SameResultAsQi")
+{
+  using QiCsvFile = Grammar::Csv::Qi::CsvFile<std::string::const_iterator, StringTable>;
+
+  CsvParserSettings csvSettings;
+  csvSettings.setParseExp( GENERATE(false, true) );
+
+  const std::string source = GENERATE( as<std::string>(),
+    "A", ",", ",,", "A,", ",B", "~", "~,", "~A,~B", "\"~A\",B",
+    "A B , C", "\"A\"\"B\",\"\"", "\"A\nB\"\r\nC\n", "A\n\nB", "\"A", "A\"B", "A,\"B\"C", u8"\u00e9,\"\u00fc\""
+  );
+
+  StringTable qiTable;
+  auto qiFirst = source.cbegin();
+  const bool qiOk = boost::spirit::qi::parse(qiFirst, source.cend(), QiCsvFile(csvSettings), qiTable);
+
+  StringTable x3Table;
+  auto x3First = source.cbegin();
+  const bool x3Ok = boost::spirit::x3::parse(x3First, source.cend(), CsvFile(csvSettings), x3Table);
+
+  REQUIRE( x3Ok == qiOk );
+  REQUIRE( x3First == qiFirst );
+  if(qiOk){
+    REQUIRE( x3Table == qiTable );
+  }
+}
+
+TEST_CASE("CsvDialect")
+{
+  using SemicolonCsvRecord = Grammar::Csv::X3::CsvRecord< StringRecord, SemicolonCsvDialect<true> >;
+  using SemicolonCsvFile = Grammar::Csv::X3::CsvFile< StringTable, SemicolonCsvDialect<true> >;
+
+  CsvParserSettings csvSettings;
+  csvSettings.setFieldSeparator(';');
+
+  SECTION("CsvRecord")
+  {
+    REQUIRE( parseAll<SemicolonCsvRecord>("A;\"B;C\";D,E", csvSettings) == StringRecord{"A","B;C","D,E"} );
+    REQUIRE( parseAll<SemicolonCsvRecord>("~;B", csvSettings) == StringRecord{"","B"} );
+  }
+
+  SECTION("CsvFile")
+  {
+    const std::string source = "A;B\n\"c\nd\";~e\r\n\"f;g\"\n;\n";
+    const StringTable expectedTable = {{"A","B"},{"c\nd","e"},{"f;g"},{"",""}};
+
+    REQUIRE( parseAll<SemicolonCsvFile>(source, csvSettings) == expectedTable );
+    REQUIRE( parseAll<CsvFile>(source, csvSettings) == expectedTable );
+  }
+}
+
+TEST_CASE("CsvRawRecord")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("empty")
+  {
+    REQUIRE( parseFails<CsvRawRecord>("", csvSettings) );
+  }
+
+  SECTION("A,\"B,C\",~D")
+  {
+    const std::string source = "A,\"B,C\",~D";
+    const RawRecord record = parseCsvRawRecord(source, csvSettings);
+    REQUIRE( record.size() == 3 );
+    REQUIRE( !record[0].needsUnescape() );
+    REQUIRE( record[0].begin() == source.cbegin() );
+    REQUIRE( record[0].toString() == "A" );
+    REQUIRE( !record[1].needsUnescape() );
+    REQUIRE( record[1].toString() == "B,C" );
+    REQUIRE( record[2].toString() == "D" );
+  }
+
+  SECTION("\"A\"\"B\",\"\"")
+  {
+    const std::string source = "\"A\"\"B\",\"\"";
+    const RawRecord record = parseCsvRawRecord(source, csvSettings);
+    REQUIRE( record.size() == 2 );
+    REQUIRE( record[0].needsUnescape() );
+    REQUIRE( std::string(record[0].begin(), record[0].end()) == "A\"\"B" );
+    REQUIRE( record[0].toString() == "A\"B" );
+    REQUIRE( !record[1].needsUnescape() );
+    REQUIRE( record[1].isEmpty() );
+  }
+}
+
+TEST_CASE("CsvRawRecordSameResultAsCsvRecord")
+{
+  CsvParserSettings csvSettings;
+  csvSettings.setParseExp( GENERATE(false, true) );
+  csvSettings.setMaximumFieldLength( GENERATE(0, 1, 2) );
+  csvSettings.setMaximumColumnCount( GENERATE(0, 1, 2) );
+
+  const std::string source = GENERATE( as<std::string>(),
+    "", "A", ",", ",,", "A,", ",B", "~", "~,", "~A,~B", "\"~A\",B", "\"~\",B", "AB,CD,EF",
+    "A B , C", "\"A\"\"B\",\"\"", "\"\"\"\"", "\"A\"\"\"", "\"AB\"\"\",C", "\"A\nB\"\r\nC\n",
+    "\"A", "A\"B", "A,\"B\"C", "\tA", u8"\u00e9,\"\u00fc\""
+  );
+
+  StringRecord record;
+  auto recordFirst = source.cbegin();
+  const bool recordOk = boost::spirit::x3::parse(recordFirst, source.cend(), CsvRecord(csvSettings), record);
+
+  RawRecord rawRecord;
+  auto rawRecordFirst = source.cbegin();
+  const bool rawRecordOk = boost::spirit::x3::parse(rawRecordFirst, source.cend(), CsvRawRecord(csvSettings), rawRecord);
+
+  REQUIRE( rawRecordOk == recordOk );
+  REQUIRE( rawRecordFirst == recordFirst );
+  if(recordOk){
+    REQUIRE( toStringRecord(rawRecord) == record );
+  }
+}
+
+TEST_CASE("HybridCsvRecord")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("A,~B,C D")
+  {
+    REQUIRE( parseAll<HybridCsvRecord>("A,~B,C D", csvSettings) == StringRecord{"A","B","C D"} );
+  }
+
+  SECTION("A,\"B,C\"")
+  {
+    REQUIRE( parseAll<HybridCsvRecord>("A,\"B,C\"", csvSettings) == StringRecord{"A","B,C"} );
+  }
+
+  SECTION("A,B\\nC")
+  {
+    REQUIRE( parse<HybridCsvRecord>("A,B\nC", csvSettings) == StringRecord{"A","B"} );
+  }
+}
+
+template<typename Dialect>
+bool parseHybridCsvRecord(std::string::const_iterator & first, const std::string::const_iterator & last,
+                          const CsvParserSettings & settings, StringRecord & record)
+{
+  return boost::spirit::x3::parse(first, last, Grammar::Csv::X3::HybridCsvRecord<StringRecord, Dialect>(settings), record);
+}
+
+TEST_CASE("HybridCsvRecordSameResultAsCsvRecord")
+{
+  CsvParserSettings csvSettings;
+  csvSettings.setFieldSeparator( GENERATE(',', '\t') );
+  csvSettings.setParseExp( GENERATE(false, true) );
+  csvSettings.setMaximumFieldLength( GENERATE(0, 1, 2) );
+  csvSettings.setMaximumColumnCount( GENERATE(0, 1, 2) );
+
+  const std::string source = GENERATE( as<std::string>(),
+    "", "A", ",", ",,", "A,", ",B", "~", "~~", "~,", "~A,~B", "~~A", "\"~A\",B", "AB,CD,EF", "AB,C\nD",
+    "A B , C", "A\tB,C", "\"A\"\"B\",\"\"", "\"A\nB\"\r\nC\n", "A\r\nB", "\n", "\r\n",
+    "\"A", "A\"B", "A,\"B\"C", u8"\u00e9,\u00fc",
+    "A,\"B\"", "AB,C,\"D,E\",F", ",\"B\"", "A,,\"B\"", "A,~\"B\"", "~A,\"B\"\nC", "A,\"B\nC\",D\r\n", "A,B\"C\",D",
+    "\t", "\t\t", "A\t", "\tB", "AB\tCD\tEF", "~A\t~B", "A B \t C", "AB\tC\nD", "A\t\"B\tC\"", u8"\u00e9\t\u00fc"
+  );
+
+  StringRecord record;
+  auto recordFirst = source.cbegin();
+  const bool recordOk = boost::spirit::x3::parse(recordFirst, source.cend(), CsvRecord(csvSettings), record);
+
+  SECTION("std::string")
+  {
+    StringRecord hybridRecord;
+    auto hybridFirst = source.cbegin();
+    const bool hybridOk = boost::spirit::x3::parse(hybridFirst, source.cend(), HybridCsvRecord(csvSettings), hybridRecord);
+
+    REQUIRE( hybridOk == recordOk );
+    REQUIRE( hybridFirst == recordFirst );
+    REQUIRE( hybridRecord == record );
+  }
+
+  SECTION("std::list")
+  {
+    const std::list<char> listSource(source.cbegin(), source.cend());
+
+    StringRecord hybridRecord;
+    auto hybridFirst = listSource.cbegin();
+    const bool hybridOk = boost::spirit::x3::parse(hybridFirst, listSource.cend(), HybridCsvRecord(csvSettings), hybridRecord);
+
+    REQUIRE( hybridOk == recordOk );
+    REQUIRE( std::distance(listSource.cbegin(), hybridFirst) == std::distance(source.cbegin(), recordFirst) );
+    REQUIRE( hybridRecord == record );
+  }
+
+  SECTION("PositionTrackingIterator<multi_pass>")
+  {
+    using SourceIterator = PositionTrackingIterator< boost::spirit::multi_pass< std::istreambuf_iterator<char> > >;
+
+    std::istringstream stream(source);
+    SourceIterator hybridFirst( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>(stream) ) );
+    const SourceIterator last( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>() ) );
+
+    StringRecord hybridRecord;
+    const bool hybridOk = boost::spirit::x3::parse(hybridFirst, last, HybridCsvRecord(csvSettings), hybridRecord);
+
+    REQUIRE( hybridOk == recordOk );
+    REQUIRE( hybridFirst.position().offset() == std::distance(source.cbegin(), recordFirst) );
+    REQUIRE( hybridRecord == record );
+  }
+
+  SECTION("CsvFieldCountRecord")
+  {
+    const std::list<char> listSource(source.cbegin(), source.cend());
+
+    Impl::CsvFieldCountRecord hybridRecord;
+    auto hybridFirst = listSource.cbegin();
+    const bool hybridOk = boost::spirit::x3::parse(hybridFirst, listSource.cend(), Grammar::Csv::X3::HybridCsvRecord<Impl::CsvFieldCountRecord>(csvSettings), hybridRecord);
+
+    REQUIRE( hybridOk == recordOk );
+    REQUIRE( std::distance(listSource.cbegin(), hybridFirst) == std::distance(source.cbegin(), recordFirst) );
+    if(recordOk){
+      REQUIRE( hybridRecord.size() == static_cast<int>( record.size() ) );
+    }
+  }
+
+  SECTION("TabCsvDialect")
+  {
+    if( csvSettings.fieldSeparator() == '\t' ){
+      StringRecord hybridRecord;
+      auto hybridFirst = source.cbegin();
+      bool hybridOk;
+      if( csvSettings.parseExp() ){
+        hybridOk = parseHybridCsvRecord< TabCsvDialect<true> >(hybridFirst, source.cend(), csvSettings, hybridRecord);
+      }else{
+        hybridOk = parseHybridCsvRecord< TabCsvDialect<false> >(hybridFirst, source.cend(), csvSettings, hybridRecord);
+      }
+
+      REQUIRE( hybridOk == recordOk );
+      REQUIRE( hybridFirst == recordFirst );
+      REQUIRE( hybridRecord == record );
+    }
+  }
+}
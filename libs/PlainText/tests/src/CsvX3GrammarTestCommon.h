@@ -0,0 +1,189 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/Grammar/Csv/X3/SafeChar.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/UnprotectedField.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/NonEmptyUnprotectedField.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/ProtectedField.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/FieldColumn.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/NonEmptyFieldColumn.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvRecord.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvFile.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvRawRecord.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/HybridCsvRecord.h"
+#include "Mdt/PlainText/CsvRawField.h"
+#include "Mdt/PlainText/Impl/CsvFieldCountRecord.h"
+#include "Mdt/PlainText/CsvParserSettings"
+#include "Mdt/PlainText/PositionTrackingIterator.h"
+#include <boost/spirit/include/support_multi_pass.hpp>
+#include <boost/spirit/home/x3.hpp>
+#include <sstream>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+#include <cstdint>
+
+using namespace Mdt::PlainText;
+
+using StringRecord = std::vector<std::string>;
+using StringTable = std::vector<StringRecord>;
+
+using SafeChar = Grammar::Csv::X3::SafeChar<>;
+using UnprotectedField = Grammar::Csv::X3::UnprotectedField<std::string>;
+using NonEmptyUnprotectedField = Grammar::Csv::X3::NonEmptyUnprotectedField<std::string>;
+using ProtectedField = Grammar::Csv::X3::ProtectedField<std::string>;
+using FieldColumn = Grammar::Csv::X3::FieldColumn<std::string>;
+using NonEmptyFieldColumn = Grammar::Csv::X3::NonEmptyFieldColumn<std::string>;
+using CsvRecord = Grammar::Csv::X3::CsvRecord<StringRecord>;
+using CsvFieldCountRecord = Grammar::Csv::X3::CsvRecord<Impl::CsvFieldCountRecord>;
+using CsvFile = Grammar::Csv::X3::CsvFile<StringTable>;
+using HybridCsvRecord = Grammar::Csv::X3::HybridCsvRecord<StringRecord>;
+using RawRecord = std::vector< CsvRawField<std::string::const_iterator> >;
+using CsvRawRecord = Grammar::Csv::X3::CsvRawRecord<RawRecord>;
+
+
+template<typename Parser>
+bool parseFails(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  assert( settings.isValid() );
+
+  const Parser parser(settings);
+  auto first = sourceString.cbegin();
+
+  return !boost::spirit::x3::parse(first, sourceString.cend(), parser);
+}
+
+/*
+ * The whole source must be consumed
+ */
+template<typename Parser, typename Attribute = typename Parser::attribute_type>
+Attribute parseAll(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  assert( settings.isValid() );
+
+  Attribute attribute;
+  const Parser parser(settings);
+  auto first = sourceString.cbegin();
+
+  const bool ok = boost::spirit::x3::parse(first, sourceString.cend(), parser, attribute);
+  if( !ok || (first != sourceString.cend()) ){
+    const std::string what = "Failed to parse '" + sourceString + "'";
+    throw std::runtime_error(what);
+  }
+
+  return attribute;
+}
+
+/*
+ * Same as parseAll(), but only a part of the source can be consumed
+ */
+template<typename Parser, typename Attribute = typename Parser::attribute_type>
+Attribute parse(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  assert( settings.isValid() );
+
+  Attribute attribute;
+  const Parser parser(settings);
+  auto first = sourceString.cbegin();
+
+  const bool ok = boost::spirit::x3::parse(first, sourceString.cend(), parser, attribute);
+  if(!ok){
+    const std::string what = "Failed to parse '" + sourceString + "'";
+    throw std::runtime_error(what);
+  }
+
+  return attribute;
+}
+
+int parseCsvRecordFieldCount(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  return parseAll<CsvFieldCountRecord>(sourceString, settings).size();
+}
+
+template<typename SourceIterator>
+StringTable parseCsvFileStream(std::istream & stream, const CsvParserSettings & settings)
+{
+  StringTable table;
+  const CsvFile parser(settings);
+
+  SourceIterator first( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>(stream) ) );
+  const SourceIterator last( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>() ) );
+
+  const bool ok = boost::spirit::x3::parse(first, last, parser, table);
+  if( !ok || (first != last) ){
+    throw std::runtime_error("Failed to parse table from stream");
+  }
+
+  return table;
+}
+
+StringTable parseCsvFilePositionTrackingMultiPass(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  using SourceIterator = PositionTrackingIterator< boost::spirit::multi_pass< std::istreambuf_iterator<char> > >;
+
+  std::istringstream stream(sourceString);
+
+  return parseCsvFileStream<SourceIterator>(stream, settings);
+}
+
+/*
+ * Result of parsing a source up to the first record that can not be parsed
+ */
+struct CsvFilePrefixParseResult
+{
+  StringTable table;
+  int64_t stopOffset = -1;
+  std::string remainingInput;
+};
+
+/*
+ * Parse the source with CsvFile through a PositionTrackingIterator<multi_pass>,
+ * which stops before the first record that can not be parsed.
+ * The remaining input is then read back from the iterator at which the parsing stopped,
+ * so it is only correct if no released input was used.
+ */
+CsvFilePrefixParseResult parseCsvFilePrefixPositionTrackingMultiPass(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  using SourceIterator = PositionTrackingIterator< boost::spirit::multi_pass< std::istreambuf_iterator<char> > >;
+
+  CsvFilePrefixParseResult result;
+  const CsvFile rule(settings);
+
+  std::istringstream stream(sourceString);
+  SourceIterator first( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>(stream) ) );
+  const SourceIterator last( boost::spirit::make_default_multi_pass( std::istreambuf_iterator<char>() ) );
+
+  if( !boost::spirit::x3::parse(first, last, rule, result.table) ){
+    throw std::runtime_error("Failed to parse the first record from stream");
+  }
+  result.stopOffset = first.position().offset();
+  result.remainingInput.assign(first, last);
+
+  return result;
+}
+
+StringRecord toStringRecord(const RawRecord & rawRecord)
+{
+  StringRecord record;
+
+  for(const auto & field : rawRecord){
+    record.push_back( field.toString() );
+  }
+
+  return record;
+}
+
+/*
+ * The source must outlive the returned record
+ */
+RawRecord parseCsvRawRecord(const std::string & sourceString, const CsvParserSettings & settings)
+{
+  return parse<CsvRawRecord>(sourceString, settings);
+}
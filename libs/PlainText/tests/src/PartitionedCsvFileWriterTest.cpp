@@ -0,0 +1,274 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "CsvFileWriterTestCommon.h"
+#include "Mdt/PlainText/PartitionedCsvFileWriter"
+#include <QFileInfo>
+
+void setDirectoryPathToWriter(const QTemporaryDir & dir, PartitionedCsvFileWriter & writer)
+{
+  assert( dir.isValid() );
+
+  writer.setDirectoryPath( dir.path().toLocal8Bit().toStdString() );
+}
+
+std::string readPartitionFile(const QTemporaryDir & dir, const char *fileName)
+{
+  return readBinaryFile( filePathFromDirAndFileName(dir, fileName) );
+}
+
+TEST_CASE("defaults")
+{
+  PartitionedCsvFileWriter writer;
+  REQUIRE( writer.directoryPath().empty() );
+  REQUIRE( writer.fileNameSuffix() == ".csv" );
+  REQUIRE( writer.header().empty() );
+  REQUIRE( writer.openMode() == FileWriteOpenMode::Append );
+  REQUIRE( writer.maxOpenFileCount() == PartitionedCsvFileWriter::defaultMaxOpenFileCount );
+  REQUIRE( writer.bufferSize() == PartitionedCsvFileWriter::defaultBufferSize );
+  REQUIRE( !writer.isOpen() );
+}
+
+TEST_CASE("set_get")
+{
+  PartitionedCsvFileWriter writer;
+
+  writer.setDirectoryPath("/tmp/exports");
+  REQUIRE( writer.directoryPath() == "/tmp/exports" );
+  REQUIRE( writer.partitionFilePath("A") == "/tmp/exports/A.csv" );
+
+  writer.setFileNameSuffix(".txt");
+  REQUIRE( writer.fileNameSuffix() == ".txt" );
+  REQUIRE( writer.partitionFilePath("A") == "/tmp/exports/A.txt" );
+
+  writer.setHeader({"Key","Value"});
+  REQUIRE( writer.header() == std::vector<std::string>{"Key","Value"} );
+
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  REQUIRE( writer.openMode() == FileWriteOpenMode::Truncate );
+
+  writer.setMaxOpenFileCount(3);
+  REQUIRE( writer.maxOpenFileCount() == 3 );
+
+  writer.setBufferSize(1024);
+  REQUIRE( writer.bufferSize() == 1024 );
+}
+
+TEST_CASE("write")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  PartitionedCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  setDirectoryPathToWriter(dir, writer);
+  writer.setKeyColumn(0);
+
+  SECTION("writeLine")
+  {
+    writer.open();
+    REQUIRE( writer.isOpen() );
+    writer.writeLine({"A","1"});
+    writer.writeLine({"B","2"});
+    writer.writeLine({"A","3"});
+    REQUIRE( writer.partitionCount() == 2 );
+    REQUIRE( writer.openFileCount() == 2 );
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+    REQUIRE( writer.openFileCount() == 0 );
+    REQUIRE( readPartitionFile(dir, "A.csv") == "A,1\nA,3\n" );
+    REQUIRE( readPartitionFile(dir, "B.csv") == "B,2\n" );
+  }
+
+  SECTION("writeLines")
+  {
+    const std::vector< std::vector<std::string> > table{{"A","1"},{"B","2"},{"A","3"}};
+    writer.open();
+    writer.writeLines( table.cbegin(), table.cbegin() );
+    REQUIRE( writer.partitionCount() == 0 );
+    writer.writeLines( table.cbegin(), table.cend() );
+    writer.close();
+    REQUIRE( readPartitionFile(dir, "A.csv") == "A,1\nA,3\n" );
+    REQUIRE( readPartitionFile(dir, "B.csv") == "B,2\n" );
+  }
+
+  SECTION("key extractor")
+  {
+    writer.setKeyExtractor( [](const std::vector<std::string> & record){
+      return record.back().substr(0, 4);
+    });
+    writer.open();
+    writer.writeLine({"A","2020-05-12"});
+    writer.writeLine({"B","2021-01-01"});
+    writer.writeLine({"C","2020-12-31"});
+    writer.close();
+    REQUIRE( readPartitionFile(dir, "2020.csv") == "A,2020-05-12\nC,2020-12-31\n" );
+    REQUIRE( readPartitionFile(dir, "2021.csv") == "B,2021-01-01\n" );
+  }
+
+  SECTION("flush")
+  {
+    writer.open();
+    writer.writeLine({"A","1"});
+    writer.flush();
+    REQUIRE( readPartitionFile(dir, "A.csv") == "A,1\n" );
+    writer.close();
+  }
+
+  SECTION("no key")
+  {
+    writer.setKeyColumn(1);
+    writer.open();
+    REQUIRE_THROWS_AS( writer.writeLine({}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({"A"}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({"A",""}), CsvFileWriteError );
+    REQUIRE( writer.partitionCount() == 0 );
+    writer.close();
+  }
+
+  SECTION("key that is not a valid file name")
+  {
+    writer.open();
+    REQUIRE_THROWS_AS( writer.writeLine({"../escaped","1"}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({"2020/01/02","1"}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({"A\\B","1"}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({std::string("A\0B", 3),"1"}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({".","1"}), CsvFileWriteError );
+    REQUIRE_THROWS_AS( writer.writeLine({"..","1"}), CsvFileWriteError );
+    REQUIRE( writer.partitionCount() == 0 );
+    writer.writeLine({"..A","1"});
+    writer.close();
+    REQUIRE( readPartitionFile(dir, "..A.csv") == "..A,1\n" );
+    REQUIRE( !QFileInfo::exists( dir.path() + QLatin1String("/../escaped.csv") ) );
+  }
+}
+
+TEST_CASE("header")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  PartitionedCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  setDirectoryPathToWriter(dir, writer);
+  writer.setKeyColumn(0);
+  writer.setHeader({"Key","Value"});
+
+  SECTION("new files")
+  {
+    writer.open();
+    writer.writeLine({"A","1"});
+    writer.writeLine({"B","2"});
+    writer.writeLine({"A","3"});
+    writer.close();
+    REQUIRE( readPartitionFile(dir, "A.csv") == "Key,Value\nA,1\nA,3\n" );
+    REQUIRE( readPartitionFile(dir, "B.csv") == "Key,Value\nB,2\n" );
+  }
+
+  SECTION("append to existing files")
+  {
+    writer.open();
+    writer.writeLine({"A","1"});
+    writer.close();
+    writer.open();
+    writer.writeLine({"A","2"});
+    writer.writeLine({"B","3"});
+    writer.close();
+    REQUIRE( readPartitionFile(dir, "A.csv") == "Key,Value\nA,1\nA,2\n" );
+    REQUIRE( readPartitionFile(dir, "B.csv") == "Key,Value\nB,3\n" );
+  }
+
+  SECTION("truncate existing files")
+  {
+    writer.setOpenMode(FileWriteOpenMode::Truncate);
+    writer.open();
+    writer.writeLine({"A","1"});
+    writer.close();
+    writer.open();
+    writer.writeLine({"A","2"});
+    writer.close();
+    REQUIRE( readPartitionFile(dir, "A.csv") == "Key,Value\nA,2\n" );
+  }
+}
+
+TEST_CASE("maxOpenFileCount")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  PartitionedCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  setDirectoryPathToWriter(dir, writer);
+  writer.setKeyColumn(0);
+  writer.setHeader({"Key","Value"});
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.setMaxOpenFileCount(2);
+  writer.open();
+
+  SECTION("least recently used partition is closed")
+  {
+    writer.writeLine({"A","1"});
+    writer.writeLine({"B","2"});
+    writer.writeLine({"A","3"});
+    writer.writeLine({"C","4"});
+    REQUIRE( writer.openFileCount() == 2 );
+    // B was evicted, its data must be in the file
+    REQUIRE( readPartitionFile(dir, "B.csv") == "Key,Value\nB,2\n" );
+    // B is reopened in append mode, without header
+    writer.writeLine({"B","5"});
+    REQUIRE( writer.openFileCount() == 2 );
+    REQUIRE( writer.partitionCount() == 3 );
+    writer.close();
+    REQUIRE( readPartitionFile(dir, "A.csv") == "Key,Value\nA,1\nA,3\n" );
+    REQUIRE( readPartitionFile(dir, "B.csv") == "Key,Value\nB,2\nB,5\n" );
+    REQUIRE( readPartitionFile(dir, "C.csv") == "Key,Value\nC,4\n" );
+  }
+
+  SECTION("many partitions")
+  {
+    const int partitionCount = 50;
+    const int lineCount = 20;
+    for(int line = 0; line < lineCount; ++line){
+      for(int partition = 0; partition < partitionCount; ++partition){
+        writer.writeLine({std::to_string(partition), std::to_string(line)});
+      }
+    }
+    REQUIRE( writer.openFileCount() == 2 );
+    REQUIRE( writer.partitionCount() == partitionCount );
+    writer.close();
+
+    std::string expectedData = "Key,Value\n";
+    for(int line = 0; line < lineCount; ++line){
+      expectedData += "7," + std::to_string(line) + "\n";
+    }
+    REQUIRE( readPartitionFile(dir, "7.csv") == expectedData );
+  }
+}
+
+TEST_CASE("open_error")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  PartitionedCsvFileWriter writer;
+  writer.setDirectoryPath( dir.path().toLocal8Bit().toStdString() + "/NotExisting" );
+  writer.setKeyColumn(0);
+  writer.open();
+
+  REQUIRE_THROWS_AS( writer.writeLine({"A","1"}), FileOpenError );
+  REQUIRE( writer.openFileCount() == 0 );
+  REQUIRE( writer.partitionCount() == 0 );
+  writer.close();
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/PositionTrackingIterator.h"
+#include <boost/spirit/include/qi.hpp>
+#include <string>
+#include <type_traits>
+#include <iterator>
+
+using Mdt::PlainText::PositionTrackingIterator;
+using Mdt::PlainText::SourcePosition;
+
+using Iterator = PositionTrackingIterator<std::string::const_iterator>;
+
+static_assert( std::is_same< std::iterator_traits<Iterator>::value_type, char >::value, "" );
+static_assert( std::is_same< std::iterator_traits<Iterator>::iterator_category, std::forward_iterator_tag >::value, "" );
+
+
+SourcePosition positionAfter(const std::string & source, std::string::size_type charCount)
+{
+  Iterator it( source.cbegin() );
+  std::advance(it, charCount);
+
+  return it.position();
+}
+
+
+TEST_CASE("construct")
+{
+  const std::string source = "A";
+
+  Iterator first( source.cbegin() );
+  Iterator last( source.cend() );
+  REQUIRE( first != last );
+  REQUIRE( *first == 'A' );
+  REQUIRE( first.position().offset() == 0 );
+  REQUIRE( first.position().lineNumber() == 1 );
+  REQUIRE( first.position().columnNumber() == 1 );
+}
+
+TEST_CASE("increment")
+{
+  SECTION("AB")
+  {
+    const std::string source = "AB";
+    const auto position = positionAfter(source, 2);
+    REQUIRE( position.offset() == 2 );
+    REQUIRE( position.lineNumber() == 1 );
+    REQUIRE( position.columnNumber() == 3 );
+  }
+
+  SECTION("A\\nB")
+  {
+    const std::string source = "A\nB";
+    auto position = positionAfter(source, 2);
+    REQUIRE( position.offset() == 2 );
+    REQUIRE( position.lineNumber() == 2 );
+    REQUIRE( position.columnNumber() == 1 );
+    position = positionAfter(source, 3);
+    REQUIRE( position.offset() == 3 );
+    REQUIRE( position.lineNumber() == 2 );
+    REQUIRE( position.columnNumber() == 2 );
+  }
+
+  SECTION("A\\r\\nB")
+  {
+    const std::string source = "A\r\nB";
+    auto position = positionAfter(source, 3);
+    REQUIRE( position.offset() == 3 );
+    REQUIRE( position.lineNumber() == 2 );
+    REQUIRE( position.columnNumber() == 1 );
+    position = positionAfter(source, 4);
+    REQUIRE( position.lineNumber() == 2 );
+    REQUIRE( position.columnNumber() == 2 );
+  }
+
+  SECTION("A\\rB")
+  {
+    const std::string source = "A\rB";
+    const auto position = positionAfter(source, 2);
+    REQUIRE( position.lineNumber() == 2 );
+    REQUIRE( position.columnNumber() == 1 );
+  }
+
+  SECTION("A\\n\\nB")
+  {
+    const std::string source = "A\n\nB";
+    const auto position = positionAfter(source, 3);
+    REQUIRE( position.lineNumber() == 3 );
+    REQUIRE( position.columnNumber() == 1 );
+  }
+
+  SECTION("A\\n\\r\\nB")
+  {
+    const std::string source = "A\n\r\nB";
+    const auto position = positionAfter(source, 4);
+    REQUIRE( position.lineNumber() == 3 );
+    REQUIRE( position.columnNumber() == 1 );
+  }
+}
+
+TEST_CASE("Qi parse")
+{
+  namespace qi = boost::spirit::qi;
+
+  const std::string source = "abc\ndef\n12";
+  Iterator first( source.cbegin() );
+  const Iterator last( source.cend() );
+
+  std::string word;
+  REQUIRE( qi::parse(first, last, +qi::alpha >> qi::eol, word) );
+  word.clear();
+  REQUIRE( qi::parse(first, last, +qi::alpha >> qi::eol, word) );
+  REQUIRE( word == "def" );
+  REQUIRE( first.position().offset() == 8 );
+  REQUIRE( first.position().lineNumber() == 3 );
+  REQUIRE( first.position().columnNumber() == 1 );
+
+  // Failed parse must not move the iterator
+  REQUIRE( !qi::parse(first, last, +qi::alpha, word) );
+  REQUIRE( first.position().offset() == 8 );
+}
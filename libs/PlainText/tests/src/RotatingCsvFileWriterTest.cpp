@@ -0,0 +1,225 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "CsvFileWriterTestCommon.h"
+#include "Mdt/PlainText/RotatingCsvFileWriter"
+
+void setFilePathToWriter(const QString & filePath, RotatingCsvFileWriter & writer)
+{
+  writer.setFilePath( filePath.toLocal8Bit().toStdString() );
+}
+
+std::string readRotatedFile(const RotatingCsvFileWriter & writer, int index)
+{
+  return readBinaryFile( QString::fromLocal8Bit( writer.rotatedFilePath(index).c_str() ) );
+}
+
+bool rotatedFileExists(const RotatingCsvFileWriter & writer, int index)
+{
+  return fileExists( QString::fromLocal8Bit( writer.rotatedFilePath(index).c_str() ) );
+}
+
+TEST_CASE("defaults")
+{
+  RotatingCsvFileWriter writer;
+  REQUIRE( writer.filePath().empty() );
+  REQUIRE( writer.header().empty() );
+  REQUIRE( writer.maxFileSize() == 0 );
+  REQUIRE( writer.maxRecordCount() == 0 );
+  REQUIRE( writer.bufferSize() == BufferedFileSink::defaultBufferSize );
+  REQUIRE( !writer.isOpen() );
+}
+
+TEST_CASE("set_get")
+{
+  RotatingCsvFileWriter writer;
+
+  writer.setFilePath("file.csv");
+  REQUIRE( writer.filePath() == "file.csv" );
+
+  writer.setHeader({"A","B"});
+  REQUIRE( writer.header() == std::vector<std::string>{"A","B"} );
+
+  writer.setMaxFileSize(1000);
+  REQUIRE( writer.maxFileSize() == 1000 );
+
+  writer.setMaxRecordCount(10);
+  REQUIRE( writer.maxRecordCount() == 10 );
+
+  writer.setBufferSize(1024);
+  REQUIRE( writer.bufferSize() == 1024 );
+}
+
+TEST_CASE("rotatedFilePath")
+{
+  RotatingCsvFileWriter writer;
+
+  SECTION("with extension")
+  {
+    writer.setFilePath("/tmp/export.csv");
+    REQUIRE( writer.rotatedFilePath(1) == "/tmp/export_0001.csv" );
+    REQUIRE( writer.rotatedFilePath(12345) == "/tmp/export_12345.csv" );
+  }
+
+  SECTION("without extension")
+  {
+    writer.setFilePath("/tmp.d/export");
+    REQUIRE( writer.rotatedFilePath(2) == "/tmp.d/export_0002" );
+  }
+
+  SECTION("hidden file")
+  {
+    writer.setFilePath("/tmp/.export");
+    REQUIRE( writer.rotatedFilePath(3) == "/tmp/.export_0003" );
+  }
+}
+
+TEST_CASE("write")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  RotatingCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  setFilePathToWriter(filePathFromDirAndFileName(dir, "export.csv"), writer);
+
+  SECTION("no limit")
+  {
+    writer.open();
+    REQUIRE( writer.isOpen() );
+    REQUIRE( writer.fileIndex() == 1 );
+    writer.writeLine({"A","b,c"});
+    writer.writeTypedLine({"D", 2, true});
+    REQUIRE( writer.fileRecordCount() == 2 );
+    REQUIRE( writer.fileSize() == 17 );
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+    REQUIRE( readRotatedFile(writer, 1) == "A,\"b,c\"\nD,2,true\n" );
+    REQUIRE( !rotatedFileExists(writer, 2) );
+  }
+
+  SECTION("maxRecordCount")
+  {
+    writer.setMaxRecordCount(2);
+    writer.setHeader({"H1","H2"});
+    writer.open();
+    writer.writeLine({"1","a"});
+    writer.writeLine({"2","b"});
+    REQUIRE( writer.fileIndex() == 1 );
+    writer.writeLine({"3","c"});
+    REQUIRE( writer.fileIndex() == 2 );
+    REQUIRE( writer.fileRecordCount() == 1 );
+    REQUIRE( writer.fileSize() == 10 );
+    REQUIRE( writer.totalRecordCount() == 3 );
+    REQUIRE( writer.totalSize() == 24 );
+    writer.close();
+    REQUIRE( readRotatedFile(writer, 1) == "H1,H2\n1,a\n2,b\n" );
+    REQUIRE( readRotatedFile(writer, 2) == "H1,H2\n3,c\n" );
+    REQUIRE( !rotatedFileExists(writer, 3) );
+  }
+
+  SECTION("maxFileSize")
+  {
+    writer.setMaxFileSize(10);
+    writer.open();
+    writer.writeLine({"1","a"});
+    writer.writeLine({"2","b"});
+    writer.writeLine({"3","c"});
+    writer.writeLine({"Larger","than 10"});
+    writer.writeLine({"4","d"});
+    REQUIRE( writer.fileIndex() == 4 );
+    REQUIRE( writer.totalRecordCount() == 5 );
+    writer.close();
+    REQUIRE( readRotatedFile(writer, 1) == "1,a\n2,b\n" );
+    REQUIRE( readRotatedFile(writer, 2) == "3,c\n" );
+    REQUIRE( readRotatedFile(writer, 3) == "Larger,than 10\n" );
+    REQUIRE( readRotatedFile(writer, 4) == "4,d\n" );
+    REQUIRE( !rotatedFileExists(writer, 5) );
+  }
+
+  SECTION("writeLines")
+  {
+    const std::vector< std::vector<std::string> > table{{"1"},{},{"2"},{"3"}};
+    writer.setMaxRecordCount(2);
+    writer.open();
+    writer.writeLines( table.cbegin(), table.cbegin() );
+    writer.writeLines( table.cbegin(), table.cend() );
+    writer.close();
+    REQUIRE( readRotatedFile(writer, 1) == "1\n2\n" );
+    REQUIRE( readRotatedFile(writer, 2) == "3\n" );
+  }
+
+  SECTION("many files")
+  {
+    const int recordCount = 1000;
+    writer.setMaxRecordCount(7);
+    writer.setBufferSize(64);
+    writer.open();
+    for(int i = 0; i < recordCount; ++i){
+      writer.writeLine({std::to_string(i)});
+    }
+    writer.close();
+    REQUIRE( writer.fileIndex() == 143 );
+    REQUIRE( readRotatedFile(writer, 143) == "994\n995\n996\n997\n998\n999\n" );
+    REQUIRE( !rotatedFileExists(writer, 144) );
+  }
+
+  SECTION("empty record")
+  {
+    writer.open();
+    REQUIRE_THROWS_AS( writer.writeLine({}), CsvFileWriteError );
+    writer.close();
+    REQUIRE( readRotatedFile(writer, 1).empty() );
+  }
+}
+
+TEST_CASE("open_error")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  RotatingCsvFileWriter writer;
+  setFilePathToWriter(filePathFromDirAndFileName(dir, "NotExisting/export.csv"), writer);
+  REQUIRE_THROWS_AS( writer.open(), FileOpenError );
+  REQUIRE( !writer.isOpen() );
+}
+
+TEST_CASE("next_file_open_error")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  RotatingCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  writer.setMaxRecordCount(1);
+  setFilePathToWriter(filePathFromDirAndFileName(dir, "export.csv"), writer);
+
+  /*
+   * A directory at the path of the next file
+   * makes opening it fail
+   */
+  const QString nextFilePath = QString::fromLocal8Bit( writer.rotatedFilePath(2).c_str() );
+  REQUIRE( QDir().mkdir(nextFilePath) );
+
+  writer.open();
+  writer.writeLine({"1"});
+  REQUIRE_THROWS_AS( writer.writeLine({"2"}), FileOpenError );
+  REQUIRE( writer.fileIndex() == 1 );
+  REQUIRE( writer.totalRecordCount() == 1 );
+
+  REQUIRE( QDir().rmdir(nextFilePath) );
+  writer.writeLine({"2"});
+  REQUIRE( writer.fileIndex() == 2 );
+  writer.close();
+  REQUIRE( readRotatedFile(writer, 1) == "1\n" );
+  REQUIRE( readRotatedFile(writer, 2) == "2\n" );
+}
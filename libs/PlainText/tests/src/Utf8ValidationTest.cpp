@@ -0,0 +1,155 @@
+/*
+ * Copyright Philippe Steinmann 2020 - 2020.
+ * Distributed under the Boost Software License, Version 1.0.
+ * (See accompanying file LICENSE.txt or copy at
+ * https://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/Impl/Utf8Validation.h"
+#include "Mdt/PlainText/Impl/Utf8ValidatingStreamBuffer.h"
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <iterator>
+
+using namespace Mdt::PlainText::Impl;
+
+/*
+ * Returns the offset of the first invalid sequence,
+ * or -1 if source is valid.
+ * source is validated in blocks of blockSize bytes.
+ */
+int64_t utf8ErrorOffset(const std::string & source, std::size_t blockSize)
+{
+  Utf8Validator validator;
+
+  for(std::size_t i = 0; i < source.size(); i += blockSize){
+    const std::size_t size = std::min(blockSize, source.size() - i);
+    if( !validator.validate(source.data() + i, size) ){
+      return validator.errorOffset();
+    }
+  }
+  validator.finish();
+
+  return validator.errorOffset();
+}
+
+/*
+ * Returns the chars made available by a Utf8ValidatingStreamBuffer
+ * that reads source
+ */
+std::string readValidatedInput(const std::string & source, Utf8ValidatingStreamBuffer & buffer)
+{
+  std::stringbuf sourceBuffer(source);
+  buffer.setSource(&sourceBuffer);
+
+  return std::string( std::istreambuf_iterator<char>(&buffer), std::istreambuf_iterator<char>() );
+}
+
+TEST_CASE("asciiPrefixLength")
+{
+  REQUIRE( asciiPrefixLength("", 0) == 0 );
+  REQUIRE( asciiPrefixLength("A", 1) == 1 );
+
+  const std::string ascii = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  REQUIRE( asciiPrefixLength( ascii.data(), ascii.size() ) == ascii.size() );
+  REQUIRE( isAscii( ascii.data(), ascii.size() ) );
+
+  for(std::size_t i = 0; i < ascii.size(); ++i){
+    std::string source = ascii;
+    source[i] = '\xc3';
+    REQUIRE( asciiPrefixLength( source.data(), source.size() ) == i );
+    REQUIRE( !isAscii( source.data(), source.size() ) );
+  }
+}
+
+TEST_CASE("Utf8Validator")
+{
+  const std::size_t blockSize = GENERATE(1, 2, 3, 5, 64);
+
+  SECTION("valid")
+  {
+    REQUIRE( utf8ErrorOffset("", blockSize) == -1 );
+    REQUIRE( utf8ErrorOffset("A,B\nC,D\n", blockSize) == -1 );
+    REQUIRE( utf8ErrorOffset("A,\xc3\xa9\n", blockSize) == -1 );
+    REQUIRE( utf8ErrorOffset("\xe2\x82\xac,\xf0\x9f\x98\x80", blockSize) == -1 );
+    REQUIRE( utf8ErrorOffset("\xef\xbb\xbf" "A", blockSize) == -1 );
+    REQUIRE( utf8ErrorOffset("\xed\x9f\xbf", blockSize) == -1 );
+    REQUIRE( utf8ErrorOffset("\xf4\x8f\xbf\xbf", blockSize) == -1 );
+  }
+
+  SECTION("invalid lead byte")
+  {
+    REQUIRE( utf8ErrorOffset("A\x80", blockSize) == 1 );
+    REQUIRE( utf8ErrorOffset("AB\xc0\xaf", blockSize) == 2 );
+    REQUIRE( utf8ErrorOffset("\xf5\x80\x80\x80", blockSize) == 0 );
+    REQUIRE( utf8ErrorOffset("A\xff", blockSize) == 1 );
+  }
+
+  SECTION("invalid continuation byte")
+  {
+    REQUIRE( utf8ErrorOffset("A\xc3" "A", blockSize) == 1 );
+    REQUIRE( utf8ErrorOffset("AB\xe2\x82" "A", blockSize) == 2 );
+  }
+
+  SECTION("overlong, surrogate and out of range")
+  {
+    REQUIRE( utf8ErrorOffset("\xe0\x80\xaf", blockSize) == 0 );
+    REQUIRE( utf8ErrorOffset("A\xed\xa0\x80", blockSize) == 1 );
+    REQUIRE( utf8ErrorOffset("\xf0\x80\x80\xaf", blockSize) == 0 );
+    REQUIRE( utf8ErrorOffset("\xf4\x90\x80\x80", blockSize) == 0 );
+  }
+
+  SECTION("incomplete sequence at end")
+  {
+    REQUIRE( utf8ErrorOffset("A\xc3", blockSize) == 1 );
+    REQUIRE( utf8ErrorOffset("AB\xf0\x9f\x98", blockSize) == 2 );
+  }
+}
+
+TEST_CASE("Utf8ValidatingStreamBuffer")
+{
+  Utf8ValidatingStreamBuffer buffer;
+
+  SECTION("valid")
+  {
+    REQUIRE( readValidatedInput("", buffer).empty() );
+    REQUIRE( !buffer.invalidSequenceReached() );
+    REQUIRE( readValidatedInput("A,\xc3\xa9\nB,C", buffer) == "A,\xc3\xa9\nB,C" );
+    REQUIRE( !buffer.invalidSequenceReached() );
+    REQUIRE( buffer.errorOffset() == -1 );
+  }
+
+  SECTION("the input ends at the line of the invalid sequence")
+  {
+    REQUIRE( readValidatedInput("A,B\nc,\xc3\n", buffer) == "A,B\n" );
+    REQUIRE( buffer.invalidSequenceReached() );
+    REQUIRE( buffer.errorOffset() == 6 );
+
+    REQUIRE( readValidatedInput("A\r\nB\r\xff", buffer) == "A\r\nB\r" );
+    REQUIRE( buffer.errorOffset() == 5 );
+
+    REQUIRE( readValidatedInput("\xff\nA", buffer).empty() );
+    REQUIRE( buffer.invalidSequenceReached() );
+    REQUIRE( buffer.errorOffset() == 0 );
+  }
+
+  SECTION("incomplete sequence at end")
+  {
+    REQUIRE( readValidatedInput("A\nB\xc3", buffer) == "A\n" );
+    REQUIRE( buffer.invalidSequenceReached() );
+    REQUIRE( buffer.errorOffset() == 3 );
+  }
+
+  SECTION("lines longer than a block")
+  {
+    const std::string longLine(200000, 'a');
+
+    REQUIRE( readValidatedInput(longLine, buffer) == longLine );
+    REQUIRE( !buffer.invalidSequenceReached() );
+
+    REQUIRE( readValidatedInput(longLine + "\n" + longLine + "\xc3", buffer) == longLine + "\n" );
+    REQUIRE( buffer.invalidSequenceReached() );
+    REQUIRE( buffer.errorOffset() == 400001 );
+  }
+}
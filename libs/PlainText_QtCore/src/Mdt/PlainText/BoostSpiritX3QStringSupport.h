@@ -0,0 +1,108 @@
+/****************************************************************************
+ **
+ ** MdtPlainText - A C++ library to read and write simple plain text
+ ** using the boost Spirit library.
+ **
+ ** Copyright (C) 2020-2020 Philippe Steinmann.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU Lesser General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public License
+ ** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+#ifndef MDT_PLAIN_TEXT_BOOST_SPIRIT_X3_QSTRING_SUPPORT_H
+#define MDT_PLAIN_TEXT_BOOST_SPIRIT_X3_QSTRING_SUPPORT_H
+
+#include "Mdt/PlainText/Impl/AddCodePointToQString.h"
+#include <boost/spirit/home/x3/support/traits/container_traits.hpp>
+#include <QString>
+#include <QChar>
+#include <cstdint>
+
+namespace boost { namespace spirit { namespace x3 { namespace traits{
+
+  /*! \internal Expose the container's (QString's) value_type
+   *
+   * Like for Qi, the QString's value_type is exposed as uint32_t,
+   * which is the attribute of the Grammar::Csv::X3 char parsers.
+   */
+  template<>
+  struct container_value<QString>
+  {
+    using type = uint32_t;
+  };
+
+  /*! \internal Define how to insert a new element at the end of a QString (X3)
+   */
+  template<>
+  struct push_back_container<QString>
+  {
+    static
+    bool call(QString & c, uint32_t val)
+    {
+      Mdt::PlainText::Impl::addCodePointToQString(val, c);
+
+      return true;
+    }
+  };
+
+  /*! \internal Define how to append a range at the end of a QString (X3)
+   *
+   * X3 appends the attribute of a sub-parser
+   * that was parsed into a temporary string.
+   * The range can be made of QChar (from a temporary QString)
+   * or of code points.
+   */
+  template<>
+  struct append_container<QString>
+  {
+    template<typename Iterator>
+    static
+    bool call(QString & c, Iterator first, Iterator last)
+    {
+      for(; first != last; ++first){
+        append(c, *first);
+      }
+
+      return true;
+    }
+
+   private:
+
+    static
+    void append(QString & c, QChar ch)
+    {
+      c.append(ch);
+    }
+
+    static
+    void append(QString & c, uint32_t val)
+    {
+      Mdt::PlainText::Impl::addCodePointToQString(val, c);
+    }
+  };
+
+  /*! \internal Check if a QString is empty (X3)
+   */
+  template<>
+  struct is_empty_container<QString>
+  {
+    static
+    bool call(const QString & c)
+    {
+      return c.isEmpty();
+    }
+  };
+
+}}}} // namespace boost { namespace spirit { namespace x3 { namespace traits{
+
+#endif // #ifndef MDT_PLAIN_TEXT_BOOST_SPIRIT_X3_QSTRING_SUPPORT_H
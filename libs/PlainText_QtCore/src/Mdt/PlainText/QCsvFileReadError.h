@@ -23,6 +23,7 @@
 #define MDT_PLAIN_TEXT_QCSV_FILE_READ_ERROR_H
 
 #include "QRuntimeError.h"
+#include "Mdt/PlainText/SourcePosition.h"
 #include "mdt_plaintext_qtcore_export.h"
 
 namespace Mdt{ namespace PlainText{
@@ -35,10 +36,26 @@ namespace Mdt{ namespace PlainText{
 
     /*! \brief Construct a error
      */
-    explicit QCsvFileReadError(const QString & what)
-     : QRuntimeError(what)
+    explicit QCsvFileReadError(const QString & what, const SourcePosition & position = SourcePosition())
+     : QRuntimeError(what),
+       mPosition(position)
     {
     }
+
+    /*! \brief Get the position in the file at which the reading failed
+     *
+     * This is the position at which the parser stopped,
+     * which is at or after the beginning of the record that could not be parsed.
+     * The offset is in unicode code points.
+     */
+    const SourcePosition & position() const noexcept
+    {
+      return mPosition;
+    }
+
+   private:
+
+    SourcePosition mPosition;
   };
 
 }} // namespace Mdt{ namespace PlainText{
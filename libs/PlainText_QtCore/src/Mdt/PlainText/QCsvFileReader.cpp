@@ -21,8 +21,7 @@
  ****************************************************************************/
 #include "QCsvFileReader.h"
 #include "QCsvFileReaderTemplate.h"
-#include "Mdt/PlainText/Grammar/Csv/Qi/CsvFileLine.h"
-#include "Mdt/PlainText/Grammar/Csv/Qi/CsvFile.h"
+#include "Mdt/PlainText/Grammar/Csv/Qi/CsvRecord.h"
 
 namespace Mdt{ namespace PlainText{
 
@@ -93,6 +92,13 @@ bool QCsvFileReader::atEnd() const noexcept
   return mImpl->atEnd();
 }
 
+SourcePosition QCsvFileReader::position() const noexcept
+{
+  Q_ASSERT( isOpen() );
+
+  return mImpl->position();
+}
+
 QStringList QCsvFileReader::readLine()
 {
   Q_ASSERT( isOpen() );
@@ -100,9 +106,9 @@ QStringList QCsvFileReader::readLine()
 
   using SourceIterator = QCsvFileReaderTemplate::const_iterator;
 
-  Grammar::Csv::Qi::CsvFileLine<SourceIterator, QStringList> rule( csvSettings() );
+  Grammar::Csv::Qi::CsvRecord<SourceIterator, QStringList> rule( csvSettings() );
 
-  return mImpl->readLine<QStringList>(rule);
+  return mImpl->readRecord<QStringList>(rule);
 }
 
 std::vector<QStringList> QCsvFileReader::readAll()
@@ -113,9 +119,9 @@ std::vector<QStringList> QCsvFileReader::readAll()
   using SourceIterator = QCsvFileReaderTemplate::const_iterator;
   using Table = std::vector<QStringList>;
 
-  Grammar::Csv::Qi::CsvFile<SourceIterator, Table> rule( csvSettings() );
+  Grammar::Csv::Qi::CsvRecord<SourceIterator, QStringList> rule( csvSettings() );
 
-  return mImpl->readAll<Table>(rule);
+  return mImpl->readAllRecords<Table>(rule);
 }
 
 void QCsvFileReader::close()
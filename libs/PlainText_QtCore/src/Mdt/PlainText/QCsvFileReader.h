@@ -26,6 +26,7 @@
 #include "QTextCodecNotFoundError.h"
 #include "QCsvFileReadError.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/SourcePosition.h"
 #include "mdt_plaintext_qtcore_export.h"
 #include <QString>
 #include <QStringList>
@@ -144,6 +145,18 @@ namespace Mdt{ namespace PlainText{
      */
     bool atEnd() const noexcept;
 
+    /*! \brief Get the current position in the file
+     *
+     * Called before readLine(),
+     * returns the position at which the record to read starts.
+     * The offset is in unicode code points.
+     *
+     * \pre This file reader must be open
+     * \sa isOpen()
+     * \sa QCsvFileReadError::position()
+     */
+    SourcePosition position() const noexcept;
+
     /*! \brief Read a line from the CSV file
      *
      * \exception QCsvFileReadError
@@ -20,3 +20,14 @@
  **
  ****************************************************************************/
 #include "QCsvFileReaderTemplate.h"
+
+namespace Mdt{ namespace PlainText{
+
+  namespace Grammar{ namespace Csv{ namespace Qi{
+    template struct CsvRecord<QCsvFileReaderTemplate::const_iterator, QStringList>;
+  }}} // namespace Grammar{ namespace Csv{ namespace Qi{
+
+  template QStringList QCsvFileReaderTemplate::readRecord<QStringList>(const Impl::QCsvFileReaderQiRecordRule &);
+  template Impl::QCsvFileReaderTable QCsvFileReaderTemplate::readAllRecords<Impl::QCsvFileReaderTable>(const Impl::QCsvFileReaderQiRecordRule &);
+
+}} // namespace Mdt{ namespace PlainText{
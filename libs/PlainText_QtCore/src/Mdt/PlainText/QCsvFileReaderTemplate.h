@@ -27,14 +27,23 @@
 #include "QTextCodecNotFoundError.h"
 #include "QTextFileUnicodeInputConstIterator.h"
 #include "BoostSpiritQiQStringSupport.h"
+#include "BoostSpiritX3QStringSupport.h"
 #include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/PositionTrackingIterator.h"
+#include "Mdt/PlainText/Impl/ParseRule.h"
+#include "Mdt/PlainText/Grammar/Csv/Qi/CsvRecord.h"
+#include "Mdt/PlainText/SourcePosition.h"
 #include "mdt_plaintext_qtcore_export.h"
 #include <QByteArray>
 #include <QString>
+#include <QStringList>
 #include <QObject>
 #include <QFile>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/spirit/include/support_multi_pass.hpp>
+#include <vector>
+#include <utility>
+#include <cstdint>
 
 namespace Mdt{ namespace PlainText{
 
@@ -76,6 +85,12 @@ namespace Mdt{ namespace PlainText{
    * }
    * \endcode
    *
+   * The rules can be Boost.Spirit Qi grammars, like Grammar::Csv::Qi::CsvRecord ,
+   * or Boost.Spirit X3 parsers, like Grammar::Csv::X3::CsvRecord .
+   * Both implement the same CSV grammar.
+   * The X3 parsers are fully inlined, which is generally faster
+   * to parse as well as to compile.
+   *
    * \sa QCsvFileReader
    */
   class MDT_PLAINTEXT_QTCORE_EXPORT QCsvFileReaderTemplate : public QObject
@@ -86,7 +101,7 @@ namespace Mdt{ namespace PlainText{
 
     /*! \brief STL const iterator
      */
-    using const_iterator = boost::spirit::multi_pass<QTextFileUnicodeInputConstIterator>;
+    using const_iterator = PositionTrackingIterator< boost::spirit::multi_pass<QTextFileUnicodeInputConstIterator> >;
 
     /*! \brief Construct a CSV file reader
      */
@@ -193,13 +208,19 @@ namespace Mdt{ namespace PlainText{
     {
       Q_ASSERT( !filePath().isEmpty() );
 
-      if( !mFile.open(QIODevice::ReadOnly | QIODevice::Text) ){
+      /*
+       * Not opened in QIODevice::Text mode:
+       * Qt would remove every CR, so CR line endings and CR in protected fields would be lost,
+       * and positions would not match the file.
+       * The grammar handles all end-of-lines.
+       */
+      if( !mFile.open(QIODevice::ReadOnly) ){
         const QString what = tr("open file '%1' failed").arg(filePath());
         throw QFileOpenError(what);
       }
 
       try{
-        mSourceIterator = boost::spirit::make_default_multi_pass( QTextFileUnicodeInputConstIterator(mFile, mFileEncoding) );
+        mSourceIterator = const_iterator( boost::spirit::make_default_multi_pass( QTextFileUnicodeInputConstIterator(mFile, mFileEncoding) ) );
       }catch(const QTextCodecNotFoundError & error){
         close();
         throw error;
@@ -227,7 +248,27 @@ namespace Mdt{ namespace PlainText{
       return mSourceIterator == sourceIteratorEnd();
     }
 
+    /*! \brief Get the current position in the file
+     *
+     * Once a record has been read,
+     * this is the position of the next record.
+     *
+     * \pre This file reader must be open
+     * \sa isOpen()
+     */
+    SourcePosition position() const noexcept
+    {
+      Q_ASSERT( isOpen() );
+
+      return mSourceIterator.position();
+    }
+
     /*! \brief Read a line from the CSV file
+     *
+     * \a rule must be a CSV line rule, for example Grammar::Csv::Qi::CsvFileLine .
+     *
+     * \note The maximum record length of the CSV settings is not enforced here,
+     * consider using readRecord().
      *
      * \exception QCsvFileReadError
      * \pre This file reader must be open
@@ -236,24 +277,55 @@ namespace Mdt{ namespace PlainText{
      * \sa atEnd()
      */
     template<typename Record, typename Rule>
-    Record readLine(const Rule & rule)
-    {
-      Q_ASSERT( isOpen() );
-      Q_ASSERT( !atEnd() );
+    Record readLine(const Rule & rule);
 
-      Record record;
-      const auto last = sourceIteratorEnd();
-
-      const bool ok = boost::spirit::qi::parse(mSourceIterator, last, rule, record);
-      if(!ok){
-        const QString what = tr("reading file %1 failed").arg(filePath());
-        throw QCsvFileReadError(what);
-      }
+    /*! \brief Read a record from the CSV file
+     *
+     * Parses a record using \a rule ,
+     * which must be a CSV record rule (without the end-of-line),
+     * for example Grammar::Csv::Qi::CsvRecord ,
+     * then the end-of-line that terminates it.
+     *
+     * Unlike readLine(),
+     * the maximum record length of the CSV settings is enforced.
+     *
+     * \exception QCsvFileReadError
+     * \pre This file reader must be open
+     * \pre This file reader must not be at end
+     * \sa isOpen()
+     * \sa atEnd()
+     * \sa CsvParserSettings::maximumRecordLength()
+     */
+    template<typename Record, typename Rule>
+    Record readRecord(const Rule & rule);
 
-      return record;
-    }
+    /*! \brief Read all records from the CSV file
+     *
+     * Parses the file record by record using \a rule ,
+     * which must be a CSV record rule (without the end-of-line),
+     * for example Grammar::Csv::Qi::CsvRecord .
+     *
+     * Unlike readAll(),
+     * the maximum record length of the CSV settings is enforced.
+     *
+     * \exception QCsvFileReadError
+     * \pre This file reader must be open
+     * \sa isOpen()
+     * \sa CsvParserSettings::maximumRecordLength()
+     */
+    template<typename RecordList, typename Rule>
+    RecordList readAllRecords(const Rule & rule);
 
     /*! \brief Read all lines from the CSV file
+     *
+     * \a rule must be a CSV file rule, for example Grammar::Csv::Qi::CsvFile .
+     *
+     * If a part of the file can not be parsed,
+     * a QCsvFileReadError is thrown,
+     * with the position at which the parsing stopped.
+     *
+     * \note The maximum record length of the CSV settings is not enforced here,
+     * consider using readAllRecords().
      *
      * \exception QCsvFileReadError
      * \pre This file reader must be open
@@ -262,36 +334,71 @@ namespace Mdt{ namespace PlainText{
      * \sa atEnd()
      */
     template<typename RecordList, typename Rule>
-    RecordList readAll(const Rule & rule)
+    RecordList readAll(const Rule & rule);
+
+    /*! \brief Close this file reader
+     */
+    void close()
     {
-      Q_ASSERT( isOpen() );
-      Q_ASSERT( !atEnd() );
+      mFile.close();
+    }
+
+   private:
 
-      RecordList table;
-      const auto last = sourceIteratorEnd();
+    /*
+     * Parse a record using rule,
+     * then the end-of-line that terminates it (or the end of the file).
+     * Returns false if one of both fails.
+     *
+     * Like Grammar::Csv::Qi::CsvFile ,
+     * a empty line at the end of the file is accepted.
+     *
+     * If a maximum record length is defined,
+     * rule can not consume more chars than this length.
+     * A longer record then fails because it is not followed by a end-of-line.
+     */
+    template<typename Rule, typename Record>
+    bool parseRecord(const Rule & rule, Record & record)
+    {
+      namespace qi = boost::spirit::qi;
 
-      const bool ok = boost::spirit::qi::parse(mSourceIterator, last, rule, table);
-      if(!ok){
-        const QString what = tr("reading file %1 failed").arg(filePath());
-        throw QCsvFileReadError(what);
+      if( !Impl::parseRule(mSourceIterator, recordEnd(), rule, record) ){
+        return false;
       }
 
-      return table;
+      return qi::parse(mSourceIterator, sourceIteratorEnd(), ( qi::eol >> -(qi::eol >> qi::eoi) ) | qi::eoi);
     }
 
-    /*! \brief Close this file reader
+    /*
+     * Get the end iterator for the record that begins at the current position
      */
-    void close()
+    const_iterator recordEnd() const
     {
-      mFile.close();
+      const int64_t maxLength = mCsvSettings.maximumRecordLength();
+
+      if(maxLength > 0){
+        return const_iterator::boundedEnd( sourceIteratorEnd().base(), mSourceIterator.position().offset() + maxLength );
+      }
+
+      return sourceIteratorEnd();
     }
 
-   private:
+    QCsvFileReadError readError() const
+    {
+      const SourcePosition pos = mSourceIterator.position();
+      const QString what = tr("reading file %1 failed at line %2, column %3 (offset %4)")
+                           .arg( filePath() )
+                           .arg( pos.lineNumber() )
+                           .arg( pos.columnNumber() )
+                           .arg( pos.offset() );
+
+      return QCsvFileReadError(what, pos);
+    }
 
     static
     const_iterator sourceIteratorEnd() noexcept
     {
-      return boost::spirit::make_default_multi_pass( QTextFileUnicodeInputConstIterator() );
+      return const_iterator( boost::spirit::make_default_multi_pass( QTextFileUnicodeInputConstIterator() ) );
     }
 
     const_iterator mSourceIterator;
@@ -300,6 +407,98 @@ namespace Mdt{ namespace PlainText{
     CsvParserSettings mCsvSettings;
   };
 
+  /*
+   * The read methods are not defined inline,
+   * so that the explicit instantiation declarations below
+   * also prevent optimizing compilers from instantiating them.
+   */
+
+  template<typename Record, typename Rule>
+  Record QCsvFileReaderTemplate::readLine(const Rule & rule)
+  {
+    Q_ASSERT( isOpen() );
+    Q_ASSERT( !atEnd() );
+
+    Record record;
+    const auto last = sourceIteratorEnd();
+
+    const bool ok = Impl::parseRule(mSourceIterator, last, rule, record);
+    if(!ok){
+      throw readError();
+    }
+
+    return record;
+  }
+
+  template<typename Record, typename Rule>
+  Record QCsvFileReaderTemplate::readRecord(const Rule & rule)
+  {
+    Q_ASSERT( isOpen() );
+    Q_ASSERT( !atEnd() );
+
+    Record record;
+    if( !parseRecord(rule, record) ){
+      throw readError();
+    }
+
+    return record;
+  }
+
+  template<typename RecordList, typename Rule>
+  RecordList QCsvFileReaderTemplate::readAllRecords(const Rule & rule)
+  {
+    Q_ASSERT( isOpen() );
+
+    using Record = typename RecordList::value_type;
+
+    RecordList table;
+
+    while( !atEnd() ){
+      Record record;
+      if( !parseRecord(rule, record) ){
+        throw readError();
+      }
+      table.push_back( std::move(record) );
+    }
+
+    return table;
+  }
+
+  template<typename RecordList, typename Rule>
+  RecordList QCsvFileReaderTemplate::readAll(const Rule & rule)
+  {
+    Q_ASSERT( isOpen() );
+    Q_ASSERT( !atEnd() );
+
+    RecordList table;
+    const auto last = sourceIteratorEnd();
+
+    const bool ok = Impl::parseRule(mSourceIterator, last, rule, table);
+    if( !ok || !atEnd() ){
+      throw readError();
+    }
+
+    return table;
+  }
+
+  namespace Impl{
+
+    using QCsvFileReaderTable = std::vector<QStringList>;
+    using QCsvFileReaderQiRecordRule = Grammar::Csv::Qi::CsvRecord<QCsvFileReaderTemplate::const_iterator, QStringList>;
+
+  } // namespace Impl{
+
+  /*
+   * Instantiated once in the library for QStringList records,
+   * so that they are not compiled again by each user.
+   */
+  namespace Grammar{ namespace Csv{ namespace Qi{
+    extern template struct MDT_PLAINTEXT_QTCORE_EXPORT CsvRecord<QCsvFileReaderTemplate::const_iterator, QStringList>;
+  }}} // namespace Grammar{ namespace Csv{ namespace Qi{
+
+  extern template QStringList QCsvFileReaderTemplate::readRecord<QStringList>(const Impl::QCsvFileReaderQiRecordRule &);
+  extern template Impl::QCsvFileReaderTable QCsvFileReaderTemplate::readAllRecords<Impl::QCsvFileReaderTable>(const Impl::QCsvFileReaderQiRecordRule &);
+
 }} // namespace Mdt{ namespace PlainText{
 
 #endif // #ifndef MDT_PLAIN_TEXT_QCSV_FILE_READER_TEMPLATE_H
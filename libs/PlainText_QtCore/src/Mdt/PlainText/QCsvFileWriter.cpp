@@ -29,6 +29,26 @@
 
 namespace Mdt{ namespace PlainText{
 
+/*
+ * Building the Karma grammars is expensive compared to generating a record.
+ * They are built once in open(), then reused by each writeLine(), writeLines() and writeTable(),
+ * which is possible because the settings cannot change while the writer is open.
+ */
+struct QCsvFileWriter::Generators
+{
+  using DestinationIterator = QCsvFileWriterTemplate::iterator;
+  using TableView = ContainerAliasView<std::vector<QStringList>, QStringListUnicodeView>;
+
+  explicit Generators(const CsvGeneratorSettings & settings) noexcept
+   : recordRule(settings),
+     tableRule(settings)
+  {
+  }
+
+  Grammar::Csv::Karma::CsvRecord<DestinationIterator, QStringListUnicodeView> recordRule;
+  Grammar::Csv::Karma::CsvFile<DestinationIterator, TableView> tableRule;
+};
+
 QCsvFileWriter::QCsvFileWriter()
  : mImpl( std::make_unique<QCsvFileWriterTemplate>() )
 {
@@ -89,11 +109,24 @@ FileWriteOpenMode QCsvFileWriter::openMode() const noexcept
   return mImpl->openMode();
 }
 
+void QCsvFileWriter::setDurabilityPolicy(const FileDurabilityPolicy & policy) noexcept
+{
+  assert( !isOpen() );
+
+  mImpl->setDurabilityPolicy(policy);
+}
+
+const FileDurabilityPolicy & QCsvFileWriter::durabilityPolicy() const noexcept
+{
+  return mImpl->durabilityPolicy();
+}
+
 void QCsvFileWriter::open()
 {
   assert( !filePath().isEmpty() );
 
   mImpl->open();
+  mGenerators = std::make_unique<Generators>( csvSettings() );
 }
 
 bool QCsvFileWriter::isOpen() const
@@ -104,24 +137,31 @@ bool QCsvFileWriter::isOpen() const
 void QCsvFileWriter::writeLine(const QStringList & record)
 {
   assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
 
-  using DestinationIterator = QCsvFileWriterTemplate::iterator;
-
-  Grammar::Csv::Karma::CsvRecord<DestinationIterator, QStringListUnicodeView> rule( csvSettings() );
   QStringListUnicodeView recordView(record);
-  mImpl->writeLine(recordView, rule);
+  mImpl->writeLine(recordView, mGenerators->recordRule);
 }
 
 void QCsvFileWriter::writeTable(const std::vector<QStringList> & table)
 {
   assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
 
-  using DestinationIterator = QCsvFileWriterTemplate::iterator;
-  using TableView = ContainerAliasView<std::vector<QStringList>, QStringListUnicodeView>;
+  Generators::TableView tableView(table);
+  mImpl->writeTable(tableView, mGenerators->tableRule);
+}
+
+void QCsvFileWriter::writeLines(std::vector<QStringList>::const_iterator first, std::vector<QStringList>::const_iterator last)
+{
+  assert( isOpen() );
+  assert( mGenerators.get() != nullptr );
 
-  Grammar::Csv::Karma::CsvFile<DestinationIterator, TableView> rule( csvSettings() );
-  TableView tableView(table);
-  mImpl->writeLine(tableView, rule);
+  if(first == last){
+    return;
+  }
+  Generators::TableView tableView(first, last);
+  mImpl->writeTable(tableView, mGenerators->tableRule);
 }
 
 void QCsvFileWriter::close()
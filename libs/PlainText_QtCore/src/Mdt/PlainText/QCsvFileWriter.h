@@ -26,6 +26,7 @@
 #include "QCsvFileWriteError.h"
 #include "Mdt/PlainText/CsvGeneratorSettings.h"
 #include "Mdt/PlainText/FileWriteOpenMode.h"
+#include "Mdt/PlainText/FileDurabilityPolicy.h"
 #include "mdt_plaintext_qtcore_export.h"
 #include <QString>
 #include <QStringList>
@@ -121,6 +122,18 @@ namespace Mdt{ namespace PlainText{
      */
     FileWriteOpenMode openMode() const noexcept;
 
+    /*! \brief Set the durability policy
+     *
+     * \sa QCsvFileWriterTemplate::setDurabilityPolicy()
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setDurabilityPolicy(const FileDurabilityPolicy & policy) noexcept;
+
+    /*! \brief Get the durability policy
+     */
+    const FileDurabilityPolicy & durabilityPolicy() const noexcept;
+
     /*! \brief Open this CSV file writer
      *
      * If this file writer is allready open,
@@ -128,6 +141,9 @@ namespace Mdt{ namespace PlainText{
      *
      * Open the file set with setFilePath().
      *
+     * The generators used by writeLine() and writeTable()
+     * are built here, once for the current CSV settings.
+     *
      * \exception FileOpenError
      * \pre A path to a file must have been set
      * \sa setFilePath()
@@ -157,13 +173,43 @@ namespace Mdt{ namespace PlainText{
      */
     void writeTable(const std::vector<QStringList> & table);
 
+    /*! \brief Write the records in the range [\a first, \a last) to this CSV file
+     *
+     * This is the batch version of writeLine():
+     * the records are generated in one go, like with writeTable(),
+     * but the whole table does not have to be in memory.
+     * For example, a large export can be done by filling
+     * and writing the same batch of records many times:
+     * \code
+     * std::vector<QStringList> batch;
+     *
+     * while( fetchRecords(batch, 1000) ){
+     *   csvWriter.writeLines( batch.cbegin(), batch.cend() );
+     * }
+     * \endcode
+     *
+     * Like writeTable(), empty records are skipped,
+     * but at least one record must be written.
+     * If the range is empty, nothing is written.
+     *
+     * \exception QCsvFileWriteError
+     * \pre This file writer must be open
+     * \sa isOpen()
+     */
+    void writeLines(std::vector<QStringList>::const_iterator first, std::vector<QStringList>::const_iterator last);
+
     /*! \brief Close this file writer
+     *
+     * \exception QCsvFileWriteError
      */
     void close();
 
    private:
 
+    struct Generators;
+
     std::unique_ptr<QCsvFileWriterTemplate> mImpl;
+    std::unique_ptr<Generators> mGenerators;
   };
 
 }} // namespace Mdt{ namespace PlainText{
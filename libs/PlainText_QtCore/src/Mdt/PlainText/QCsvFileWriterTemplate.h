@@ -28,12 +28,21 @@
 #include "BoostSpiritKarmaQStringSupport.h"
 #include "Mdt/PlainText/CsvGeneratorSettings.h"
 #include "Mdt/PlainText/FileWriteOpenMode.h"
+#include "Mdt/PlainText/FileDurabilityPolicy.h"
+#include "Mdt/PlainText/FileWriteError.h"
+#include "Mdt/PlainText/Impl/GroupCommit.h"
+#include "Mdt/PlainText/Impl/FileSync.h"
 #include "mdt_plaintext_qtcore_export.h"
 #include <boost/spirit/include/karma.hpp>
 #include <QObject>
 #include <QString>
 #include <QByteArray>
 #include <QFile>
+#include <QFileDevice>
+#include <QSaveFile>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <cassert>
 
 namespace Mdt{ namespace PlainText{
@@ -97,10 +106,20 @@ namespace Mdt{ namespace PlainText{
     }
 
     /*! \brief Cleanup this CSV file writer
+     *
+     * Errors are ignored.
+     * Call close() explicitly to get them reported.
+     *
+     * With FileDurability::AtomicReplace ,
+     * the file is not replaced.
      */
-    ~QCsvFileWriterTemplate()
+    ~QCsvFileWriterTemplate() noexcept
     {
-      close();
+      try{
+        mSaveFile.reset();
+        close();
+      }catch(...){
+      }
     }
 
     QCsvFileWriterTemplate(const QCsvFileWriterTemplate &) = delete;
@@ -198,6 +217,30 @@ namespace Mdt{ namespace PlainText{
       return mOpenMode;
     }
 
+    /*! \brief Set the durability policy
+     *
+     * Works like CsvFileWriterTemplate::setDurabilityPolicy(),
+     * except that FileDurability::AtomicReplace uses a QSaveFile.
+     *
+     * The default is FileDurability::None
+     *
+     * \pre This file writer must not be open
+     * \sa isOpen()
+     */
+    void setDurabilityPolicy(const FileDurabilityPolicy & policy) noexcept
+    {
+      assert( !isOpen() );
+
+      mDurabilityPolicy = policy;
+    }
+
+    /*! \brief Get the durability policy
+     */
+    const FileDurabilityPolicy & durabilityPolicy() const noexcept
+    {
+      return mDurabilityPolicy;
+    }
+
     /*! \brief Open this CSV file writer
      *
      * If this file writer is allready open,
@@ -214,6 +257,13 @@ namespace Mdt{ namespace PlainText{
     {
       assert( !filePath().isEmpty() );
 
+      close();
+
+      if( mDurabilityPolicy.durability() == FileDurability::AtomicReplace ){
+        openSaveFile();
+        return;
+      }
+
       QIODevice::OpenMode openMode;
       switch(mOpenMode){
         case FileWriteOpenMode::Append:
@@ -230,6 +280,14 @@ namespace Mdt{ namespace PlainText{
       }
 
       mFileIterator = iterator(mFile, mFileEncoding);
+
+      if( mDurabilityPolicy.durability() == FileDurability::GroupCommit ){
+        const int fileDescriptor = mFile.handle();
+        const std::string path = filePath().toLocal8Bit().toStdString();
+        mGroupCommit.start(mDurabilityPolicy, [fileDescriptor, path](){
+          Impl::syncFileDescriptor(fileDescriptor, path);
+        });
+      }
     }
 
     /*! \brief Check if this file writer is open
@@ -238,6 +296,9 @@ namespace Mdt{ namespace PlainText{
      */
     bool isOpen() const
     {
+      if( mSaveFile ){
+        return mSaveFile->isOpen();
+      }
       return mFile.isOpen();
     }
 
@@ -257,6 +318,7 @@ namespace Mdt{ namespace PlainText{
         const QString what = tr("writing a line in file '%1' failed").arg(filePath());
         throw QCsvFileWriteError(what);
       }
+      commitIfDue(1);
     }
 
     /*! \brief Write a table to this CSV file
@@ -275,22 +337,150 @@ namespace Mdt{ namespace PlainText{
         const QString what = tr("writing table in file '%1' failed").arg(filePath());
         throw QCsvFileWriteError(what);
       }
+      commitIfDue( static_cast<int64_t>( table.size() ) );
     }
 
     /*! \brief Close this file writer
+     *
+     * Pending data are written to the file before closing it.
+     * Then, the durability policy is applied.
+     *
+     * \exception QCsvFileWriteError
+     * \sa setDurabilityPolicy()
      */
     void close()
     {
-      mFile.close();
+      if( !isOpen() ){
+        return;
+      }
+
+      switch( mDurabilityPolicy.durability() ){
+        case FileDurability::None:
+          mFile.close();
+          break;
+        case FileDurability::SyncOnClose:
+          syncAndCloseFile();
+          break;
+        case FileDurability::GroupCommit:
+          stopGroupCommitAndCloseFile();
+          break;
+        case FileDurability::AtomicReplace:
+          commitSaveFile();
+          break;
+      }
     }
 
    private:
 
+    /*
+     * QFile has its own buffer, which is written to the file
+     * before the commit, so that the background thread syncs
+     * all records written so far
+     */
+    void commitIfDue(int64_t recordCount)
+    {
+      if( !mGroupCommit.isStarted() ){
+        return;
+      }
+      if( mGroupCommit.recordsWritten(recordCount) ){
+        flushDevice(mFile);
+        try{
+          mGroupCommit.commit();
+        }catch(const FileWriteError & error){
+          throw QCsvFileWriteError( QString::fromLocal8Bit( error.what() ) );
+        }
+      }
+    }
+
+    void flushDevice(QFileDevice & device)
+    {
+      if( !device.flush() ){
+        const QString what = tr("writing to file '%1' failed: '%2'")
+                             .arg( filePath(), device.errorString() );
+        throw QCsvFileWriteError(what);
+      }
+    }
+
+    void syncDevice(QFileDevice & device)
+    {
+      flushDevice(device);
+      try{
+        Impl::syncFileDescriptor( device.handle(), filePath().toLocal8Bit().toStdString() );
+      }catch(const FileWriteError & error){
+        throw QCsvFileWriteError( QString::fromLocal8Bit( error.what() ) );
+      }
+    }
+
+    /*
+     * The file is closed even if syncing failed
+     */
+    void syncAndCloseFile()
+    {
+      try{
+        syncDevice(mFile);
+      }catch(...){
+        mFile.close();
+        throw;
+      }
+      mFile.close();
+    }
+
+    void stopGroupCommitAndCloseFile()
+    {
+      QString error;
+      try{
+        mGroupCommit.stop();
+      }catch(const FileWriteError & groupCommitError){
+        error = QString::fromLocal8Bit( groupCommitError.what() );
+      }
+      syncAndCloseFile();
+      if( !error.isEmpty() ){
+        throw QCsvFileWriteError(error);
+      }
+    }
+
+    void openSaveFile()
+    {
+      auto saveFile = std::make_unique<QSaveFile>( filePath() );
+      if( !saveFile->open(QIODevice::WriteOnly) ){
+        const QString what = tr("open file '%1' failed").arg(filePath());
+        throw QFileOpenError(what);
+      }
+      mFileIterator = iterator(*saveFile, mFileEncoding);
+      mSaveFile = std::move(saveFile);
+    }
+
+    /*
+     * If anything fails, the QSaveFile is destroyed without commit,
+     * so it removes its temporary file and the file is left unchanged.
+     *
+     * QSaveFile::commit() also syncs the temporary file, but ignores errors,
+     * and does not sync the directory after the rename,
+     * like Impl::replaceFile() does.
+     */
+    void commitSaveFile()
+    {
+      assert( mSaveFile );
+
+      std::unique_ptr<QSaveFile> saveFile = std::move(mSaveFile);
+      mFileIterator = iterator();
+      syncDevice(*saveFile);
+      if( !saveFile->commit() ){
+        const QString what = tr("replacing file '%1' failed: '%2'")
+                             .arg( filePath(), saveFile->errorString() );
+        throw QCsvFileWriteError(what);
+      }
+      Impl::syncParentDirectory( filePath().toLocal8Bit().toStdString() );
+    }
+
     iterator mFileIterator;
     QFile mFile;
+    std::unique_ptr<QSaveFile> mSaveFile;
+    Impl::GroupCommit mGroupCommit;
     QByteArray mFileEncoding = "UTF-8";
     CsvGeneratorSettings mCsvSettings;
     FileWriteOpenMode mOpenMode = FileWriteOpenMode::Append;
+    FileDurabilityPolicy mDurabilityPolicy;
   };
 
 }} // namespace Mdt{ namespace PlainText{
@@ -21,6 +21,7 @@
  ****************************************************************************/
 #include "QTextFileInputConstIteratorSharedData.h"
 #include "QFileReadError.h"
+#include "Mdt/PlainText/Impl/Utf8Validation.h"
 #include <QTextCodec>
 #include <QCoreApplication>
 
@@ -104,6 +105,8 @@ QTextFileInputConstIteratorSharedData::QTextFileInputConstIteratorSharedData(QFi
   mDecoder.reset( codec->makeDecoder() );
   assert( mDecoder.get() != nullptr );
 
+  mIsAsciiCompatibleCodec = isAsciiCompatibleCodec(*codec);
+
   readMore();
   mCurrentPos = mUnicodeBuffer.cbegin();
 }
@@ -115,7 +118,54 @@ void QTextFileInputConstIteratorSharedData::readMore()
   assert( mRawDataBuffer.empty() );
   assert( mUnicodeBuffer.isEmpty() );
 
-  Impl::readFromFileAndDecode(*mFile, mFile->fileName(), *mDecoder, mRawDataBuffer, mUnicodeBuffer);
+  /*
+   * Same as Impl::readFromFileAndDecode(),
+   * but blocks of ASCII chars are converted without the decoder when possible
+   */
+  while( mUnicodeBuffer.isEmpty() ){
+    const int n = Impl::readFromFile(*mFile, mFile->fileName(), mRawDataBuffer);
+    if(n < 1){
+      return;
+    }
+    if( canSkipDecoder() ){
+      mUnicodeBuffer = QString::fromLatin1( mRawDataBuffer.data(), n );
+    }else{
+      Impl::decodeToUnicodeBuffer(*mDecoder, mRawDataBuffer, mUnicodeBuffer);
+      mDecoderWasUsed = true;
+    }
+    mRawDataBuffer.clear();
+  }
+}
+
+/*
+ * For a codec that maps ASCII chars to the same code points,
+ * a block of ASCII chars can be converted directly.
+ *
+ * The decoder must have processed the beginning of the file
+ * (for example to remove a BOM),
+ * and must not wait for the rest of a multi-byte sequence.
+ */
+bool QTextFileInputConstIteratorSharedData::canSkipDecoder() const noexcept
+{
+  if( !mIsAsciiCompatibleCodec || !mDecoderWasUsed || mDecoder->needsMoreData() ){
+    return false;
+  }
+
+  return Impl::isAscii( mRawDataBuffer.data(), mRawDataBuffer.size() );
+}
+
+bool QTextFileInputConstIteratorSharedData::isAsciiCompatibleCodec(const QTextCodec & codec) noexcept
+{
+  switch( codec.mibEnum() ){
+    case 3:     // US-ASCII
+    case 4:     // ISO-8859-1
+    case 106:   // UTF-8
+      return true;
+    default:
+      break;
+  }
+
+  return false;
 }
 
 }} // namespace Mdt{ namespace PlainText{
@@ -29,6 +29,7 @@
 #include <QByteArray>
 #include <QString>
 #include <QTextDecoder>
+#include <QTextCodec>
 #include <QPointer>
 #include <memory>
 #include <vector>
@@ -152,7 +153,13 @@ namespace Mdt{ namespace PlainText{
     }
 
     void readMore();
+    bool canSkipDecoder() const noexcept;
 
+    static
+    bool isAsciiCompatibleCodec(const QTextCodec & codec) noexcept;
+
+    bool mIsAsciiCompatibleCodec = false;
+    bool mDecoderWasUsed = false;
     QString::const_iterator mCurrentPos;
     QString mUnicodeBuffer;
     std::vector<char> mRawDataBuffer;
@@ -43,7 +43,16 @@ QTextFileOutputIteratorImpl::QTextFileOutputIteratorImpl(QFileDevice & file, con
     throw QTextCodecNotFoundError(what);
   }
 
-  mEncoder.reset( codec->makeEncoder() );
+  /*
+   * Some codecs (like UTF-8) write a BOM before the first char.
+   * When appending to a existing file,
+   * that would put a BOM in the middle of it.
+   */
+  QTextCodec::ConversionFlags conversionFlags = QTextCodec::DefaultConversion;
+  if(file.size() > 0){
+    conversionFlags |= QTextCodec::IgnoreHeader;
+  }
+  mEncoder.reset( codec->makeEncoder(conversionFlags) );
   assert( mEncoder.get() != nullptr );
 
 }
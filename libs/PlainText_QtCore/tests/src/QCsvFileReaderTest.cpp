@@ -169,6 +169,170 @@ TEST_CASE("readAll")
     REQUIRE( tableMatches(reader.readAll(), referenceTable) );
     REQUIRE( reader.atEnd() );
   }
+
+  SECTION("CR and CRLF end-of-lines")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\rc,\"d\re\"\r\nf,g")) );
+    file.close();
+
+    reader.open();
+    REQUIRE( !reader.atEnd() );
+
+    referenceTable = {
+      {"A","B"},
+      {"c","d\re"},
+      {"f","g"}
+    };
+    REQUIRE( tableMatches(reader.readAll(), referenceTable) );
+    REQUIRE( reader.atEnd() );
+  }
+}
+
+TEST_CASE("position")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+  REQUIRE( writeTextFile(file, QString::fromUtf8("é,B\r\n\"c\nö\",e\nf,g")) );
+  file.close();
+
+  QCsvFileReader reader;
+  setFilePathToReader(file, reader);
+  reader.open();
+
+  REQUIRE( reader.position().offset() == 0 );
+  REQUIRE( reader.position().lineNumber() == 1 );
+
+  // The offset is in unicode code points, not in bytes
+  reader.readLine();
+  REQUIRE( reader.position().offset() == 5 );
+  REQUIRE( reader.position().lineNumber() == 2 );
+  REQUIRE( reader.position().columnNumber() == 1 );
+
+  reader.readLine();
+  REQUIRE( reader.position().offset() == 13 );
+  REQUIRE( reader.position().lineNumber() == 4 );
+  REQUIRE( reader.position().columnNumber() == 1 );
+}
+
+TEST_CASE("readAll_error")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+  REQUIRE( writeTextFile(file, QString::fromUtf8("A,B\nc,ö\n\"e\"f,g\nh,i")) );
+  file.close();
+
+  QCsvFileReader reader;
+  setFilePathToReader(file, reader);
+  reader.open();
+
+  try{
+    reader.readAll();
+    FAIL("readAll() did not throw");
+  }catch(const QCsvFileReadError & error){
+    REQUIRE( error.position().lineNumber() == 3 );
+    REQUIRE( error.position().columnNumber() == 4 );
+    REQUIRE( error.position().offset() == 11 );
+  }
+}
+
+TEST_CASE("readAll_limits")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+
+  CsvParserSettings csvSettings;
+  QCsvFileReader reader;
+  setFilePathToReader(file, reader);
+
+  SECTION("unterminated protected field")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\n\"c,d\ne,f\ng,h")) );
+    file.close();
+
+    csvSettings.setMaximumFieldLength(4);
+    reader.setCsvSettings(csvSettings);
+    reader.open();
+
+    try{
+      reader.readAll();
+      FAIL("readAll() did not throw");
+    }catch(const QCsvFileReadError & error){
+      REQUIRE( error.position().lineNumber() == 2 );
+    }
+  }
+
+  SECTION("maximum record length")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\nc,d\r\nef,g")) );
+    file.close();
+
+    csvSettings.setMaximumRecordLength(3);
+    reader.setCsvSettings(csvSettings);
+    reader.open();
+
+    try{
+      reader.readAll();
+      FAIL("readAll() did not throw");
+    }catch(const QCsvFileReadError & error){
+      REQUIRE( error.position().lineNumber() == 3 );
+    }
+  }
+
+  SECTION("maximum column count")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\nc,d,e")) );
+    file.close();
+
+    csvSettings.setMaximumColumnCount(2);
+    reader.setCsvSettings(csvSettings);
+    reader.open();
+
+    REQUIRE( recordMatches(reader.readLine(), {"A","B"}) );
+    REQUIRE_THROWS_AS( reader.readLine(), QCsvFileReadError );
+  }
+
+  SECTION("maximum record length with readLine()")
+  {
+    REQUIRE( writeTextFile(file, QString::fromUtf8("é,B\r\nc,dé")) );
+    file.close();
+
+    csvSettings.setMaximumRecordLength(3);
+    reader.setCsvSettings(csvSettings);
+    reader.open();
+
+    // The length is in unicode code points, not in bytes
+    REQUIRE( recordMatches(reader.readLine(), {"é","B"}) );
+    REQUIRE_THROWS_AS( reader.readLine(), QCsvFileReadError );
+  }
+}
+
+TEST_CASE("readAll_endOfLineAtEnd")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+
+  QCsvFileReader reader;
+  setFilePathToReader(file, reader);
+
+  SECTION("A,B\\n")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\n")) );
+    file.close();
+
+    reader.open();
+    REQUIRE( tableMatches(reader.readAll(), {{"A","B"}}) );
+    REQUIRE( reader.atEnd() );
+  }
+
+  SECTION("A,B\\r\\nc,d\\r\\n\\r\\n")
+  {
+    REQUIRE( writeTextFile(file, QLatin1String("A,B\r\nc,d\r\n\r\n")) );
+    file.close();
+
+    reader.open();
+    REQUIRE( tableMatches(reader.readAll(), {{"A","B"},{"c","d"}}) );
+    REQUIRE( reader.atEnd() );
+  }
 }
 
 TEST_CASE("Test files")
@@ -257,3 +257,160 @@ TEST_CASE("writeTable")
     REQUIRE( fileData == QString::fromUtf8("A𐐅 C,\"D,é\"\n79,34𝛀 56\n") );
   }
 }
+
+TEST_CASE("writeLines")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  QCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  writer.setFilePath(filePath);
+  writer.open();
+
+  const std::vector<QStringList> table = qStringTableFromStdStringTable({{"A","B"},{"c,d","é"},{"1","2"}});
+  QString fileData;
+
+  SECTION("empty range")
+  {
+    writer.writeLines( table.cbegin(), table.cbegin() );
+    writer.close();
+    fileData = readTextFile(filePath);
+    REQUIRE( fileData.isEmpty() );
+  }
+
+  SECTION("2 batches")
+  {
+    writer.writeLines( table.cbegin(), table.cbegin() + 2 );
+    writer.writeLines( table.cbegin() + 2, table.cend() );
+    writer.close();
+    fileData = readTextFile(filePath);
+    REQUIRE( fileData == QString::fromUtf8("A,B\n\"c,d\",é\n1,2\n") );
+  }
+
+  SECTION("empty record in the range")
+  {
+    const std::vector<QStringList> tableWithEmptyRecord = qStringTableFromStdStringTable({{"A","B"},{},{"1","2"}});
+    writer.writeLines( tableWithEmptyRecord.cbegin(), tableWithEmptyRecord.cend() );
+    writer.close();
+    fileData = readTextFile(filePath);
+    REQUIRE( fileData == QString::fromUtf8("A,B\n1,2\n") );
+  }
+}
+
+TEST_CASE("writeLine_settingsChangedBetweenOpen")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  QCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+  writer.setFilePath(filePath);
+
+  writer.open();
+  writer.writeLine( qStringListFromStdStringList({"A","b;c"}) );
+  writer.close();
+
+  csvSettings.setFieldSeparator(';');
+  writer.setCsvSettings(csvSettings);
+  writer.setOpenMode(FileWriteOpenMode::Append);
+
+  writer.open();
+  writer.writeLine( qStringListFromStdStringList({"A","b;c"}) );
+  writer.close();
+
+  REQUIRE( readTextFile(filePath) == QLatin1String("A,b;c\nA;\"b;c\"\n") );
+}
+
+TEST_CASE("durabilityPolicy")
+{
+  QCsvFileWriter writer;
+  REQUIRE( writer.durabilityPolicy().durability() == FileDurability::None );
+
+  FileDurabilityPolicy policy;
+  policy.setDurability(FileDurability::SyncOnClose);
+  writer.setDurabilityPolicy(policy);
+  REQUIRE( writer.durabilityPolicy().durability() == FileDurability::SyncOnClose );
+}
+
+TEST_CASE("durability")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  CsvGeneratorSettings csvSettings;
+  csvSettings.setEndOfLine(EndOfLine::Lf);
+
+  const QString filePath = filePathFromDirAndFileName(dir, "file.csv");
+
+  FileDurabilityPolicy policy;
+
+  QCsvFileWriter writer;
+  writer.setCsvSettings(csvSettings);
+  writer.setOpenMode(FileWriteOpenMode::Truncate);
+  writer.setFilePath(filePath);
+
+  SECTION("SyncOnClose")
+  {
+    policy.setDurability(FileDurability::SyncOnClose);
+    writer.setDurabilityPolicy(policy);
+    writer.open();
+    writer.writeLine( qStringListFromStdStringList({"A","é"}) );
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+    REQUIRE( readTextFile(filePath) == QString::fromUtf8("A,é\n") );
+  }
+
+  SECTION("GroupCommit")
+  {
+    policy.setDurability(FileDurability::GroupCommit);
+    policy.setGroupCommitRecordCount(2);
+    writer.setDurabilityPolicy(policy);
+
+    const std::vector<QStringList> table = qStringTableFromStdStringTable({{"1"},{"2"},{"3"}});
+    writer.open();
+    writer.writeLine( qStringListFromStdStringList({"A"}) );
+    writer.writeLine( qStringListFromStdStringList({"B"}) );
+    writer.writeLine( qStringListFromStdStringList({"C"}) );
+    writer.writeTable(table);
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+    REQUIRE( readTextFile(filePath) == QLatin1String("A\nB\nC\n1\n2\n3\n") );
+  }
+
+  SECTION("AtomicReplace")
+  {
+    REQUIRE( writeTextFile(filePath, QLatin1String("old")) );
+    policy.setDurability(FileDurability::AtomicReplace);
+    writer.setDurabilityPolicy(policy);
+    writer.open();
+    REQUIRE( writer.isOpen() );
+    writer.writeLine( qStringListFromStdStringList({"A","B"}) );
+    REQUIRE( readTextFile(filePath) == QLatin1String("old") );
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+    REQUIRE( readTextFile(filePath) == QLatin1String("A,B\n") );
+  }
+
+  SECTION("AtomicReplace without close")
+  {
+    REQUIRE( writeTextFile(filePath, QLatin1String("old")) );
+    policy.setDurability(FileDurability::AtomicReplace);
+    {
+      QCsvFileWriter otherWriter;
+      otherWriter.setDurabilityPolicy(policy);
+      otherWriter.setFilePath(filePath);
+      otherWriter.open();
+      otherWriter.writeLine( qStringListFromStdStringList({"A","B"}) );
+    }
+    REQUIRE( readTextFile(filePath) == QLatin1String("old") );
+  }
+}
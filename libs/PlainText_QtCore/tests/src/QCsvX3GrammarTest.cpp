@@ -0,0 +1,181 @@
+/****************************************************************************
+ **
+ ** MdtPlainText - A C++ library to read and write simple plain text
+ ** using the boost Spirit library.
+ **
+ ** Copyright (C) 2020-2020 Philippe Steinmann.
+ **
+ ** This program is free software: you can redistribute it and/or modify
+ ** it under the terms of the GNU Lesser General Public License as published by
+ ** the Free Software Foundation, either version 3 of the License, or
+ ** (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ ** GNU Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public License
+ ** along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ **
+ ****************************************************************************/
+#include "catch2/catch.hpp"
+#include "Mdt/PlainText/TestLib/ContainerCompare.h"
+#include "Mdt/PlainText/TestLib/TextFileUtils.h"
+#include "Mdt/PlainText/QCsvFileReaderTemplate.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/FieldColumn.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvRecord.h"
+#include "Mdt/PlainText/Grammar/Csv/X3/CsvFile.h"
+#include "Mdt/PlainText/QStringUnicodeConstIterator.h"
+#include "Mdt/PlainText/BoostSpiritX3QStringSupport.h"
+#include "Mdt/PlainText/CsvParserSettings.h"
+#include "Mdt/PlainText/QRuntimeError.h"
+#include <boost/spirit/home/x3.hpp>
+#include <QString>
+#include <QStringList>
+#include <QLatin1String>
+#include <QTemporaryFile>
+#include <vector>
+
+using namespace Mdt::PlainText;
+using namespace Mdt::PlainText::TestLib;
+
+using StringTable = std::vector<QStringList>;
+
+/*
+ * The whole source must be consumed
+ */
+template<typename Parser, typename Attribute>
+Attribute parseAll(const QString & sourceString, const CsvParserSettings & settings)
+{
+  Q_ASSERT( settings.isValid() );
+
+  Attribute attribute;
+  const Parser parser(settings);
+
+  QStringUnicodeConstIterator first( sourceString.cbegin(), sourceString.cend() );
+  QStringUnicodeConstIterator last( sourceString.cend(), sourceString.cend() );
+  const bool ok = boost::spirit::x3::parse(first, last, parser, attribute);
+  if( !ok || (first != last) ){
+    const QString what = QLatin1String("Failed to parse ") + sourceString;
+    throw QRuntimeError(what);
+  }
+
+  return attribute;
+}
+
+QString parseFieldColumn(const QString & sourceString, const CsvParserSettings & settings)
+{
+  return parseAll<Grammar::Csv::X3::FieldColumn<QString>, QString>(sourceString, settings);
+}
+
+QStringList parseRecord(const QString & sourceString, const CsvParserSettings & settings)
+{
+  return parseAll<Grammar::Csv::X3::CsvRecord<QStringList>, QStringList>(sourceString, settings);
+}
+
+StringTable parseCsvFile(const QString & sourceString, const CsvParserSettings & settings)
+{
+  return parseAll<Grammar::Csv::X3::CsvFile<StringTable>, StringTable>(sourceString, settings);
+}
+
+TEST_CASE("FieldColumn")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("empty")
+  {
+    REQUIRE( parseFieldColumn(QLatin1String(""), csvSettings).isEmpty() );
+  }
+
+  SECTION("A")
+  {
+    REQUIRE( parseFieldColumn(QLatin1String("A"), csvSettings) == QLatin1String("A") );
+  }
+
+  SECTION("é")
+  {
+    REQUIRE( parseFieldColumn(QString::fromUtf8("é"), csvSettings) == QString::fromUtf8("é") );
+  }
+
+  SECTION("a𐐅ö")
+  {
+    REQUIRE( parseFieldColumn(QString::fromUtf8("a𐐅ö"), csvSettings) == QString::fromUtf8("a𐐅ö") );
+  }
+
+  SECTION("\"a𐐅,ö\"")
+  {
+    REQUIRE( parseFieldColumn(QString::fromUtf8("\"a𐐅,ö\""), csvSettings) == QString::fromUtf8("a𐐅,ö") );
+  }
+}
+
+TEST_CASE("CsvRecord")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("A,B")
+  {
+    REQUIRE( recordMatches( parseRecord(QLatin1String("A,B"), csvSettings), {"A","B"} ) );
+  }
+
+  SECTION("A,é,à,B,è,ü,ö,ä,𐐅,l")
+  {
+    const QStringList result = parseRecord(QString::fromUtf8("A,é,à,B,è,ü,ö,ä,𐐅,l"), csvSettings);
+    REQUIRE( recordMatches(result, {"A","é","à","B","è","ü","ö","ä","𐐅","l"}) );
+  }
+
+  SECTION(",\"𐐅\"\"\",")
+  {
+    REQUIRE( recordMatches( parseRecord(QString::fromUtf8(",\"𐐅\"\"\","), csvSettings), {"","𐐅\"",""} ) );
+  }
+}
+
+TEST_CASE("CsvFile")
+{
+  CsvParserSettings csvSettings;
+
+  SECTION("A")
+  {
+    REQUIRE( tableMatches( parseCsvFile(QLatin1String("A"), csvSettings), {{"A"}} ) );
+  }
+
+  SECTION("é\\n𐐅\\nö")
+  {
+    REQUIRE( tableMatches( parseCsvFile(QString::fromUtf8("é\n𐐅\nö"), csvSettings), {{"é"},{"𐐅"},{"ö"}} ) );
+  }
+}
+
+TEST_CASE("QCsvFileReaderTemplate")
+{
+  using Rule = Grammar::Csv::X3::CsvRecord<QStringList>;
+  using Table = std::vector<QStringList>;
+
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+  REQUIRE( writeTextFileUtf8(file, QString::fromUtf8("A,é\n\"𐐅\nö\",c\r\nd,e")) );
+  file.close();
+
+  CsvParserSettings csvSettings;
+  const Rule rule(csvSettings);
+
+  QCsvFileReaderTemplate reader;
+  reader.setFilePath( file.fileName() );
+  reader.setCsvSettings(csvSettings);
+  reader.open();
+
+  SECTION("readRecord")
+  {
+    REQUIRE( recordMatches( reader.readRecord<QStringList>(rule), {"A","é"} ) );
+    REQUIRE( reader.position().lineNumber() == 2 );
+    REQUIRE( recordMatches( reader.readRecord<QStringList>(rule), {"𐐅\nö","c"} ) );
+    REQUIRE( reader.position().lineNumber() == 4 );
+    REQUIRE( recordMatches( reader.readRecord<QStringList>(rule), {"d","e"} ) );
+    REQUIRE( reader.atEnd() );
+  }
+
+  SECTION("readAllRecords")
+  {
+    REQUIRE( tableMatches( reader.readAllRecords<Table>(rule), {{"A","é"},{"𐐅\nö","c"},{"d","e"}} ) );
+    REQUIRE( reader.atEnd() );
+  }
+}
@@ -411,3 +411,72 @@ TEST_CASE("advance_get")
     REQUIRE( sd.atEnd() );
   }
 }
+
+QString readAllFromSharedData(QTextFileInputConstIteratorSharedData & sd)
+{
+  QString result;
+
+  while( !sd.atEnd() ){
+    result.append( sd.get() );
+    sd.advance();
+  }
+
+  return result;
+}
+
+QString decodeByBlocks(const QByteArray & data, int blockSize)
+{
+  QTextCodec *codec = QTextCodec::codecForName("UTF-8");
+  assert( codec != nullptr );
+  std::unique_ptr<QTextDecoder> decoder( codec->makeDecoder() );
+  assert( decoder.get() != nullptr );
+
+  QString result;
+  for(int i = 0; i < data.size(); i += blockSize){
+    result.append( decoder->toUnicode( data.constData() + i, qMin(blockSize, data.size() - i) ) );
+  }
+
+  return result;
+}
+
+/*
+ * Blocks of ASCII chars are not passed to the decoder.
+ * The result must be the same as passing each block to the decoder,
+ * also when the decoder waits for the rest of a sequence
+ * that was split over more than 2 blocks.
+ * (For invalid input, the count of replacement chars
+ *  produced by QTextDecoder depends on the block size)
+ */
+TEST_CASE("advance_get_asciiBlocks")
+{
+  QTemporaryFile file;
+  REQUIRE( file.open() );
+
+  int rawBufferCapacity = GENERATE(1, 2, 3, 4, 5, 1024);
+
+  QByteArray fileData;
+
+  SECTION("AB𝛀CD")
+  {
+    fileData = QByteArray("AB\xf0\x9d\x9b\x80" "CD");
+  }
+
+  SECTION("BOM then ABC")
+  {
+    fileData = QByteArray("\xef\xbb\xbf" "ABC");
+  }
+
+  SECTION("incomplete sequence then ABCD then é")
+  {
+    fileData = QByteArray("\xf0\x9d\x9b" "ABCD\xc3\xa9");
+  }
+
+  REQUIRE( file.write(fileData) == fileData.size() );
+  file.close();
+
+  const QString expectedData = decodeByBlocks(fileData, rawBufferCapacity);
+
+  REQUIRE( openTextFileReadOnly(file) );
+  QTextFileInputConstIteratorSharedData sd(file, "UTF-8", rawBufferCapacity);
+  REQUIRE( readAllFromSharedData(sd) == expectedData );
+}
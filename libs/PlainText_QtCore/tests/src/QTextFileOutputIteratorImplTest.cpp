@@ -80,3 +80,23 @@ TEST_CASE("put")
     REQUIRE( readTextFileBack(file) == QString::fromUtf8("aèöĵg") );
   }
 }
+
+TEST_CASE("put_append")
+{
+  QTemporaryFile file;
+  REQUIRE( openTextFileForWrite(file) );
+  {
+    QTextFileOutputIteratorImpl it(file, "UTF-8");
+    it.put(u'A');
+  }
+  file.close();
+
+  QFile appendFile( file.fileName() );
+  REQUIRE( appendFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text) );
+  {
+    QTextFileOutputIteratorImpl it(appendFile, "UTF-8");
+    it.put(u'\u00E8');  // è
+  }
+
+  REQUIRE( readTextFileBack(appendFile) == QString::fromUtf8("Aè") );
+}